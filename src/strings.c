@@ -39,8 +39,8 @@
 #include <limits.h>
 
 #include "strings.h"
-#include "siphash.h"
-#include "halfsiphash.h"
+#include "strings_simd.h"
+#include "strings_internal.h"
 
 ///// core /////
 
@@ -53,10 +53,10 @@
 
 /**
  * @def BUF_MEM
- * @brief size of buffered string
+ * @brief size of buffered string (header, data, terminator and STRING_PAD bytes)
  *
  */
-#define BUF_MEM(cap)  (sizeof(string_t) + (cap + 1) * BUF_CHR)
+#define BUF_MEM(cap)  (sizeof(string_t) + (cap + 1 + STRING_PAD) * BUF_CHR)
 
 /**
  * @fn String string_buf_new(const size_t cap)
@@ -78,6 +78,29 @@ String string_new(const size_t cap) {
     return buf;
 }
 
+/**
+ * @fn String string_new_uninit(const size_t cap)
+ * @brief Allocate a new Buffer of capacity `cap` without zeroing it (empty, null-terminated).
+ *
+ * @param cap Capacity
+ * @return  Buffered string
+ */
+String string_new_uninit(const size_t cap) {
+    if (cap > UINT32_MAX - 1)
+        return NULL;
+
+    String buf = malloc(BUF_MEM(cap));
+
+    if (buf) {
+        buf->capacity = cap;
+        buf->length = 0;
+        buf->data[0] = 0;
+        buf->data[cap] = 0;
+    }
+
+    return buf;
+}
+
 /**
  * @fn String string_buf_new_c(const char *str)
  * @brief Allocate a new Buffer of capacity `cap` and copy string
@@ -89,7 +112,10 @@ String string_new_c(const char *str) {
     if (str == NULL || strlen(str) > UINT32_MAX - 1)
         return NULL;
 
-    String buf = string_new(strlen(str));
+    String buf = string_new_uninit(strlen(str));
+    if (buf == NULL)
+        return NULL;
+
     memcpy(buf->data, str, strlen(str));
     buf->length = strlen(str);
 
@@ -107,7 +133,7 @@ String string_dup(const String buf) {
     if (buf == NULL)
         return NULL;
 
-    String ret = string_new(buf->capacity);
+    String ret = string_new_uninit(buf->capacity);
 
     if (ret) {
         // copies only up to current length
@@ -119,7 +145,8 @@ String string_dup(const String buf) {
 
 /**
  * @fn bool string_buf_resize(String *pbuf, const size_t newcap)
- * @brief Resize capacity
+ * @brief Resize capacity. Large Strings need no special path: glibc serves big chunks (32 MiB and up at
+ *        the latest, its dynamic mmap threshold cap) with mmap and realloc grows them with mremap, no copy.
  *
  * @param pbuf Buffered string
  * @param newcap New capacity
@@ -153,6 +180,71 @@ bool string_resize(String *pbuf, const size_t newcap) {
     return true;
 }
 
+/**
+ * @fn bool string_reserve(String *pbuf, uint32_t extra)
+ * @brief Ensure room for extra bytes after length (grows geometrically, never zeroes)
+ *
+ * @param pbuf Buffered string
+ * @param extra Spare bytes needed
+ * @return Boolean
+ */
+bool string_reserve(String *pbuf, uint32_t extra) {
+    if (pbuf == NULL || *pbuf == NULL)
+        return false;
+
+    String buf = *pbuf;
+    if (extra > UINT32_MAX - 1 - buf->length)
+        return false;
+
+    const uint32_t need = buf->length + extra;
+    if (need <= buf->capacity)
+        return true;
+
+    uint64_t newcap = (uint64_t) buf->capacity + buf->capacity / 2;
+    if (newcap < need)
+        newcap = need;
+    if (newcap > UINT32_MAX - 1)
+        newcap = UINT32_MAX - 1;
+
+    return string_resize(pbuf, newcap);
+}
+
+/**
+ * @fn char* string_spare(const String buf, uint32_t *avail)
+ * @brief Writable bytes after length, to be filled then published with string_commit
+ *
+ * @param buf Buffered string
+ * @param avail Spare capacity
+ * @return Pointer to data + length
+ */
+char* string_spare(const String buf, uint32_t *avail) {
+    if (buf == NULL)
+        return NULL;
+
+    if (avail != NULL)
+        *avail = buf->capacity - buf->length;
+
+    return buf->data + buf->length;
+}
+
+/**
+ * @fn bool string_commit(String buf, uint32_t n)
+ * @brief Append n bytes already written at string_spare
+ *
+ * @param buf Buffered string
+ * @param n Bytes written
+ * @return Boolean (false: more than the spare capacity)
+ */
+bool string_commit(String buf, uint32_t n) {
+    if (buf == NULL || n > buf->capacity - buf->length)
+        return false;
+
+    buf->length += n;
+    buf->data[buf->length] = 0;
+
+    return true;
+}
+
 /**
  * @fn void string_move(String *to, String *from)
  * @brief Copy string and free from
@@ -303,7 +395,10 @@ String string_concat(const String str1, const String str2) {
     if (str1 == NULL || str2 == NULL)
         return NULL;
 
-    String new = string_new(str1->length + str2->length);
+    String new = string_new_uninit(str1->length + str2->length);
+    if (new == NULL)
+        return NULL;
+
     memcpy(new->data, str1->data, str1->length);
     memcpy(new->data + str1->length, str2->data, str2->length + 1);
     new->length = str1->length + str2->length;
@@ -539,9 +634,9 @@ uint32_t string_find(const String buf, const String search, uint32_t pos) {
     if (buf == NULL || search == NULL || search->length > buf->length || pos > buf->length)
         return STR_ERROR;
 
-    char *p;
-    if ((p = strstr(buf->data + pos, search->data)) != NULL)
-        return (p - buf->data);
+    size_t p = string_simd->find(buf->data + pos, buf->length - pos, search->data, search->length);
+    if (p != STRING_SIMD_NOT_FOUND)
+        return pos + p;
 
     return STR_ERROR;
 }
@@ -567,264 +662,1138 @@ uint32_t string_find_c(const String buf, const char *csearch, uint32_t pos) {
 }
 
 /**
- * @fn String string_toupper(const String buf)
- * @brief To upper string
+ * @fn uint32_t string_find_nocase(const String buf, const String search, uint32_t pos)
+ * @brief Find substring starting at position ignoring ASCII case. Nothing is copied or lowered.
  *
  * @param buf Buffered string
- * @return Buffered string
+ * @param search Buffered string
+ * @param pos Start position
+ * @return Position
  */
-String string_toupper(const String buf) {
-    if (buf == NULL)
-        return NULL;
-
-    String new = string_new(buf->length);
-    for (int i = 0; i < buf->length; i++) {
-        if (buf->data[i] >= 97 && buf->data[i] <= 122)
-            new->data[i] = buf->data[i] - 32;
-        else
-            new->data[i] = buf->data[i];
-    }
+uint32_t string_find_nocase(const String buf, const String search, uint32_t pos) {
+    if (buf == NULL || search == NULL || pos > buf->length)
+        return STR_ERROR;
 
-    new->length = buf->length;
+    size_t p = string_simd->find_nocase(buf->data + pos, buf->length - pos, search->data, search->length);
+    if (p != STRING_SIMD_NOT_FOUND)
+        return pos + p;
 
-    return new;
+    return STR_ERROR;
 }
 
 /**
- * @fn String string_tolower(const String buf)
- * @brief To lower string
+ * @fn uint32_t string_find_nocase_c(const String buf, const char *csearch, uint32_t pos)
+ * @brief Find c-string starting at position ignoring ASCII case.
  *
  * @param buf Buffered string
- * @return Buffered string
+ * @param csearch Searched string
+ * @param pos Start position
+ * @return Position
  */
-String string_tolower(const String buf) {
-    if (buf == NULL)
-        return NULL;
-
-    String new = string_new(buf->length);
-    for (int i = 0; i < buf->length; i++) {
-        if (buf->data[i] >= 65 && buf->data[i] <= 90)
-            new->data[i] = buf->data[i] + 32;
-        else
-            new->data[i] = buf->data[i];
-    }
+uint32_t string_find_nocase_c(const String buf, const char *csearch, uint32_t pos) {
+    if (buf == NULL || csearch == NULL || pos > buf->length)
+        return STR_ERROR;
 
-    new->length = buf->length;
+    size_t p = string_simd->find_nocase(buf->data + pos, buf->length - pos, csearch, strlen(csearch));
+    if (p != STRING_SIMD_NOT_FOUND)
+        return pos + p;
 
-    return new;
+    return STR_ERROR;
 }
 
 /**
- * @fn String string_ltrim(const String buf)
- * @brief Left trim string
+ * @fn uint32_t string_find_all_nocase(const String buf, const String search, uint32_t **positions)
+ * @brief Find all non-overlapping occurrences ignoring ASCII case.
  *
  * @param buf Buffered string
- * @return Buffered string
+ * @param search Buffered string (not empty)
+ * @param positions Array of positions (allocated, free by caller)
+ * @return Number of occurrences
  */
-String string_ltrim(const String buf) {
-    if (buf == NULL)
-        return NULL;
-
-    uint32_t pos1 = 0;
+uint32_t string_find_all_nocase(const String buf, const String search, uint32_t **positions) {
+    if (buf == NULL || search == NULL || positions == NULL || search->length == 0)
+        return 0;
 
-    while (pos1 < buf->length && isspace(buf->data[pos1]))
-        ++pos1;
+    uint32_t len = 0, cap = 0, pos = 0;
+    *positions = NULL;
 
-    String new = string_new(pos1 + (buf->length - 1) + 1);
-    memcpy(new->data, buf->data + pos1, (buf->length - 1) - pos1 + 1);
+    while ((pos = string_find_nocase(buf, search, pos)) != STR_ERROR) {
+        if (len == cap) {
+            cap = cap ? cap * 2 : 16;
+            uint32_t *tmp = realloc(*positions, cap * sizeof(uint32_t));
+            if (tmp == NULL)
+                return len;
+            *positions = tmp;
+        }
 
-    new->length = (buf->length - 1) - pos1 + 1;
+        (*positions)[len++] = pos;
+        pos += search->length;
+    }
 
-    return new;
+    return len;
 }
 
 /**
- * @fn String string_rtrim(const String buf)
- * @brief Right trim string
+ * @fn String string_replace_nocase(const String buf, const String search, const String replace, uint32_t pos)
+ * @brief Replace first occurrence starting at position ignoring ASCII case
  *
  * @param buf Buffered string
+ * @param search Buffered string
+ * @param replace Buffered string
+ * @param pos Start position
  * @return Buffered string
  */
-String string_rtrim(const String buf) {
-    if (buf == NULL)
+String string_replace_nocase(const String buf, const String search, const String replace, uint32_t pos) {
+    if (buf == NULL || search == NULL || replace == NULL || pos > buf->length)
         return NULL;
 
-    uint32_t pos2 = buf->length - 1;
-
-    while (pos2 >= 0 && isspace(buf->data[pos2]))
-        --pos2;
+    uint32_t fpos = string_find_nocase(buf, search, pos);
+    if (fpos == STR_ERROR)
+        return NULL;
 
-    String new = string_new(pos2 + 1);
-    memcpy(new->data, buf->data, pos2 + 1);
+    String new = string_new(buf->length - search->length + replace->length);
+    memcpy(new->data, buf->data, fpos);
+    memcpy(new->data + fpos, replace->data, replace->length);
+    memcpy(new->data + fpos + replace->length, buf->data + search->length + fpos, buf->length - fpos - search->length);
 
-    new->length = pos2 + 1;
+    new->length = buf->length - search->length + replace->length;
 
     return new;
 }
 
 /**
- * @fn String string_trim(const String buf)
- * @brief Trim string
+ * @fn String string_replace_all_nocase(const String buf, const String search, const String replace)
+ * @brief Replace all non-overlapping occurrences ignoring ASCII case (one allocation of exact length)
  *
  * @param buf Buffered string
+ * @param search Buffered string (not empty)
+ * @param replace Buffered string
  * @return Buffered string
  */
-String string_trim(const String buf) {
-    if (buf == NULL)
+String string_replace_all_nocase(const String buf, const String search, const String replace) {
+    if (buf == NULL || search == NULL || replace == NULL || search->length == 0)
         return NULL;
 
-    uint32_t pos1 = 0, pos2 = buf->length - 1;
+    uint32_t *positions;
+    const uint32_t count = string_find_all_nocase(buf, search, &positions);
+    const uint64_t length = (uint64_t) buf->length - (uint64_t) count * search->length + (uint64_t) count * replace->length;
+    if (length > UINT32_MAX - 1) {
+        free(positions);
+        return NULL;
+    }
 
-    while (pos1 < buf->length && isspace(buf->data[pos1]))
-        ++pos1;
-    while (pos2 >= 0 && isspace(buf->data[pos2]))
-        --pos2;
+    String new = string_new_uninit(length);
+    if (new == NULL) {
+        free(positions);
+        return NULL;
+    }
 
-    String new = string_new(pos1 + pos2 + 1);
-    memcpy(new->data, buf->data + pos1, pos2 - pos1 + 1);
+    uint32_t from = 0;
+    char *out = new->data;
+    for (uint32_t n = 0; n < count; n++) {
+        memcpy(out, buf->data + from, positions[n] - from);
+        out += positions[n] - from;
+        memcpy(out, replace->data, replace->length);
+        out += replace->length;
+        from = positions[n] + search->length;
+    }
+    memcpy(out, buf->data + from, buf->length - from);
 
-    new->length = pos2 - pos1 + 1;
+    new->length = length;
+    free(positions);
 
     return new;
 }
 
 /**
- * @fn int string_append(String buf, const char *fmt, ...)
- * @brief Append a formatted c-string to `buf`.
- *        If new data would exceed capacity, `buf` stays unmodified.
+ * @fn const string_byteset_t* word_class(const string_byteset_t *word, string_byteset_t *dflt)
+ * @brief Word class or the default one (STRING_WORD_CHARS)
  *
- * @param buf  Buffered string
- * @param fmt Format
- * @return Change in length.
  */
-uint32_t string_append(String buf, const char *fmt, ...) {
-    if (buf == NULL || fmt == NULL)
-        return 0;
-
-    const size_t spc = buf->capacity - buf->length;
+static inline const string_byteset_t* word_class(const string_byteset_t *word, string_byteset_t *dflt) {
+    if (word != NULL)
+        return word;
 
-    if (!spc)
-        return 0;
+    string_byteset(dflt, STRING_WORD_CHARS);
 
-    // get potential write length
-    va_list args;
-    va_start(args, fmt);
-    const int len = vsnprintf(NULL, 0, fmt, args); //rem: end null not counted
-    va_end(args);
+    return dflt;
+}
 
-    if (len > spc)
-        return 0;
+/**
+ * @fn uint32_t string_find_word(const String buf, const String search, const string_byteset_t *word, uint32_t pos)
+ * @brief Find search starting at position as a whole word: not preceded or followed by a byte of word.
+ *
+ * @param buf Buffered string
+ * @param search Buffered string (not empty)
+ * @param word Word class (NULL: STRING_WORD_CHARS)
+ * @param pos Start position
+ * @return Position
+ */
+uint32_t string_find_word(const String buf, const String search, const string_byteset_t *word, uint32_t pos) {
+    if (buf == NULL || search == NULL || pos > buf->length)
+        return STR_ERROR;
 
-    char *end = buf->data + buf->length;
+    string_byteset_t dflt;
+    size_t p = string_simd->find_word(buf->data, buf->length, pos, search->data, search->length, word_class(word, &dflt));
+    if (p != STRING_SIMD_NOT_FOUND)
+        return p;
 
-    errno = 0;
-    va_start(args, fmt);
-    int written = vsnprintf(end, spc + 1, fmt, args);
-    va_end(args);
+    return STR_ERROR;
+}
 
-    if (written < 0) {
-        *end = 0; // just in case..
+/**
+ * @fn uint32_t string_count_word(const String buf, const String search, const string_byteset_t *word)
+ * @brief Count whole word occurrences
+ *
+ * @param buf Buffered string
+ * @param search Buffered string (not empty)
+ * @param word Word class (NULL: STRING_WORD_CHARS)
+ * @return Count
+ */
+uint32_t string_count_word(const String buf, const String search, const string_byteset_t *word) {
+    if (buf == NULL || search == NULL || search->length == 0)
         return 0;
-    }
 
-    // truncated - useless?
-    if (written > spc) {
-        *end = 0;
-        return 0;
-    }
+    string_byteset_t dflt;
+    const string_byteset_t *set = word_class(word, &dflt);
+    uint32_t count = 0;
+    size_t pos = 0;
 
-    buf->length += written;
+    while ((pos = string_simd->find_word(buf->data, buf->length, pos, search->data, search->length, set)) != STRING_SIMD_NOT_FOUND) {
+        ++count;
+        pos += search->length;
+    }
 
-    return written;
+    return count;
 }
 
 /**
- * @fn int string_write(String buf, const char *fmt, ...)
- * @brief Write a formatted c-string at beginning of `buf`.
- *        If new data would exceed capacity, `buf` stays unmodified.
+ * @fn String string_replace_word(const String buf, const String search, const String replace, const string_byteset_t *word)
+ * @brief Replace all whole word occurrences (one allocation of exact length)
  *
- * @param buf  Buffered string
- * @param fmt Format
- * @return New length or zero on failure.
+ * @param buf Buffered string
+ * @param search Buffered string (not empty)
+ * @param replace Buffered string
+ * @param word Word class (NULL: STRING_WORD_CHARS)
+ * @return Buffered string
  */
-uint32_t string_write(String buf, const char *fmt, ...) {
-    if (buf == NULL || fmt == NULL)
-        return 0;
-
-    const size_t cap = buf->capacity;
-
-    if (!cap)
-        return 0;
-
-    // get potential write length
-    va_list args;
-    va_start(args, fmt);
-    const int len = vsnprintf(NULL, 0, fmt, args);
-    va_end(args);
+String string_replace_word(const String buf, const String search, const String replace, const string_byteset_t *word) {
+    if (buf == NULL || search == NULL || replace == NULL || search->length == 0)
+        return NULL;
 
-    if (len > cap)
-        return 0;
+    string_byteset_t dflt;
+    const string_byteset_t *set = word_class(word, &dflt);
+    const uint32_t count = string_count_word(buf, search, set);
+    const uint64_t length = (uint64_t) buf->length - (uint64_t) count * search->length + (uint64_t) count * replace->length;
+    if (length > UINT32_MAX - 1)
+        return NULL;
 
-    errno = 0;
-    va_start(args, fmt);
-    const int written = vsnprintf(buf->data, cap + 1, fmt, args);
-    va_end(args);
+    String new = string_new_uninit(length);
+    if (new == NULL)
+        return NULL;
 
-    if (written < 0) {
-        perror("buf_write");
-        return 0;
+    size_t from = 0, pos;
+    char *out = new->data;
+    for (uint32_t n = 0; n < count; n++) {
+        pos = string_simd->find_word(buf->data, buf->length, from, search->data, search->length, set);
+        memcpy(out, buf->data + from, pos - from);
+        out += pos - from;
+        memcpy(out, replace->data, replace->length);
+        out += replace->length;
+        from = pos + search->length;
     }
+    memcpy(out, buf->data + from, buf->length - from);
 
-    buf->length = written;
+    new->length = length;
 
-    return written;
+    return new;
 }
 
 /**
- * @fn string_equals(const String str1, const String str2)
- * @brief Compares two strings.
+ * @fn uint32_t rfind_region(const String buf, uint32_t len, uint32_t pos)
+ * @brief Bytes that can hold a match of length len starting at or before pos
  *
- * @param str1
- * @param str2
- * @return Returns true if the strings are equal, and false if not.
  */
-bool string_equals(const String str1, const String str2) {
-    if (str1 == NULL || str2 == NULL || str1->length != str2->length)
-        return false;
+static inline uint32_t rfind_region(const String buf, uint32_t len, uint32_t pos) {
+    const uint64_t end = (uint64_t) pos + len;
 
-    return !memcmp(str1->data, str2->data, str1->length);
+    return end < buf->length ? (uint32_t) end : buf->length;
 }
 
 /**
- * @fn bool string_equals_c(const String a, const char *b)
- * @brief Compare strings equality
+ * @fn uint32_t string_rfind(const String buf, const String search, uint32_t pos)
+ * @brief Find last substring starting at or before position.
  *
- * @param a Buffered string
- * @param b String
- * @return Boolean
+ * @param buf Buffered string
+ * @param search Buffered string
+ * @param pos Last start position (buf->length: whole string)
+ * @return Position
  */
-bool string_equals_c(const String a, const char *b) {
-    if (a == NULL || b == NULL || a->length != strlen(b))
-        return false;
+uint32_t string_rfind(const String buf, const String search, uint32_t pos) {
+    if (buf == NULL || search == NULL || search->length > buf->length || pos > buf->length)
+        return STR_ERROR;
 
-    return !memcmp(a->data, b, a->length);
-}
+    size_t p = string_simd->rfind(buf->data, rfind_region(buf, search->length, pos), search->data, search->length);
+    if (p != STRING_SIMD_NOT_FOUND)
+        return p;
 
-////////////////////////////////////////////////////////////
+    return STR_ERROR;
+}
 
 /**
- * @fn bool string_issigned(const String buf)
- * @brief Check if string is signed
+ * @fn uint32_t string_rfind_c(const String buf, const char *csearch, uint32_t pos)
+ * @brief Find last c-string starting at or before position.
  *
  * @param buf Buffered string
- * @return boolean
+ * @param csearch Searched string
+ * @param pos Last start position (buf->length: whole string)
+ * @return Position
  */
-bool string_issigned(const String buf) {
-    if (buf == NULL)
-        return false;
+uint32_t string_rfind_c(const String buf, const char *csearch, uint32_t pos) {
+    if (buf == NULL || csearch == NULL || pos > buf->length)
+        return STR_ERROR;
 
-    if (buf->data[0] == '-')
-        return true;
+    size_t len = strlen(csearch);
+    if (len > buf->length)
+        return STR_ERROR;
+
+    size_t p = string_simd->rfind(buf->data, rfind_region(buf, len, pos), csearch, len);
+    if (p != STRING_SIMD_NOT_FOUND)
+        return p;
+
+    return STR_ERROR;
+}
+
+/**
+ * @fn uint32_t string_rfind_any(const String buf, const char *set, uint32_t pos)
+ * @brief Find last character of set at or before position.
+ *
+ * @param buf Buffered string
+ * @param set Characters to search
+ * @param pos Last position (buf->length: whole string)
+ * @return Position
+ */
+uint32_t string_rfind_any(const String buf, const char *set, uint32_t pos) {
+    if (buf == NULL || set == NULL || pos > buf->length)
+        return STR_ERROR;
+
+    size_t p = string_simd->rfind_any(buf->data, rfind_region(buf, 1, pos), set, strlen(set));
+    if (p != STRING_SIMD_NOT_FOUND)
+        return p;
+
+    return STR_ERROR;
+}
+
+/**
+ * @fn bool string_rsplit_view(const String buf, const char *search, string_view_t *left, string_view_t *right)
+ * @brief Split at last occurrence of search. Views point into buf.
+ *
+ * @param buf Buffered string
+ * @param search Separator
+ * @param left String view before separator
+ * @param right String view after separator
+ * @return Boolean (false: separator not found)
+ */
+bool string_rsplit_view(const String buf, const char *search, string_view_t *left, string_view_t *right) {
+    if (left == NULL || right == NULL)
+        return false;
+
+    uint32_t pos = string_rfind_c(buf, search, buf == NULL ? 0 : buf->length);
+    if (pos == STR_ERROR)
+        return false;
+
+    const uint32_t end = pos + strlen(search);
+    left->data = buf->data;
+    left->length = pos;
+    right->data = buf->data + end;
+    right->length = buf->length - end;
+
+    return true;
+}
+
+/**
+ * @fn bool string_rsplit_any_view(const String buf, const char *set, string_view_t *left, string_view_t *right)
+ * @brief Split at last character of set (e.g. "/\\" for basename). Views point into buf.
+ *
+ * @param buf Buffered string
+ * @param set Separator characters
+ * @param left String view before separator
+ * @param right String view after separator
+ * @return Boolean (false: separator not found)
+ */
+bool string_rsplit_any_view(const String buf, const char *set, string_view_t *left, string_view_t *right) {
+    if (left == NULL || right == NULL)
+        return false;
+
+    uint32_t pos = string_rfind_any(buf, set, buf == NULL ? 0 : buf->length);
+    if (pos == STR_ERROR)
+        return false;
+
+    left->data = buf->data;
+    left->length = pos;
+    right->data = buf->data + pos + 1;
+    right->length = buf->length - pos - 1;
+
+    return true;
+}
+
+/**
+ * @fn void string_byteset(string_byteset_t *set, const char *chars)
+ * @brief Compile a byte set
+ *
+ * @param set Byte set
+ * @param chars Member characters
+ */
+void string_byteset(string_byteset_t *set, const char *chars) {
+    if (set == NULL)
+        return;
+
+    memset(set, 0, sizeof(*set));
+    if (chars == NULL)
+        return;
+
+    for (const uint8_t *c = (const uint8_t*) chars; *c != '\0'; c++)
+        (*c & 0x80 ? set->hi : set->lo)[*c & 0x0f] |= 1 << ((*c >> 4) & 7);
+}
+
+/**
+ * @fn uint32_t string_find_set(const String buf, const string_byteset_t *set, uint32_t pos)
+ * @brief Find first byte of set starting at position (strpbrk).
+ *
+ * @param buf Buffered string
+ * @param set Byte set
+ * @param pos Start position
+ * @return Position
+ */
+uint32_t string_find_set(const String buf, const string_byteset_t *set, uint32_t pos) {
+    if (buf == NULL || set == NULL || pos > buf->length)
+        return STR_ERROR;
+
+    uint32_t len = string_simd->span(buf->data + pos, buf->length - pos, set, false);
+    if (pos + len == buf->length)
+        return STR_ERROR;
+
+    return pos + len;
+}
+
+/**
+ * @fn uint32_t string_find_any(const String buf, const char *chars, uint32_t pos)
+ * @brief Find first character of chars starting at position.
+ *
+ * @param buf Buffered string
+ * @param chars Characters to search
+ * @param pos Start position
+ * @return Position
+ */
+uint32_t string_find_any(const String buf, const char *chars, uint32_t pos) {
+    string_byteset_t set;
+
+    string_byteset(&set, chars);
+
+    return string_find_set(buf, &set, pos);
+}
+
+/**
+ * @fn uint32_t string_span(const String buf, const string_byteset_t *set, uint32_t pos)
+ * @brief Length of the run of bytes in set starting at position (strspn).
+ *
+ * @param buf Buffered string
+ * @param set Byte set
+ * @param pos Start position
+ * @return Length
+ */
+uint32_t string_span(const String buf, const string_byteset_t *set, uint32_t pos) {
+    if (buf == NULL || set == NULL || pos > buf->length)
+        return STR_ERROR;
+
+    return string_simd->span(buf->data + pos, buf->length - pos, set, true);
+}
+
+/**
+ * @fn uint32_t string_cspan(const String buf, const string_byteset_t *set, uint32_t pos)
+ * @brief Length of the run of bytes not in set starting at position (strcspn).
+ *
+ * @param buf Buffered string
+ * @param set Byte set
+ * @param pos Start position
+ * @return Length
+ */
+uint32_t string_cspan(const String buf, const string_byteset_t *set, uint32_t pos) {
+    if (buf == NULL || set == NULL || pos > buf->length)
+        return STR_ERROR;
+
+    return string_simd->span(buf->data + pos, buf->length - pos, set, false);
+}
+
+/**
+ * @fn uint32_t string_count_byte(const String buf, char c)
+ * @brief Count occurrences of a character.
+ *
+ * @param buf Buffered string
+ * @param c Character
+ * @return Count
+ */
+uint32_t string_count_byte(const String buf, char c) {
+    if (buf == NULL)
+        return STR_ERROR;
+
+    return string_simd->count_byte_padded(buf->data, buf->length, c);
+}
+
+/**
+ * @fn string_line_index_t* string_line_index_new(const String buf)
+ * @brief Index the start offset of every line ('\n' separated). The index is not updated if buf changes.
+ *
+ * @param buf Buffered string
+ * @return Line index
+ */
+string_line_index_t* string_line_index_new(const String buf) {
+    if (buf == NULL)
+        return NULL;
+
+    const uint32_t newlines = string_simd->count_byte_padded(buf->data, buf->length, '\n');
+    string_line_index_t *idx = malloc(sizeof(string_line_index_t) + ((size_t) newlines + 1) * sizeof(uint32_t));
+    if (idx == NULL)
+        return NULL;
+
+    idx->lines = newlines + 1;
+    idx->length = buf->length;
+    idx->starts[0] = 0;
+    string_simd->index_byte(buf->data, buf->length, '\n', idx->starts + 1, 1);
+
+    return idx;
+}
+
+/**
+ * @fn void string_line_index_free(string_line_index_t *idx)
+ * @brief Free line index
+ *
+ * @param idx Line index
+ */
+void string_line_index_free(string_line_index_t *idx) {
+    free(idx);
+}
+
+/**
+ * @fn uint32_t string_line_offset(const string_line_index_t *idx, uint32_t line)
+ * @brief Start offset of line
+ *
+ * @param idx Line index
+ * @param line Line number (from 0)
+ * @return Position
+ */
+uint32_t string_line_offset(const string_line_index_t *idx, uint32_t line) {
+    if (idx == NULL || line >= idx->lines)
+        return STR_ERROR;
+
+    return idx->starts[line];
+}
+
+/**
+ * @fn uint32_t string_line_at(const string_line_index_t *idx, uint32_t pos)
+ * @brief Line containing position (a newline belongs to the line it ends)
+ *
+ * @param idx Line index
+ * @param pos Position
+ * @return Line number (from 0)
+ */
+uint32_t string_line_at(const string_line_index_t *idx, uint32_t pos) {
+    if (idx == NULL || pos > idx->length)
+        return STR_ERROR;
+
+    uint32_t lo = 0, hi = idx->lines;
+    while (hi - lo > 1) {
+        const uint32_t mid = lo + (hi - lo) / 2;
+        if (idx->starts[mid] <= pos)
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+/**
+ * @fn bool string_line_view(const String buf, const string_line_index_t *idx, uint32_t line, string_view_t *view)
+ * @brief View of line without its newline
+ *
+ * @param buf Buffered string (the indexed one)
+ * @param idx Line index
+ * @param line Line number (from 0)
+ * @param view String view
+ * @return Boolean
+ */
+bool string_line_view(const String buf, const string_line_index_t *idx, uint32_t line, string_view_t *view) {
+    if (buf == NULL || idx == NULL || view == NULL || line >= idx->lines || buf->length != idx->length)
+        return false;
+
+    const uint32_t end = (line + 1 < idx->lines) ? idx->starts[line + 1] - 1 : idx->length;
+    view->data = buf->data + idx->starts[line];
+    view->length = end - idx->starts[line];
+
+    return true;
+}
+
+/**
+ * @fn String string_toupper(const String buf)
+ * @brief To upper string
+ *
+ * @param buf Buffered string
+ * @return Buffered string
+ */
+String string_toupper(const String buf) {
+    if (buf == NULL)
+        return NULL;
+
+    String new = string_new_uninit(buf->length);
+    if (new == NULL)
+        return NULL;
+
+    string_simd->to_upper_padded(new->data, buf->data, buf->length);
+    new->length = buf->length;
+
+    return new;
+}
+
+/**
+ * @fn String string_tolower(const String buf)
+ * @brief To lower string
+ *
+ * @param buf Buffered string
+ * @return Buffered string
+ */
+String string_tolower(const String buf) {
+    if (buf == NULL)
+        return NULL;
+
+    String new = string_new_uninit(buf->length);
+    if (new == NULL)
+        return NULL;
+
+    string_simd->to_lower_padded(new->data, buf->data, buf->length);
+    new->length = buf->length;
+
+    return new;
+}
+
+/**
+ * @fn String string_ltrim(const String buf)
+ * @brief Left trim string
+ *
+ * @param buf Buffered string
+ * @return Buffered string
+ */
+String string_ltrim(const String buf) {
+    if (buf == NULL)
+        return NULL;
+
+    uint32_t pos1 = string_simd->skip_space_padded(buf->data, buf->length);
+
+    String new = string_new(buf->length - pos1);
+    memcpy(new->data, buf->data + pos1, buf->length - pos1);
+
+    new->length = buf->length - pos1;
+
+    return new;
+}
+
+/**
+ * @fn String string_rtrim(const String buf)
+ * @brief Right trim string
+ *
+ * @param buf Buffered string
+ * @return Buffered string
+ */
+String string_rtrim(const String buf) {
+    if (buf == NULL)
+        return NULL;
+
+    uint32_t pos2 = string_simd->rskip_space(buf->data, buf->length);
+
+    String new = string_new(pos2);
+    memcpy(new->data, buf->data, pos2);
+
+    new->length = pos2;
+
+    return new;
+}
+
+/**
+ * @fn String string_trim(const String buf)
+ * @brief Trim string
+ *
+ * @param buf Buffered string
+ * @return Buffered string
+ */
+String string_trim(const String buf) {
+    if (buf == NULL)
+        return NULL;
+
+    uint32_t pos1 = string_simd->skip_space_padded(buf->data, buf->length);
+    uint32_t pos2 = pos1 + string_simd->rskip_space(buf->data + pos1, buf->length - pos1);
+
+    String new = string_new(pos2 - pos1);
+    memcpy(new->data, buf->data + pos1, pos2 - pos1);
+
+    new->length = pos2 - pos1;
+
+    return new;
+}
+
+/**
+ * @fn String into_target(String *dst, uint64_t len, bool fresh, String *old)
+ * @brief Destination for an _into result: *dst when it holds len bytes, else a new buffer (old one returned in old)
+ */
+static String into_target(String *dst, uint64_t len, bool fresh, String *old) {
+    *old = NULL;
+    if (len > UINT32_MAX - 1)
+        return NULL;
+
+    if (*dst != NULL && !fresh && (*dst)->capacity >= len)
+        return *dst;
+
+    uint64_t cap = len;
+    if (*dst != NULL && (uint64_t) (*dst)->capacity + (*dst)->capacity / 2 > cap)
+        cap = (uint64_t) (*dst)->capacity + (*dst)->capacity / 2;
+    if (cap > UINT32_MAX - 1)
+        cap = UINT32_MAX - 1;
+
+    String new = string_new_uninit(cap);
+    if (new != NULL)
+        *old = *dst;
+
+    return new;
+}
+
+/**
+ * @fn bool into_done(String *dst, String target, String old, uint32_t len)
+ * @brief Terminate the result and release the replaced destination
+ */
+static bool into_done(String *dst, String target, String old, uint32_t len) {
+    target->length = len;
+    target->data[len] = '\0';
+    free(old);
+    *dst = target;
+
+    return true;
+}
+
+/**
+ * @fn bool string_left_into(String *dst, const String buf, uint32_t pos)
+ * @brief Substring left from position into dst (reuses dst capacity)
+ *
+ * @param dst Destination (may be NULL or buf)
+ * @param buf Buffered string
+ * @param pos Position
+ * @return Boolean
+ */
+bool string_left_into(String *dst, const String buf, uint32_t pos) {
+    if (dst == NULL || buf == NULL || pos >= buf->length)
+        return false;
+
+    String old, t = into_target(dst, pos + 1, false, &old);
+    if (t == NULL)
+        return false;
+
+    memmove(t->data, buf->data, pos + 1);
+
+    return into_done(dst, t, old, pos + 1);
+}
+
+/**
+ * @fn bool string_right_into(String *dst, const String buf, uint32_t pos)
+ * @brief Substring right from position into dst (reuses dst capacity)
+ *
+ * @param dst Destination (may be NULL or buf)
+ * @param buf Buffered string
+ * @param pos Position
+ * @return Boolean
+ */
+bool string_right_into(String *dst, const String buf, uint32_t pos) {
+    if (dst == NULL || buf == NULL || pos > buf->length)
+        return false;
+
+    const uint32_t len = buf->length - pos;
+    String old, t = into_target(dst, len, false, &old);
+    if (t == NULL)
+        return false;
+
+    memmove(t->data, buf->data + pos, len);
+
+    return into_done(dst, t, old, len);
+}
+
+/**
+ * @fn bool string_mid_into(String *dst, const String buf, uint32_t left, uint32_t right)
+ * @brief Substring from position left to position right into dst (reuses dst capacity)
+ *
+ * @param dst Destination (may be NULL or buf)
+ * @param buf Buffered string
+ * @param left Position (start in 1)
+ * @param right Position
+ * @return Boolean
+ */
+bool string_mid_into(String *dst, const String buf, uint32_t left, uint32_t right) {
+    if (dst == NULL || buf == NULL || left < 1 || right > buf->length || left > right)
+        return false;
+
+    const uint32_t len = right - left + 1;
+    String old, t = into_target(dst, len, false, &old);
+    if (t == NULL)
+        return false;
+
+    memmove(t->data, buf->data + left - 1, len);
+
+    return into_done(dst, t, old, len);
+}
+
+/**
+ * @fn bool string_concat_into(String *dst, const String str1, const String str2)
+ * @brief Concatenation of strings into dst (reuses dst capacity)
+ *
+ * @param dst Destination (may be NULL, str1 or str2)
+ * @param str1 Buffered string
+ * @param str2 Buffered string
+ * @return Boolean
+ */
+bool string_concat_into(String *dst, const String str1, const String str2) {
+    if (dst == NULL || str1 == NULL || str2 == NULL)
+        return false;
+
+    const uint32_t len1 = str1->length, len2 = str2->length;
+    String old, t = into_target(dst, (uint64_t) len1 + len2, false, &old);
+    if (t == NULL)
+        return false;
+
+    // second part first: dst may be str2
+    memmove(t->data + len1, str2->data, len2);
+    memmove(t->data, str1->data, len1);
+
+    return into_done(dst, t, old, len1 + len2);
+}
+
+/**
+ * @fn bool string_insert_into(String *dst, const String buf, const String str, uint32_t pos)
+ * @brief Insert string on position into dst (reuses dst capacity)
+ *
+ * @param dst Destination (may be NULL or buf)
+ * @param buf Buffered string
+ * @param str Buffered string
+ * @param pos Position
+ * @return Boolean
+ */
+bool string_insert_into(String *dst, const String buf, const String str, uint32_t pos) {
+    if (dst == NULL || buf == NULL || str == NULL || pos > buf->length)
+        return false;
+
+    const uint32_t blen = buf->length, slen = str->length;
+    String old, t = into_target(dst, (uint64_t) blen + slen, *dst == str, &old);
+    if (t == NULL)
+        return false;
+
+    memmove(t->data + pos + slen, buf->data + pos, blen - pos);
+    memmove(t->data, buf->data, pos);
+    memmove(t->data + pos, str->data, slen);
+
+    return into_done(dst, t, old, blen + slen);
+}
+
+/**
+ * @fn bool string_delete_into(String *dst, const String buf, uint32_t pos1, uint32_t pos2)
+ * @brief Delete substring from pos1 to pos2 into dst (reuses dst capacity)
+ *
+ * @param dst Destination (may be NULL or buf)
+ * @param buf Buffered string
+ * @param pos1 Position
+ * @param pos2 Position
+ * @return Boolean
+ */
+bool string_delete_into(String *dst, const String buf, uint32_t pos1, uint32_t pos2) {
+    if (dst == NULL || buf == NULL || pos1 > pos2 || pos2 >= buf->length)
+        return false;
+
+    const uint32_t tail = buf->length - pos2 - 1;
+    String old, t = into_target(dst, pos1 + tail, false, &old);
+    if (t == NULL)
+        return false;
+
+    memmove(t->data, buf->data, pos1);
+    memmove(t->data + pos1, buf->data + pos2 + 1, tail);
+
+    return into_done(dst, t, old, pos1 + tail);
+}
+
+/**
+ * @fn bool string_replace_into(String *dst, const String buf, const String search, const String replace, uint32_t pos)
+ * @brief Replace string into dst (reuses dst capacity)
+ *
+ * @param dst Destination (may be NULL or buf)
+ * @param buf Buffered string
+ * @param search Buffered string
+ * @param replace Buffered string
+ * @param pos Start position
+ * @return Boolean (false: not found)
+ */
+bool string_replace_into(String *dst, const String buf, const String search, const String replace, uint32_t pos) {
+    if (dst == NULL || buf == NULL || search == NULL || replace == NULL || pos > buf->length)
+        return false;
+
+    uint32_t fpos = string_find(buf, search, pos);
+    if (fpos == STR_ERROR)
+        return false;
+
+    const uint32_t blen = buf->length, slen = search->length, rlen = replace->length;
+    const uint32_t tail = blen - fpos - slen;
+    String old, t = into_target(dst, (uint64_t) blen - slen + rlen, *dst == replace, &old);
+    if (t == NULL)
+        return false;
+
+    memmove(t->data + fpos + rlen, buf->data + fpos + slen, tail);
+    memmove(t->data, buf->data, fpos);
+    memmove(t->data + fpos, replace->data, rlen);
+
+    return into_done(dst, t, old, blen - slen + rlen);
+}
+
+/**
+ * @fn bool string_toupper_into(String *dst, const String buf)
+ * @brief To upper string into dst (reuses dst capacity)
+ *
+ * @param dst Destination (may be NULL or buf)
+ * @param buf Buffered string
+ * @return Boolean
+ */
+bool string_toupper_into(String *dst, const String buf) {
+    if (dst == NULL || buf == NULL)
+        return false;
+
+    String old, t = into_target(dst, buf->length, false, &old);
+    if (t == NULL)
+        return false;
+
+    string_simd->to_upper_padded(t->data, buf->data, buf->length);
+
+    return into_done(dst, t, old, buf->length);
+}
+
+/**
+ * @fn bool string_tolower_into(String *dst, const String buf)
+ * @brief To lower string into dst (reuses dst capacity)
+ *
+ * @param dst Destination (may be NULL or buf)
+ * @param buf Buffered string
+ * @return Boolean
+ */
+bool string_tolower_into(String *dst, const String buf) {
+    if (dst == NULL || buf == NULL)
+        return false;
+
+    String old, t = into_target(dst, buf->length, false, &old);
+    if (t == NULL)
+        return false;
+
+    string_simd->to_lower_padded(t->data, buf->data, buf->length);
+
+    return into_done(dst, t, old, buf->length);
+}
+
+/**
+ * @fn bool string_ltrim_into(String *dst, const String buf)
+ * @brief Left trim string into dst (reuses dst capacity)
+ *
+ * @param dst Destination (may be NULL or buf)
+ * @param buf Buffered string
+ * @return Boolean
+ */
+bool string_ltrim_into(String *dst, const String buf) {
+    if (dst == NULL || buf == NULL)
+        return false;
+
+    return string_right_into(dst, buf, string_simd->skip_space_padded(buf->data, buf->length));
+}
+
+/**
+ * @fn bool string_rtrim_into(String *dst, const String buf)
+ * @brief Right trim string into dst (reuses dst capacity)
+ *
+ * @param dst Destination (may be NULL or buf)
+ * @param buf Buffered string
+ * @return Boolean
+ */
+bool string_rtrim_into(String *dst, const String buf) {
+    if (dst == NULL || buf == NULL)
+        return false;
+
+    const uint32_t len = string_simd->rskip_space(buf->data, buf->length);
+    String old, t = into_target(dst, len, false, &old);
+    if (t == NULL)
+        return false;
+
+    memmove(t->data, buf->data, len);
+
+    return into_done(dst, t, old, len);
+}
+
+/**
+ * @fn bool string_trim_into(String *dst, const String buf)
+ * @brief Trim string into dst (reuses dst capacity)
+ *
+ * @param dst Destination (may be NULL or buf)
+ * @param buf Buffered string
+ * @return Boolean
+ */
+bool string_trim_into(String *dst, const String buf) {
+    if (dst == NULL || buf == NULL)
+        return false;
+
+    const uint32_t pos1 = string_simd->skip_space_padded(buf->data, buf->length);
+    const uint32_t len = string_simd->rskip_space(buf->data + pos1, buf->length - pos1);
+    String old, t = into_target(dst, len, false, &old);
+    if (t == NULL)
+        return false;
+
+    memmove(t->data, buf->data + pos1, len);
+
+    return into_done(dst, t, old, len);
+}
+
+/**
+ * @fn int string_append(String buf, const char *fmt, ...)
+ * @brief Append a formatted c-string to `buf`.
+ *        If new data would exceed capacity, `buf` stays unmodified.
+ *
+ * @param buf  Buffered string
+ * @param fmt Format
+ * @return Change in length.
+ */
+uint32_t string_append(String buf, const char *fmt, ...) {
+    if (buf == NULL || fmt == NULL)
+        return 0;
+
+    const size_t spc = buf->capacity - buf->length;
+
+    if (!spc)
+        return 0;
+
+    // get potential write length
+    va_list args;
+    va_start(args, fmt);
+    const int len = vsnprintf(NULL, 0, fmt, args); //rem: end null not counted
+    va_end(args);
+
+    if (len > spc)
+        return 0;
+
+    char *end = buf->data + buf->length;
+
+    errno = 0;
+    va_start(args, fmt);
+    int written = vsnprintf(end, spc + 1, fmt, args);
+    va_end(args);
+
+    if (written < 0) {
+        *end = 0; // just in case..
+        return 0;
+    }
+
+    // truncated - useless?
+    if (written > spc) {
+        *end = 0;
+        return 0;
+    }
+
+    buf->length += written;
+
+    return written;
+}
+
+/**
+ * @fn int string_write(String buf, const char *fmt, ...)
+ * @brief Write a formatted c-string at beginning of `buf`.
+ *        If new data would exceed capacity, `buf` stays unmodified.
+ *
+ * @param buf  Buffered string
+ * @param fmt Format
+ * @return New length or zero on failure.
+ */
+uint32_t string_write(String buf, const char *fmt, ...) {
+    if (buf == NULL || fmt == NULL)
+        return 0;
+
+    const size_t cap = buf->capacity;
+
+    if (!cap)
+        return 0;
+
+    // get potential write length
+    va_list args;
+    va_start(args, fmt);
+    const int len = vsnprintf(NULL, 0, fmt, args);
+    va_end(args);
+
+    if (len > cap)
+        return 0;
+
+    errno = 0;
+    va_start(args, fmt);
+    const int written = vsnprintf(buf->data, cap + 1, fmt, args);
+    va_end(args);
+
+    if (written < 0) {
+        perror("buf_write");
+        return 0;
+    }
+
+    buf->length = written;
+
+    return written;
+}
+
+/**
+ * @fn string_equals(const String str1, const String str2)
+ * @brief Compares two strings.
+ *
+ * @param str1
+ * @param str2
+ * @return Returns true if the strings are equal, and false if not.
+ */
+bool string_equals(const String str1, const String str2) {
+    if (str1 == NULL || str2 == NULL || str1->length != str2->length)
+        return false;
+
+    return !memcmp(str1->data, str2->data, str1->length);
+}
+
+/**
+ * @fn bool string_equals_c(const String a, const char *b)
+ * @brief Compare strings equality
+ *
+ * @param a Buffered string
+ * @param b String
+ * @return Boolean
+ */
+bool string_equals_c(const String a, const char *b) {
+    if (a == NULL || b == NULL || a->length != strlen(b))
+        return false;
+
+    return !memcmp(a->data, b, a->length);
+}
+
+////////////////////////////////////////////////////////////
+
+/**
+ * @fn bool string_issigned(const String buf)
+ * @brief Check if string is signed
+ *
+ * @param buf Buffered string
+ * @return boolean
+ */
+bool string_issigned(const String buf) {
+    if (buf == NULL)
+        return false;
+
+    if (buf->data[0] == '-')
+        return true;
     else
         return false;
 }
@@ -845,12 +1814,7 @@ bool string_isinteger(const String buf) {
     if (buf->data[0] == '-')
         ++n;
 
-    for (; n < buf->length; n++) {
-        if (!isdigit(buf->data[n]))
-            return false;
-    }
-
-    return true;
+    return string_simd->skip_digits(buf->data + n, buf->length - n) == buf->length - n;
 }
 
 /**
@@ -889,17 +1853,10 @@ bool string_isfloat(const String buf) {
  * @return Boolean
  */
 bool string_isblank(const String buf) {
-    char *ch;
-    bool is_blank = true;
-
-    for (ch = buf->data; *ch != '\0'; ++ch) {
-        if (!isspace(*ch)) {
-            is_blank = false;
-            break;
-        }
-    }
+    if (buf == NULL)
+        return false;
 
-    return is_blank;
+    return string_simd->skip_space_padded(buf->data, buf->length) == buf->length;
 }
 
 /**
@@ -1069,21 +2026,522 @@ uint32_t string_split_array(String buf, const char *search, String **array) {
  * @return String hash result
  */
 string_hash_t string_hash(const String buf, uint8_t version, uint8_t key[16]) {
-    string_hash_t result;
-
     if (buf == NULL) {
+        string_hash_t result;
         result.outlen = 0;
         return result;
     }
 
-    const size_t lengths[4] = { 8, 16, 4, 8 };
-    int len = lengths[version];
-    result.outlen = len;
+    return string_hash_view(string_view(buf), version, key);
+}
 
-    if (version < 2)
-        siphash(buf->data, buf->length, key, result.out, len);
-    else
-        halfsiphash(buf->data, buf->length, key, result.out, len);
+/**
+ * @var hash_outlen
+ * @brief Result length of each enum STRING_HASH_VERSION
+ *
+ */
+static const uint8_t hash_outlen[CRC32C + 1] = { 8, 16, 4, 8, 4 };
+
+/**
+ * @fn uint64_t hash_rotl64(uint64_t x, int b)
+ * @brief Rotate left
+ *
+ */
+static inline uint64_t hash_rotl64(uint64_t x, int b) {
+    return (x << b) | (x >> (64 - b));
+}
+
+/**
+ * @fn uint32_t hash_rotl32(uint32_t x, int b)
+ * @brief Rotate left
+ *
+ */
+static inline uint32_t hash_rotl32(uint32_t x, int b) {
+    return (x << b) | (x >> (32 - b));
+}
+
+/**
+ * @fn uint64_t hash_load_le(const uint8_t *p, size_t n)
+ * @brief Little endian load of n (<= 8) bytes
+ *
+ */
+static inline uint64_t hash_load_le(const uint8_t *p, size_t n) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < n; i++)
+        v |= (uint64_t) p[i] << (8 * i);
+
+    return v;
+}
+
+/**
+ * @fn void hash_round64(uint64_t v[4])
+ * @brief SipRound
+ *
+ */
+static inline void hash_round64(uint64_t v[4]) {
+    v[0] += v[1];
+    v[1] = hash_rotl64(v[1], 13);
+    v[1] ^= v[0];
+    v[0] = hash_rotl64(v[0], 32);
+    v[2] += v[3];
+    v[3] = hash_rotl64(v[3], 16);
+    v[3] ^= v[2];
+    v[0] += v[3];
+    v[3] = hash_rotl64(v[3], 21);
+    v[3] ^= v[0];
+    v[2] += v[1];
+    v[1] = hash_rotl64(v[1], 17);
+    v[1] ^= v[2];
+    v[2] = hash_rotl64(v[2], 32);
+}
+
+/**
+ * @fn void hash_round32(uint32_t v[4])
+ * @brief HalfSipRound
+ *
+ */
+static inline void hash_round32(uint32_t v[4]) {
+    v[0] += v[1];
+    v[1] = hash_rotl32(v[1], 5);
+    v[1] ^= v[0];
+    v[0] = hash_rotl32(v[0], 16);
+    v[2] += v[3];
+    v[3] = hash_rotl32(v[3], 8);
+    v[3] ^= v[2];
+    v[0] += v[3];
+    v[3] = hash_rotl32(v[3], 7);
+    v[3] ^= v[0];
+    v[2] += v[1];
+    v[1] = hash_rotl32(v[1], 13);
+    v[1] ^= v[2];
+    v[2] = hash_rotl32(v[2], 16);
+}
+
+/**
+ * @fn void hash_block64(uint64_t v[4], uint64_t m)
+ * @brief SipHash-2-4 compression of one message word
+ *
+ */
+static inline void hash_block64(uint64_t v[4], uint64_t m) {
+    v[3] ^= m;
+    hash_round64(v);
+    hash_round64(v);
+    v[0] ^= m;
+}
+
+/**
+ * @fn void hash_block32(uint32_t v[4], uint32_t m)
+ * @brief HalfSipHash-2-4 compression of one message word
+ *
+ */
+static inline void hash_block32(uint32_t v[4], uint32_t m) {
+    v[3] ^= m;
+    hash_round32(v);
+    hash_round32(v);
+    v[0] ^= m;
+}
+
+/**
+ * @fn void hash_squeeze64(uint64_t v[4], uint8_t out[8])
+ * @brief SipHash finalization rounds and one 64 bit output word
+ *
+ */
+static inline void hash_squeeze64(uint64_t v[4], uint8_t out[8]) {
+    for (int r = 0; r < 4; r++)
+        hash_round64(v);
+
+    const uint64_t b = v[0] ^ v[1] ^ v[2] ^ v[3];
+    for (int n = 0; n < 8; n++)
+        out[n] = (uint8_t) (b >> (8 * n));
+}
+
+/**
+ * @fn void hash_squeeze32(uint32_t v[4], uint8_t out[4])
+ * @brief HalfSipHash finalization rounds and one 32 bit output word
+ *
+ */
+static inline void hash_squeeze32(uint32_t v[4], uint8_t out[4]) {
+    for (int r = 0; r < 4; r++)
+        hash_round32(v);
+
+    const uint32_t b = v[1] ^ v[3];
+    for (int n = 0; n < 4; n++)
+        out[n] = (uint8_t) (b >> (8 * n));
+}
+
+/**
+ * @fn size_t hash_state_blocks(string_hash_state_t *state, const uint8_t *p, size_t n)
+ * @brief Compress the whole blocks of p (CRC32C takes everything)
+ *
+ * @return Bytes consumed
+ */
+static inline size_t hash_state_blocks(string_hash_state_t *state, const uint8_t *p, size_t n) {
+    const uint8_t *start = p;
+
+    if (state->version == CRC32C) {
+        state->crc = string_simd->crc32c(state->crc, (const char*) p, n);
+        return n;
+    }
+
+    // whole blocks run on a local copy of the state so it stays in registers
+    if (state->version < HSIP32) {
+        uint64_t v[4] = { state->v[0], state->v[1], state->v[2], state->v[3] };
+        for (; n >= 8; p += 8, n -= 8)
+            hash_block64(v, get_u64(p));
+        for (int i = 0; i < 4; i++)
+            state->v[i] = v[i];
+    } else {
+        uint32_t v[4] = { state->v[0], state->v[1], state->v[2], state->v[3] };
+        for (; n >= 4; p += 4, n -= 4)
+            hash_block32(v, get_u32(p));
+        for (int i = 0; i < 4; i++)
+            state->v[i] = v[i];
+    }
+
+    return p - start;
+}
+
+/**
+ * @fn string_hash_t hash_state_finish(const string_hash_state_t *state, const uint8_t *tail, size_t tlen)
+ * @brief Compress the last partial block and the length, then squeeze the output
+ *
+ */
+static inline string_hash_t hash_state_finish(const string_hash_state_t *state, const uint8_t *tail, size_t tlen) {
+    string_hash_t result;
+
+    result.outlen = hash_outlen[state->version];
+
+    if (state->version == CRC32C) {
+        for (int n = 0; n < 4; n++)
+            result.out[n] = (uint8_t) (state->crc >> (8 * n));
+    } else if (state->version < HSIP32) {
+        uint64_t v[4] = { state->v[0], state->v[1], state->v[2], state->v[3] };
+        hash_block64(v, hash_load_le(tail, tlen) | state->total << 56);
+        v[2] ^= state->version == SIP128 ? 0xee : 0xff;
+        hash_squeeze64(v, result.out);
+        if (result.outlen == 16) {
+            v[1] ^= 0xdd;
+            hash_squeeze64(v, result.out + 8);
+        }
+    } else {
+        uint32_t v[4] = { state->v[0], state->v[1], state->v[2], state->v[3] };
+        hash_block32(v, hash_load_le(tail, tlen) | (uint32_t) (state->total << 24));
+        v[2] ^= state->version == HSIP64 ? 0xee : 0xff;
+        hash_squeeze32(v, result.out);
+        if (result.outlen == 8) {
+            v[1] ^= 0xdd;
+            hash_squeeze32(v, result.out + 4);
+        }
+    }
 
     return result;
 }
+
+/**
+ * @fn bool string_hash_init(string_hash_state_t *state, uint8_t version, const uint8_t key[16])
+ * @brief Start an incremental hash
+ *
+ * @param state Hash state
+ * @param version enum STRING_HASH_VERSION
+ * @param key Key (unused and may be NULL for CRC32C)
+ * @return true on success
+ */
+bool string_hash_init(string_hash_state_t *state, uint8_t version, const uint8_t key[16]) {
+    if (state == NULL)
+        return false;
+
+    state->total = 0;
+    state->crc = 0;
+    state->tlen = 0;
+    if (version > CRC32C || (version != CRC32C && key == NULL)) {
+        state->version = UINT8_MAX;
+        return false;
+    }
+
+    state->version = version;
+    if (version == CRC32C) {
+        for (int i = 0; i < 4; i++)
+            state->v[i] = 0;
+    } else if (version < HSIP32) {
+        const uint64_t k0 = get_u64(key), k1 = get_u64(key + 8);
+        state->v[0] = UINT64_C(0x736f6d6570736575) ^ k0;
+        state->v[1] = UINT64_C(0x646f72616e646f6d) ^ k1;
+        state->v[2] = UINT64_C(0x6c7967656e657261) ^ k0;
+        state->v[3] = UINT64_C(0x7465646279746573) ^ k1;
+        if (version == SIP128)
+            state->v[1] ^= 0xee;
+    } else {
+        const uint32_t k0 = get_u32(key), k1 = get_u32(key + 4);
+        state->v[0] = k0;
+        state->v[1] = k1;
+        state->v[2] = UINT32_C(0x6c796765) ^ k0;
+        state->v[3] = UINT32_C(0x74656462) ^ k1;
+        if (version == HSIP64)
+            state->v[1] ^= 0xee;
+    }
+
+    return true;
+}
+
+/**
+ * @fn void string_hash_update(string_hash_state_t *state, const void *data, size_t n)
+ * @brief Feed bytes to an incremental hash
+ *
+ * @param state Hash state (started with string_hash_init)
+ * @param data Bytes
+ * @param n Number of bytes
+ */
+void string_hash_update(string_hash_state_t *state, const void *data, size_t n) {
+    if (state == NULL || state->version > CRC32C || n == 0)
+        return;
+
+    const uint8_t *p = data;
+    state->total += n;
+
+    if (state->tlen > 0) {
+        const size_t block = state->version < HSIP32 ? 8 : 4;
+        const size_t take = block - state->tlen < n ? block - state->tlen : n;
+        memcpy(state->tail + state->tlen, p, take);
+        state->tlen += take;
+        p += take;
+        n -= take;
+        if (state->tlen < block)
+            return;
+        state->tlen = 0;
+        hash_state_blocks(state, state->tail, block);
+    }
+
+    const size_t used = hash_state_blocks(state, p, n);
+    memcpy(state->tail, p + used, n - used);
+    state->tlen = n - used;
+}
+
+/**
+ * @fn string_hash_t string_hash_final(string_hash_state_t *state)
+ * @brief Finish an incremental hash
+ *
+ * @param state Hash state
+ * @return String hash result (outlen 0 if the state was not started)
+ */
+string_hash_t string_hash_final(string_hash_state_t *state) {
+    if (state == NULL || state->version > CRC32C) {
+        string_hash_t result;
+        result.outlen = 0;
+        return result;
+    }
+
+    return hash_state_finish(state, state->tail, state->tlen);
+}
+
+////////////////////////////////////////////////////////////
+
+/**
+ * @fn string_view_t string_view(const String buf)
+ * @brief View over whole string
+ *
+ * @param buf Buffered string
+ * @return String view (data NULL if buf is NULL)
+ */
+string_view_t string_view(const String buf) {
+    string_view_t view = { NULL, 0 };
+
+    if (buf != NULL) {
+        view.data = buf->data;
+        view.length = buf->length;
+    }
+
+    return view;
+}
+
+/**
+ * @fn string_view_t string_view_c(const char *str)
+ * @brief View over c-string
+ *
+ * @param str String
+ * @return String view (data NULL if str is NULL or too long)
+ */
+string_view_t string_view_c(const char *str) {
+    string_view_t view = { NULL, 0 };
+
+    if (str != NULL && strlen(str) <= UINT32_MAX - 1) {
+        view.data = str;
+        view.length = strlen(str);
+    }
+
+    return view;
+}
+
+/**
+ * @fn String string_new_view(string_view_t view)
+ * @brief Allocate a new Buffer and copy view
+ *
+ * @param view String view
+ * @return Buffered string|NULL
+ */
+String string_new_view(string_view_t view) {
+    if (view.data == NULL || view.length > UINT32_MAX - 1)
+        return NULL;
+
+    String buf = string_new_uninit(view.length);
+    if (buf == NULL)
+        return NULL;
+
+    memcpy(buf->data, view.data, view.length);
+    buf->length = view.length;
+
+    return buf;
+}
+
+/**
+ * @fn string_hash_t string_hash_view(string_view_t view, uint8_t version, uint8_t key[16])
+ * @brief String view hash
+ *
+ * @param view String view
+ * @param version enum STRING_HASH_VERSION
+ * @param key Key
+ * @return String hash result
+ */
+string_hash_t string_hash_view(string_view_t view, uint8_t version, uint8_t key[16]) {
+    string_hash_t result;
+
+    if (view.data == NULL) {
+        result.outlen = 0;
+        return result;
+    }
+
+    // one shot: the last partial block is read in place instead of through the state tail
+    string_hash_state_t state;
+    if (!string_hash_init(&state, version, key)) {
+        result.outlen = 0;
+        return result;
+    }
+
+    const uint8_t *p = (const uint8_t*) view.data;
+    const size_t used = hash_state_blocks(&state, p, view.length);
+    state.total = view.length;
+
+    return hash_state_finish(&state, p + used, view.length - used);
+}
+
+/**
+ * @fn uint64_t string_hash64_view(string_view_t view, const uint8_t key[16])
+ * @brief 64 bit SipHash of a view as one word (SIP64 output bytes in native order)
+ *
+ * @param view String view (data NULL: empty)
+ * @param key Key
+ * @return Hash
+ */
+uint64_t string_hash64_view(string_view_t view, const uint8_t key[16]) {
+    if (view.data == NULL)
+        view.data = "";
+
+    // string_hash_view only reads the key
+    string_hash_t hash = string_hash_view(view, SIP64, (uint8_t*) key);
+    uint64_t h;
+    memcpy(&h, hash.out, 8);
+
+    return h;
+}
+
+/**
+ * @fn void string_hash128_view(string_view_t view, const uint8_t key[16], uint64_t *h1, uint64_t *h2)
+ * @brief 128 bit SipHash of a view split in two independent 64 bit hashes
+ *
+ * @param view String view (data NULL: empty)
+ * @param key Key
+ * @param h1 First hash
+ * @param h2 Second hash
+ */
+void string_hash128_view(string_view_t view, const uint8_t key[16], uint64_t *h1, uint64_t *h2) {
+    if (view.data == NULL)
+        view.data = "";
+
+    string_hash_t hash = string_hash_view(view, SIP128, (uint8_t*) key);
+    memcpy(h1, hash.out, 8);
+    memcpy(h2, hash.out + 8, 8);
+}
+
+/**
+ * @fn void string_split_iter(string_split_iter_t *it, const String buf, const char *search)
+ * @brief Start iterating the tokens of buf separated by search. Tokens are views into buf.
+ *
+ * @param it Split iterator
+ * @param buf Buffered string
+ * @param search Separator (not empty)
+ */
+void string_split_iter(string_split_iter_t *it, const String buf, const char *search) {
+    if (it == NULL)
+        return;
+
+    it->rest = string_view(buf);
+    it->search = search;
+    it->slen = (search == NULL) ? 0 : strlen(search);
+    it->set = NULL;
+    it->done = (buf == NULL || it->slen == 0);
+}
+
+/**
+ * @fn void string_split_set_iter(string_split_iter_t *it, const String buf, const string_byteset_t *set)
+ * @brief Start iterating the tokens of buf separated by any byte of set. Tokens are views into buf.
+ *
+ * @param it Split iterator
+ * @param buf Buffered string
+ * @param set Separator bytes (must outlive the iterator)
+ */
+void string_split_set_iter(string_split_iter_t *it, const String buf, const string_byteset_t *set) {
+    if (it == NULL)
+        return;
+
+    it->rest = string_view(buf);
+    it->search = NULL;
+    it->slen = 1;
+    it->set = set;
+    it->done = (buf == NULL || set == NULL);
+}
+
+/**
+ * @fn bool string_split_next(string_split_iter_t *it, string_view_t *token)
+ * @brief Next token (may be empty between consecutive separators)
+ *
+ * @param it Split iterator
+ * @param token String view
+ * @return Boolean (false: no more tokens)
+ */
+bool string_split_next(string_split_iter_t *it, string_view_t *token) {
+    if (it == NULL || token == NULL || it->done)
+        return false;
+
+    const char *p = it->rest.data;
+    const char *end = it->rest.data + it->rest.length;
+
+    if (it->set != NULL) {
+        const size_t len = string_simd->span(p, it->rest.length, it->set, false);
+        p = (len == it->rest.length) ? NULL : p + len;
+    } else {
+        while ((p = memchr(p, it->search[0], end - p)) != NULL) {
+            if ((size_t) (end - p) < it->slen) {
+                p = NULL;
+                break;
+            }
+
+            if (!memcmp(p, it->search, it->slen))
+                break;
+
+            ++p;
+        }
+    }
+
+    token->data = it->rest.data;
+
+    if (p == NULL) {
+        token->length = it->rest.length;
+        it->done = true;
+        return true;
+    }
+
+    token->length = p - it->rest.data;
+    it->rest.length -= token->length + it->slen;
+    it->rest.data = p + it->slen;
+
+    return true;
+}
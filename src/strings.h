@@ -37,24 +37,43 @@
 
 ///// core /////
 
+/**
+ * @def STRING_ALIGN
+ * @brief Alignment of String data (malloc alignment, 16 on glibc x86 and x86_64)
+ *
+ */
+#define STRING_ALIGN 16
+
+/**
+ * @def STRING_PAD
+ * @brief Bytes after data[capacity] every String allocation keeps readable and writable (one AVX2 vector),
+ *        so kernels over String data can finish with a full vector instead of a scalar tail
+ *
+ */
+#define STRING_PAD 32
+
 /**
  * @struct string_s
  * @brief Buffered string structure
  *
  */
 typedef struct string_s {
-    uint32_t capacity;    /**< capacity >**/
-    uint32_t length;      /**< current length >**/
-        char data[];      /**< null-terminated string >**/
-} string_t;               /**< Buffered string internal type >**/
+                 uint32_t capacity; /**< capacity >**/
+                 uint32_t length;   /**< current length >**/
+    _Alignas(STRING_ALIGN) char data[]; /**< null-terminated string (STRING_ALIGN aligned, STRING_PAD bytes follow data[capacity]) >**/
+} string_t;                         /**< Buffered string internal type >**/
 typedef string_t *String; /**< Buffered string main type >**/
 
      String string_new(const size_t cap);
+     String string_new_uninit(const size_t cap);
      String string_new_c(const char *str);
      String string_dup(const String buf);
    uint32_t string_move(String *to, String *from);
    uint32_t string_copy(String *to, const char *from);
        bool string_resize(String *pbuf, const size_t newcap);
+       bool string_reserve(String *pbuf, uint32_t extra);
+      char* string_spare(const String buf, uint32_t *avail);
+       bool string_commit(String buf, uint32_t n);
        void string_reset(String buf);
 const char* string_data(const String buf);
 
@@ -79,9 +98,17 @@ enum STRING_HASH_VERSION {
     SIP64,  /**< SIP64 >**/
     SIP128, /**< SIP128 >**/
     HSIP32, /**< HSIP32 >**/
-    HSIP64  /**< HSIP64 >**/
+    HSIP64, /**< HSIP64 >**/
+    CRC32C  /**< CRC32C (unkeyed, hardware accelerated when available) >**/
 };
 
+/**
+ * @def STRING_WORD_CHARS
+ * @brief Default word class of whole word search
+ *
+ */
+#define STRING_WORD_CHARS "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_"
+
 /**
  * @struct string_hash_s
  * @brief String hash result
@@ -93,6 +120,69 @@ struct string_hash_s {
 };
 typedef struct string_hash_s string_hash_t; /**< hash result type >**/
 
+/**
+ * @struct string_hash_state_s
+ * @brief Incremental string hash (string_hash_init / string_hash_update / string_hash_final)
+ *
+ */
+struct string_hash_state_s {
+    uint64_t v[4];     /**< sip state (HalfSipHash uses the low 32 bits) >**/
+    uint64_t total;    /**< bytes hashed >**/
+    uint32_t crc;      /**< crc32c state >**/
+     uint8_t tail[8];  /**< bytes of the incomplete block >**/
+     uint8_t tlen;     /**< tail length >**/
+     uint8_t version;  /**< enum STRING_HASH_VERSION >**/
+};
+typedef struct string_hash_state_s string_hash_state_t; /**< incremental hash state type >**/
+
+/**
+ * @struct string_view_s
+ * @brief Non-owning view over string bytes
+ *
+ */
+struct string_view_s {
+    const char *data;   /**< first byte (not null-terminated) >**/
+      uint32_t length;  /**< length >**/
+};
+typedef struct string_view_s string_view_t; /**< string view type >**/
+
+/**
+ * @struct string_byteset_s
+ * @brief Compiled set of bytes. Row lo/hi[c & 0x0f] holds bit (c >> 4) & 7 for bytes below/above 0x80.
+ *
+ */
+struct string_byteset_s {
+    uint8_t lo[16]; /**< rows of bytes 0x00..0x7f >**/
+    uint8_t hi[16]; /**< rows of bytes 0x80..0xff >**/
+};
+typedef struct string_byteset_s string_byteset_t; /**< byte set type >**/
+
+/**
+ * @struct string_line_index_s
+ * @brief Start offset of every line
+ *
+ */
+struct string_line_index_s {
+    uint32_t lines;    /**< number of lines (newlines + 1) >**/
+    uint32_t length;   /**< indexed string length >**/
+    uint32_t starts[]; /**< start offset of each line >**/
+};
+typedef struct string_line_index_s string_line_index_t; /**< line index type >**/
+
+/**
+ * @struct string_split_iter_s
+ * @brief Non-allocating split iterator
+ *
+ */
+struct string_split_iter_s {
+         string_view_t rest;    /**< not yet consumed bytes >**/
+            const char *search; /**< separator >**/
+              uint32_t slen;    /**< separator length >**/
+const string_byteset_t *set;    /**< separator bytes (instead of search) >**/
+                  bool done;    /**< no more tokens >**/
+};
+typedef struct string_split_iter_s string_split_iter_t; /**< split iterator type >**/
+
        String string_left(const String buf, uint32_t pos);
        String string_right(const String buf, uint32_t pos);
        String string_mid(const String buf, uint32_t left, uint32_t right);
@@ -111,11 +201,49 @@ typedef struct string_hash_s string_hash_t; /**< hash result type >**/
        String string_ltrim(const String buf);
        String string_rtrim(const String buf);
        String string_trim(const String buf);
+         bool string_left_into(String *dst, const String buf, uint32_t pos);
+         bool string_right_into(String *dst, const String buf, uint32_t pos);
+         bool string_mid_into(String *dst, const String buf, uint32_t left, uint32_t right);
+         bool string_concat_into(String *dst, const String str1, const String str2);
+         bool string_insert_into(String *dst, const String buf, const String str, uint32_t pos);
+         bool string_delete_into(String *dst, const String buf, uint32_t pos1, uint32_t pos2);
+         bool string_replace_into(String *dst, const String buf, const String search, const String replace, uint32_t pos);
+         bool string_toupper_into(String *dst, const String buf);
+         bool string_tolower_into(String *dst, const String buf);
+         bool string_ltrim_into(String *dst, const String buf);
+         bool string_rtrim_into(String *dst, const String buf);
+         bool string_trim_into(String *dst, const String buf);
        String string_split(const String buf, const char *search, String *right);
      uint32_t string_split_array(String buf, const char *search, String **array);
 
      uint32_t string_find(const String buf, const String search, uint32_t pos);
      uint32_t string_find_c(const String buf, const char *csearch, uint32_t pos);
+     uint32_t string_find_nocase(const String buf, const String search, uint32_t pos);
+     uint32_t string_find_nocase_c(const String buf, const char *csearch, uint32_t pos);
+     uint32_t string_find_all_nocase(const String buf, const String search, uint32_t **positions);
+       String string_replace_nocase(const String buf, const String search, const String replace, uint32_t pos);
+       String string_replace_all_nocase(const String buf, const String search, const String replace);
+     uint32_t string_find_word(const String buf, const String search, const string_byteset_t *word, uint32_t pos);
+     uint32_t string_count_word(const String buf, const String search, const string_byteset_t *word);
+       String string_replace_word(const String buf, const String search, const String replace, const string_byteset_t *word);
+     uint32_t string_rfind(const String buf, const String search, uint32_t pos);
+     uint32_t string_rfind_c(const String buf, const char *csearch, uint32_t pos);
+     uint32_t string_rfind_any(const String buf, const char *set, uint32_t pos);
+         bool string_rsplit_view(const String buf, const char *search, string_view_t *left, string_view_t *right);
+         bool string_rsplit_any_view(const String buf, const char *set, string_view_t *left, string_view_t *right);
+         void string_byteset(string_byteset_t *set, const char *chars);
+     uint32_t string_find_any(const String buf, const char *chars, uint32_t pos);
+     uint32_t string_find_set(const String buf, const string_byteset_t *set, uint32_t pos);
+     uint32_t string_span(const String buf, const string_byteset_t *set, uint32_t pos);
+     uint32_t string_cspan(const String buf, const string_byteset_t *set, uint32_t pos);
+     uint32_t string_count_byte(const String buf, char c);
+
+string_line_index_t* string_line_index_new(const String buf);
+                void string_line_index_free(string_line_index_t *idx);
+            uint32_t string_line_offset(const string_line_index_t *idx, uint32_t line);
+            uint32_t string_line_at(const string_line_index_t *idx, uint32_t pos);
+                bool string_line_view(const String buf, const string_line_index_t *idx, uint32_t line, string_view_t *view);
+
      uint32_t string_append(String buf, const char *fmt, ...);
      uint32_t string_write(String buf, const char *fmt, ...);
          bool string_equals(const String str1, const String str2);
@@ -129,6 +257,31 @@ typedef struct string_hash_s string_hash_t; /**< hash result type >**/
          long string_tolong(const String buf, uint8_t base);
        double string_todouble(const String buf);
 string_hash_t string_hash(const String buf, uint8_t version, uint8_t key[16]);
+         bool string_hash_init(string_hash_state_t *state, uint8_t version, const uint8_t key[16]);
+         void string_hash_update(string_hash_state_t *state, const void *data, size_t n);
+string_hash_t string_hash_final(string_hash_state_t *state);
+
+string_view_t string_view(const String buf);
+string_view_t string_view_c(const char *str);
+       String string_new_view(string_view_t view);
+string_hash_t string_hash_view(string_view_t view, uint8_t version, uint8_t key[16]);
+     uint64_t string_hash64_view(string_view_t view, const uint8_t key[16]);
+         void string_hash128_view(string_view_t view, const uint8_t key[16], uint64_t *h1, uint64_t *h2);
+         void string_split_iter(string_split_iter_t *it, const String buf, const char *search);
+         void string_split_set_iter(string_split_iter_t *it, const String buf, const string_byteset_t *set);
+         bool string_split_next(string_split_iter_t *it, string_view_t *token);
+
+/**
+ * @fn bool string_byteset_has(const string_byteset_t *set, uint8_t c)
+ * @brief Byte set membership
+ *
+ * @param set Byte set
+ * @param c Byte
+ * @return Boolean
+ */
+static inline bool string_byteset_has(const string_byteset_t *set, uint8_t c) {
+    return ((c & 0x80 ? set->hi : set->lo)[c & 0x0f] >> ((c >> 4) & 7)) & 1;
+}
 
 ////////////////
 
@@ -0,0 +1,373 @@
+/**
+ * @file strings_compact.c
+ * @brief compact strings with variable width headers
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "strings.h"
+#include "strings_compact.h"
+
+/**
+ * @struct compact8_s
+ * @brief COMPACT_8 header
+ *
+ */
+struct __attribute__((packed)) compact8_s {
+    uint8_t length;   /**< length >**/
+    uint8_t capacity; /**< capacity >**/
+    uint8_t flags;    /**< type >**/
+};
+
+/**
+ * @struct compact16_s
+ * @brief COMPACT_16 header
+ *
+ */
+struct __attribute__((packed)) compact16_s {
+    uint16_t length;   /**< length >**/
+    uint16_t capacity; /**< capacity >**/
+     uint8_t flags;    /**< type >**/
+};
+
+/**
+ * @struct compact32_s
+ * @brief COMPACT_32 header
+ *
+ */
+struct __attribute__((packed)) compact32_s {
+    uint32_t length;   /**< length >**/
+    uint32_t capacity; /**< capacity >**/
+     uint8_t flags;    /**< type >**/
+};
+
+/**
+ * @def COMPACT_TYPE_MASK
+ * @brief Type bits of the flags byte
+ *
+ */
+#define COMPACT_TYPE_MASK 7
+
+/**
+ * @fn uint8_t compact_class(uint32_t cap)
+ * @brief Smallest header class holding capacity cap
+ *
+ */
+static inline uint8_t compact_class(uint32_t cap) {
+    if (cap < 32)
+        return COMPACT_5;
+    if (cap <= UINT8_MAX)
+        return COMPACT_8;
+    if (cap <= UINT16_MAX)
+        return COMPACT_16;
+
+    return COMPACT_32;
+}
+
+/**
+ * @fn size_t compact_header(uint8_t type)
+ * @brief Header size of a class
+ *
+ */
+static inline size_t compact_header(uint8_t type) {
+    switch (type) {
+        case COMPACT_5:
+            return 1;
+        case COMPACT_8:
+            return sizeof(struct compact8_s);
+        case COMPACT_16:
+            return sizeof(struct compact16_s);
+        default:
+            return sizeof(struct compact32_s);
+    }
+}
+
+/**
+ * @fn void compact_set(string_compact_t s, uint8_t type, uint32_t length, uint32_t cap)
+ * @brief Write header fields
+ *
+ */
+static void compact_set(string_compact_t s, uint8_t type, uint32_t length, uint32_t cap) {
+    void *hdr = s - compact_header(type);
+
+    switch (type) {
+        case COMPACT_5:
+            s[-1] = (char) (COMPACT_5 | length << 3);
+            break;
+        case COMPACT_8:
+            ((struct compact8_s*) hdr)->length = length;
+            ((struct compact8_s*) hdr)->capacity = cap;
+            ((struct compact8_s*) hdr)->flags = COMPACT_8;
+            break;
+        case COMPACT_16:
+            ((struct compact16_s*) hdr)->length = length;
+            ((struct compact16_s*) hdr)->capacity = cap;
+            ((struct compact16_s*) hdr)->flags = COMPACT_16;
+            break;
+        default:
+            ((struct compact32_s*) hdr)->length = length;
+            ((struct compact32_s*) hdr)->capacity = cap;
+            ((struct compact32_s*) hdr)->flags = COMPACT_32;
+    }
+}
+
+/**
+ * @fn string_compact_t compact_alloc(uint32_t cap)
+ * @brief Allocate an empty compact string of the class of cap
+ *
+ */
+static string_compact_t compact_alloc(uint32_t cap) {
+    const uint8_t type = compact_class(cap);
+    const size_t header = compact_header(type);
+    char *mem = malloc(header + cap + 1);
+
+    if (mem == NULL)
+        return NULL;
+
+    string_compact_t s = mem + header;
+    compact_set(s, type, 0, cap);
+    s[0] = '\0';
+
+    return s;
+}
+
+/**
+ * @fn string_compact_t string_compact_new(string_view_t view)
+ * @brief New compact string holding view (exact fit, smallest header)
+ *
+ * @param view Bytes
+ * @return Compact string
+ */
+string_compact_t string_compact_new(string_view_t view) {
+    if (view.data == NULL || view.length > UINT32_MAX - 1)
+        return NULL;
+
+    string_compact_t s = compact_alloc(view.length);
+    if (s == NULL)
+        return NULL;
+
+    memcpy(s, view.data, view.length);
+    s[view.length] = '\0';
+    compact_set(s, string_compact_type(s), view.length, view.length);
+
+    return s;
+}
+
+/**
+ * @fn string_compact_t string_compact_from(const String buf)
+ * @brief New compact string from a String
+ *
+ * @param buf Buffered string
+ * @return Compact string
+ */
+string_compact_t string_compact_from(const String buf) {
+    return string_compact_new(string_view(buf));
+}
+
+/**
+ * @fn String string_compact_to_string(const string_compact_t s)
+ * @brief New String from a compact string
+ *
+ * @param s Compact string
+ * @return Buffered string
+ */
+String string_compact_to_string(const string_compact_t s) {
+    if (s == NULL)
+        return NULL;
+
+    return string_new_view(string_compact_view(s));
+}
+
+/**
+ * @fn void string_compact_free(string_compact_t s)
+ * @brief Free compact string
+ *
+ * @param s Compact string
+ */
+void string_compact_free(string_compact_t s) {
+    if (s == NULL)
+        return;
+
+    free(s - compact_header(string_compact_type(s)));
+}
+
+/**
+ * @fn uint8_t string_compact_type(const string_compact_t s)
+ * @brief Header class
+ *
+ * @param s Compact string
+ * @return enum STRING_COMPACT_TYPE (COMPACT_5 if s is NULL)
+ */
+uint8_t string_compact_type(const string_compact_t s) {
+    if (s == NULL)
+        return COMPACT_5;
+
+    return (uint8_t) s[-1] & COMPACT_TYPE_MASK;
+}
+
+/**
+ * @fn uint32_t string_compact_length(const string_compact_t s)
+ * @brief Length
+ *
+ * @param s Compact string
+ * @return Length (0 if s is NULL)
+ */
+uint32_t string_compact_length(const string_compact_t s) {
+    if (s == NULL)
+        return 0;
+
+    const uint8_t type = string_compact_type(s);
+    const void *hdr = s - compact_header(type);
+
+    switch (type) {
+        case COMPACT_5:
+            return (uint8_t) s[-1] >> 3;
+        case COMPACT_8:
+            return ((const struct compact8_s*) hdr)->length;
+        case COMPACT_16:
+            return ((const struct compact16_s*) hdr)->length;
+        default:
+            return ((const struct compact32_s*) hdr)->length;
+    }
+}
+
+/**
+ * @fn uint32_t string_compact_capacity(const string_compact_t s)
+ * @brief Capacity
+ *
+ * @param s Compact string
+ * @return Capacity (0 if s is NULL)
+ */
+uint32_t string_compact_capacity(const string_compact_t s) {
+    if (s == NULL)
+        return 0;
+
+    const uint8_t type = string_compact_type(s);
+    const void *hdr = s - compact_header(type);
+
+    switch (type) {
+        case COMPACT_5:
+            return (uint8_t) s[-1] >> 3;
+        case COMPACT_8:
+            return ((const struct compact8_s*) hdr)->capacity;
+        case COMPACT_16:
+            return ((const struct compact16_s*) hdr)->capacity;
+        default:
+            return ((const struct compact32_s*) hdr)->capacity;
+    }
+}
+
+/**
+ * @fn size_t string_compact_size(const string_compact_t s)
+ * @brief Bytes requested from the allocator (header, capacity and terminator)
+ *
+ * @param s Compact string
+ * @return Size
+ */
+size_t string_compact_size(const string_compact_t s) {
+    if (s == NULL)
+        return 0;
+
+    return compact_header(string_compact_type(s)) + string_compact_capacity(s) + 1;
+}
+
+/**
+ * @fn string_view_t string_compact_view(const string_compact_t s)
+ * @brief View over compact string
+ *
+ * @param s Compact string
+ * @return String view (data NULL if s is NULL)
+ */
+string_view_t string_compact_view(const string_compact_t s) {
+    string_view_t view = { NULL, 0 };
+
+    if (s != NULL) {
+        view.data = s;
+        view.length = string_compact_length(s);
+    }
+
+    return view;
+}
+
+/**
+ * @fn bool string_compact_append(string_compact_t *ps, string_view_t view)
+ * @brief Append bytes, growing (and moving to a wider header) when needed
+ *
+ * @param ps Compact string
+ * @param view Bytes (must not point into *ps when it has to grow)
+ * @return Boolean
+ */
+bool string_compact_append(string_compact_t *ps, string_view_t view) {
+    if (ps == NULL || *ps == NULL || view.data == NULL)
+        return false;
+
+    string_compact_t s = *ps;
+    const uint32_t length = string_compact_length(s);
+    const uint8_t type = string_compact_type(s);
+
+    if (view.length > UINT32_MAX - 1 - length)
+        return false;
+
+    const uint32_t need = length + view.length;
+    if (need > string_compact_capacity(s) || (type == COMPACT_5 && view.length > 0)) {
+        // geometric growth, COMPACT_5 has no spare capacity so it always moves up
+        uint64_t cap = need < (1u << 20) ? (uint64_t) need * 2 : (uint64_t) need + (1u << 20);
+        if (cap > UINT32_MAX - 1)
+            cap = UINT32_MAX - 1;
+        if (compact_class(cap) == COMPACT_5)
+            cap = 32;
+
+        const uint8_t ntype = compact_class(cap);
+        const size_t header = compact_header(ntype);
+        char *mem;
+
+        if (ntype == type) {
+            mem = realloc(s - header, header + cap + 1);
+            if (mem == NULL)
+                return false;
+        } else {
+            mem = malloc(header + cap + 1);
+            if (mem == NULL)
+                return false;
+            memcpy(mem + header, s, length);
+            string_compact_free(s);
+        }
+
+        s = mem + header;
+        compact_set(s, ntype, length, cap);
+    }
+
+    memcpy(s + length, view.data, view.length);
+    s[need] = '\0';
+    compact_set(s, string_compact_type(s), need, string_compact_capacity(s));
+    *ps = s;
+
+    return true;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file strings_compact.h
+ * @brief compact strings with variable width headers
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef STRINGS_COMPACT_H_
+#define STRINGS_COMPACT_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "strings.h"
+
+/**
+ * @enum STRING_COMPACT_TYPE
+ * @brief Header classes, selected by capacity (stored in the low 3 bits of the byte before the data)
+ *
+ */
+enum STRING_COMPACT_TYPE {
+    COMPACT_5,  /**< 1 byte header: length (up to 31) in the flags byte, capacity = length >**/
+    COMPACT_8,  /**< 3 byte header: uint8_t length and capacity >**/
+    COMPACT_16, /**< 5 byte header: uint16_t length and capacity >**/
+    COMPACT_32  /**< 9 byte header: uint32_t length and capacity >**/
+};
+
+/**
+ * @typedef string_compact_t
+ * @brief Compact string: pointer to null-terminated data preceded by its header (sds layout).
+ *        Usable as const char*, released with string_compact_free.
+ *
+ */
+typedef char *string_compact_t;
+
+string_compact_t string_compact_new(string_view_t view);
+string_compact_t string_compact_from(const String buf);
+          String string_compact_to_string(const string_compact_t s);
+            void string_compact_free(string_compact_t s);
+         uint8_t string_compact_type(const string_compact_t s);
+        uint32_t string_compact_length(const string_compact_t s);
+        uint32_t string_compact_capacity(const string_compact_t s);
+          size_t string_compact_size(const string_compact_t s);
+   string_view_t string_compact_view(const string_compact_t s);
+            bool string_compact_append(string_compact_t *ps, string_view_t view);
+
+#endif /* STRINGS_COMPACT_H_ */
@@ -0,0 +1,438 @@
+/**
+ * @file strings_diff.c
+ * @brief line and byte diff (Myers) and patch
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "strings.h"
+#include "strings_simd.h"
+#include "strings_diff.h"
+
+/**
+ * @struct diff_side_s
+ * @brief One sequence of tokens
+ *
+ */
+struct diff_side_s {
+    const char *data; /**< first byte of the compared region >**/
+      uint32_t n;     /**< number of tokens >**/
+      uint32_t *id;   /**< token ids (equal tokens have equal ids) >**/
+      uint32_t *off;  /**< n + 1 token offsets >**/
+       uint8_t *mark; /**< token deleted (a) or inserted (b) >**/
+};
+
+/**
+ * @fn uint32_t common_prefix(const uint32_t *a, const uint32_t *b, uint32_t n)
+ * @brief Equal leading ids
+ *
+ */
+static inline uint32_t common_prefix(const uint32_t *a, const uint32_t *b, uint32_t n) {
+    return string_simd->mismatch((const char*) a, (const char*) b, (size_t) n * sizeof(uint32_t)) / sizeof(uint32_t);
+}
+
+/**
+ * @fn uint32_t common_suffix(const uint32_t *a, const uint32_t *b, uint32_t n)
+ * @brief Equal trailing ids of a[0..n) and b[0..n)
+ *
+ */
+static inline uint32_t common_suffix(const uint32_t *a, const uint32_t *b, uint32_t n) {
+    return string_simd->rmismatch((const char*) a, (const char*) b, (size_t) n * sizeof(uint32_t)) / sizeof(uint32_t);
+}
+
+/**
+ * @fn bool middle_snake(const uint32_t *a, uint32_t n, const uint32_t *b, uint32_t m, uint32_t *sx, uint32_t *sy)
+ * @brief Find a split point on an optimal path (Myers, linear space). False if a and b share nothing.
+ *
+ */
+static bool middle_snake(const uint32_t *a, uint32_t n, const uint32_t *b, uint32_t m, uint32_t *sx, uint32_t *sy) {
+    const int64_t max_d = ((int64_t) n + m + 1) / 2;
+    const int64_t offset = max_d, length = 2 * max_d + 2;
+    const int64_t delta = (int64_t) n - m;
+    const bool front = delta & 1;
+    int64_t k1start = 0, k1end = 0, k2start = 0, k2end = 0;
+    bool found = false;
+
+    // furthest x reached on each diagonal, forward (v1) and backward (v2)
+    int64_t *v1 = malloc(2 * length * sizeof(int64_t));
+    if (v1 == NULL)
+        return false;
+    int64_t *v2 = v1 + length;
+    for (int64_t k = 0; k < 2 * length; k++)
+        v1[k] = -1;
+    v1[offset + 1] = 0;
+    v2[offset + 1] = 0;
+
+    for (int64_t d = 0; d < max_d && !found; d++) {
+        for (int64_t k1 = -d + k1start; k1 <= d - k1end && !found; k1 += 2) {
+            const int64_t k1o = offset + k1;
+            int64_t x1 = (k1 == -d || (k1 != d && v1[k1o - 1] < v1[k1o + 1])) ? v1[k1o + 1] : v1[k1o - 1] + 1;
+            int64_t y1 = x1 - k1;
+            while (x1 < n && y1 < m && a[x1] == b[y1]) {
+                ++x1;
+                ++y1;
+            }
+            v1[k1o] = x1;
+
+            if (x1 > n) {
+                k1end += 2;
+            } else if (y1 > m) {
+                k1start += 2;
+            } else if (front) {
+                const int64_t k2o = offset + delta - k1;
+                if (k2o >= 0 && k2o < length && v2[k2o] != -1 && x1 >= n - v2[k2o]) {
+                    *sx = x1;
+                    *sy = y1;
+                    found = true;
+                }
+            }
+        }
+
+        for (int64_t k2 = -d + k2start; k2 <= d - k2end && !found; k2 += 2) {
+            const int64_t k2o = offset + k2;
+            int64_t x2 = (k2 == -d || (k2 != d && v2[k2o - 1] < v2[k2o + 1])) ? v2[k2o + 1] : v2[k2o - 1] + 1;
+            int64_t y2 = x2 - k2;
+            while (x2 < n && y2 < m && a[n - x2 - 1] == b[m - y2 - 1]) {
+                ++x2;
+                ++y2;
+            }
+            v2[k2o] = x2;
+
+            if (x2 > n) {
+                k2end += 2;
+            } else if (y2 > m) {
+                k2start += 2;
+            } else if (!front) {
+                const int64_t k1o = offset + delta - k2;
+                if (k1o >= 0 && k1o < length && v1[k1o] != -1 && v1[k1o] >= n - x2) {
+                    *sx = v1[k1o];
+                    *sy = v1[k1o] - (k1o - offset);
+                    found = true;
+                }
+            }
+        }
+    }
+
+    free(v1);
+
+    return found;
+}
+
+/**
+ * @fn void diff_range(struct diff_side_s *a, uint32_t alo, uint32_t ahi, struct diff_side_s *b, uint32_t blo, uint32_t bhi)
+ * @brief Mark deleted and inserted tokens of a[alo..ahi) against b[blo..bhi)
+ *
+ */
+static void diff_range(struct diff_side_s *a, uint32_t alo, uint32_t ahi, struct diff_side_s *b, uint32_t blo, uint32_t bhi) {
+    uint32_t sx, sy;
+
+    while (true) {
+        const uint32_t min = (ahi - alo < bhi - blo) ? ahi - alo : bhi - blo;
+        const uint32_t pre = common_prefix(a->id + alo, b->id + blo, min);
+        alo += pre;
+        blo += pre;
+        const uint32_t suf = common_suffix(a->id + ahi - (min - pre), b->id + bhi - (min - pre), min - pre);
+        ahi -= suf;
+        bhi -= suf;
+
+        if (alo == ahi || blo == bhi || !middle_snake(a->id + alo, ahi - alo, b->id + blo, bhi - blo, &sx, &sy)) {
+            memset(a->mark + alo, 1, ahi - alo);
+            memset(b->mark + blo, 1, bhi - blo);
+            return;
+        }
+
+        // recurse on the first half, iterate on the second
+        diff_range(a, alo, alo + sx, b, blo, blo + sy);
+        alo += sx;
+        blo += sy;
+    }
+}
+
+/**
+ * @struct line_table_s
+ * @brief Line interning table (open addressing)
+ *
+ */
+struct line_table_s {
+    uint32_t *slots;  /**< token reference + 1 (0: empty) >**/
+    uint32_t *hashes; /**< hash of each slot >**/
+    uint32_t mask;    /**< slots - 1 >**/
+    uint32_t ids;     /**< distinct lines >**/
+};
+
+/**
+ * @fn bool tokenize(struct diff_side_s *side, uint32_t len, uint8_t mode)
+ * @brief Split side->data[0..len) into tokens
+ *
+ */
+static bool tokenize(struct diff_side_s *side, uint32_t len, uint8_t mode) {
+    uint32_t n = len;
+
+    if (mode == DIFF_LINES)
+        n = string_simd->count_byte(side->data, len, '\n') + (len > 0 && side->data[len - 1] != '\n');
+
+    side->n = n;
+    side->id = malloc(((size_t) n + 1) * sizeof(uint32_t));
+    side->off = malloc(((size_t) n + 1) * sizeof(uint32_t));
+    side->mark = calloc(n + 1, 1);
+    if (side->id == NULL || side->off == NULL || side->mark == NULL)
+        return false;
+
+    if (mode == DIFF_BYTES) {
+        for (uint32_t i = 0; i <= n; i++)
+            side->off[i] = i;
+        for (uint32_t i = 0; i < n; i++)
+            side->id[i] = (uint8_t) side->data[i];
+        return true;
+    }
+
+    side->off[0] = 0;
+    const uint32_t newlines = string_simd->index_byte(side->data, len, '\n', side->off + 1, 1);
+    if (newlines < n)
+        side->off[n] = len;
+
+    return true;
+}
+
+/**
+ * @fn bool intern_lines(struct diff_side_s *sides[2])
+ * @brief Give equal lines of both sides equal ids
+ *
+ */
+static bool intern_lines(struct diff_side_s *sides[2]) {
+    struct line_table_s t;
+    uint32_t slots = 16;
+
+    while (slots < 2 * (sides[0]->n + sides[1]->n))
+        slots <<= 1;
+
+    t.slots = calloc(slots, sizeof(uint32_t));
+    t.hashes = malloc(slots * sizeof(uint32_t));
+    t.mask = slots - 1;
+    t.ids = 0;
+    if (t.slots == NULL || t.hashes == NULL) {
+        free(t.slots);
+        free(t.hashes);
+        return false;
+    }
+
+    // slot value: (side << 31 | token) + 1, the owner of the id
+    for (int s = 0; s < 2; s++) {
+        struct diff_side_s *side = sides[s];
+        for (uint32_t i = 0; i < side->n; i++) {
+            const char *line = side->data + side->off[i];
+            const uint32_t len = side->off[i + 1] - side->off[i];
+            const uint32_t hash = string_simd->crc32c(len, line, len);
+            uint32_t slot = hash & t.mask;
+
+            for (;; slot = (slot + 1) & t.mask) {
+                if (t.slots[slot] == 0) {
+                    t.slots[slot] = ((uint32_t) s << 31 | i) + 1;
+                    t.hashes[slot] = hash;
+                    side->id[i] = t.ids++;
+                    break;
+                }
+
+                const struct diff_side_s *owner = sides[(t.slots[slot] - 1) >> 31];
+                const uint32_t j = (t.slots[slot] - 1) & 0x7fffffff;
+                if (t.hashes[slot] == hash && owner->off[j + 1] - owner->off[j] == len && !memcmp(owner->data + owner->off[j], line, len)) {
+                    side->id[i] = owner->id[j];
+                    break;
+                }
+            }
+        }
+    }
+
+    free(t.slots);
+    free(t.hashes);
+
+    return true;
+}
+
+/**
+ * @fn bool diff_emit(string_diff_op_t **ops, uint32_t *count, uint32_t *cap, uint8_t op, const char *data, uint32_t len)
+ * @brief Append text to the edit script, merging with the previous entry of the same type
+ *
+ */
+static bool diff_emit(string_diff_op_t **ops, uint32_t *count, uint32_t *cap, uint8_t op, const char *data, uint32_t len) {
+    if (len == 0)
+        return true;
+
+    if (*count > 0 && (*ops)[*count - 1].op == op && (*ops)[*count - 1].text.data + (*ops)[*count - 1].text.length == data) {
+        (*ops)[*count - 1].text.length += len;
+        return true;
+    }
+
+    if (*count == *cap) {
+        const uint32_t newcap = *cap ? *cap * 2 : 16;
+        string_diff_op_t *tmp = realloc(*ops, newcap * sizeof(string_diff_op_t));
+        if (tmp == NULL)
+            return false;
+        *ops = tmp;
+        *cap = newcap;
+    }
+
+    (*ops)[*count].op = op;
+    (*ops)[*count].text.data = data;
+    (*ops)[(*count)++].text.length = len;
+
+    return true;
+}
+
+/**
+ * @fn uint32_t string_diff(const String a, const String b, uint8_t mode, string_diff_op_t **ops)
+ * @brief Edit script turning a into b (Myers O(ND), linear space). Views point into a and b.
+ *
+ * @param a Buffered string (old)
+ * @param b Buffered string (new)
+ * @param mode enum STRING_DIFF_MODE
+ * @param ops Edit script (allocated, free by caller)
+ * @return Number of entries|STR_ERROR
+ */
+uint32_t string_diff(const String a, const String b, uint8_t mode, string_diff_op_t **ops) {
+    if (a == NULL || b == NULL || ops == NULL || mode > DIFF_BYTES)
+        return STR_ERROR;
+
+    *ops = NULL;
+
+    // common prefix and suffix are stripped before tokenizing (whole lines in line mode)
+    const uint32_t min = a->length < b->length ? a->length : b->length;
+    uint32_t pre = string_simd->mismatch(a->data, b->data, min);
+    uint32_t suf = string_simd->rmismatch(a->data + a->length - (min - pre), b->data + b->length - (min - pre), min - pre);
+
+    if (mode == DIFF_LINES) {
+        const size_t nl = string_simd->rfind_byte(a->data, pre, '\n');
+        pre = (nl == STRING_SIMD_NOT_FOUND) ? 0 : nl + 1;
+
+        const uint32_t sa = a->length - suf, sb = b->length - suf;
+        if (suf > 0 && !((sa == 0 || a->data[sa - 1] == '\n') && (sb == 0 || b->data[sb - 1] == '\n'))) {
+            const size_t p = string_simd->find_byte(a->data + sa, suf, '\n');
+            suf = (p == STRING_SIMD_NOT_FOUND) ? 0 : suf - p - 1;
+        }
+    }
+
+    struct diff_side_s sa = { a->data + pre, 0, NULL, NULL, NULL };
+    struct diff_side_s sb = { b->data + pre, 0, NULL, NULL, NULL };
+    struct diff_side_s *sides[2] = { &sa, &sb };
+    uint32_t count = 0, cap = 0;
+    bool ok = tokenize(&sa, a->length - pre - suf, mode) && tokenize(&sb, b->length - pre - suf, mode);
+
+    if (ok && mode == DIFF_LINES)
+        ok = intern_lines(sides);
+
+    if (ok) {
+        diff_range(&sa, 0, sa.n, &sb, 0, sb.n);
+
+        ok = diff_emit(ops, &count, &cap, DIFF_EQUAL, a->data, pre);
+        uint32_t i = 0, j = 0;
+        while (ok && (i < sa.n || j < sb.n)) {
+            if (i < sa.n && sa.mark[i]) {
+                ok = diff_emit(ops, &count, &cap, DIFF_DELETE, sa.data + sa.off[i], sa.off[i + 1] - sa.off[i]);
+                ++i;
+            } else if (j < sb.n && sb.mark[j]) {
+                ok = diff_emit(ops, &count, &cap, DIFF_INSERT, sb.data + sb.off[j], sb.off[j + 1] - sb.off[j]);
+                ++j;
+            } else {
+                ok = diff_emit(ops, &count, &cap, DIFF_EQUAL, sa.data + sa.off[i], sa.off[i + 1] - sa.off[i]);
+                ++i;
+                ++j;
+            }
+        }
+        ok = ok && diff_emit(ops, &count, &cap, DIFF_EQUAL, a->data + a->length - suf, suf);
+    }
+
+    for (int s = 0; s < 2; s++) {
+        free(sides[s]->id);
+        free(sides[s]->off);
+        free(sides[s]->mark);
+    }
+
+    if (!ok) {
+        free(*ops);
+        *ops = NULL;
+        return STR_ERROR;
+    }
+
+    return count;
+}
+
+/**
+ * @fn String string_patch(const String a, const string_diff_op_t *ops, uint32_t count)
+ * @brief Apply an edit script to a (one allocation). Equal and deleted text must match a.
+ *
+ * @param a Buffered string (old)
+ * @param ops Edit script
+ * @param count Number of entries
+ * @return Buffered string (new)|NULL
+ */
+String string_patch(const String a, const string_diff_op_t *ops, uint32_t count) {
+    if (a == NULL || (ops == NULL && count > 0))
+        return NULL;
+
+    uint64_t length = 0, consumed = 0;
+    for (uint32_t n = 0; n < count; n++) {
+        if (ops[n].op > DIFF_INSERT)
+            return NULL;
+        if (ops[n].op != DIFF_DELETE)
+            length += ops[n].text.length;
+        if (ops[n].op != DIFF_INSERT)
+            consumed += ops[n].text.length;
+    }
+
+    if (consumed != a->length || length > UINT32_MAX - 1)
+        return NULL;
+
+    String result = string_new_uninit(length);
+    if (result == NULL)
+        return NULL;
+
+    uint32_t from = 0;
+    char *out = result->data;
+    for (uint32_t n = 0; n < count; n++) {
+        const string_view_t *text = &ops[n].text;
+
+        if (ops[n].op != DIFF_INSERT) {
+            if (memcmp(a->data + from, text->data, text->length)) {
+                free(result);
+                return NULL;
+            }
+            from += text->length;
+        }
+
+        if (ops[n].op != DIFF_DELETE) {
+            memcpy(out, text->data, text->length);
+            out += text->length;
+        }
+    }
+
+    result->length = length;
+
+    return result;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file strings_diff.h
+ * @brief line and byte diff (Myers) and patch
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef STRINGS_DIFF_H_
+#define STRINGS_DIFF_H_
+
+#include <stdint.h>
+
+#include "strings.h"
+
+/**
+ * @enum STRING_DIFF_MODE
+ * @brief Diff granularity
+ *
+ */
+enum STRING_DIFF_MODE {
+    DIFF_LINES, /**< lines (including their newline) >**/
+    DIFF_BYTES  /**< bytes >**/
+};
+
+/**
+ * @enum STRING_DIFF_OP
+ * @brief Edit operation
+ *
+ */
+enum STRING_DIFF_OP {
+    DIFF_EQUAL,  /**< text kept (view into a) >**/
+    DIFF_DELETE, /**< text removed (view into a) >**/
+    DIFF_INSERT  /**< text added (view into b) >**/
+};
+
+/**
+ * @struct string_diff_op_s
+ * @brief Edit script entry
+ *
+ */
+struct string_diff_op_s {
+          uint8_t op;   /**< enum STRING_DIFF_OP >**/
+    string_view_t text; /**< affected text >**/
+};
+typedef struct string_diff_op_s string_diff_op_t; /**< edit script entry type >**/
+
+uint32_t string_diff(const String a, const String b, uint8_t mode, string_diff_op_t **ops);
+  String string_patch(const String a, const string_diff_op_t *ops, uint32_t count);
+
+#endif /* STRINGS_DIFF_H_ */
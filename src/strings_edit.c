@@ -0,0 +1,200 @@
+/**
+ * @file strings_edit.c
+ * @brief batched edits applied in one pass
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "strings.h"
+#include "strings_edit.h"
+
+/**
+ * @fn int edit_cmp(const void *a, const void *b)
+ * @brief Order edits by position, then insertion order
+ *
+ */
+static int edit_cmp(const void *a, const void *b) {
+    const string_edit_t *x = a, *y = b;
+
+    if (x->pos != y->pos)
+        return x->pos < y->pos ? -1 : 1;
+
+    return x->seq < y->seq ? -1 : x->seq > y->seq;
+}
+
+/**
+ * @fn string_edits_t* string_edits_new(void)
+ * @brief New empty edit batch
+ *
+ * @return Edit batch
+ */
+string_edits_t* string_edits_new(void) {
+    string_edits_t *e = calloc(1, sizeof(string_edits_t));
+
+    if (e != NULL)
+        e->sorted = true;
+
+    return e;
+}
+
+/**
+ * @fn void string_edits_free(string_edits_t *e)
+ * @brief Free edit batch (inserted texts are not owned)
+ *
+ * @param e Edit batch
+ */
+void string_edits_free(string_edits_t *e) {
+    if (e == NULL)
+        return;
+
+    free(e->edits);
+    free(e);
+}
+
+/**
+ * @fn void string_edits_clear(string_edits_t *e)
+ * @brief Remove all edits keeping the allocation
+ *
+ * @param e Edit batch
+ */
+void string_edits_clear(string_edits_t *e) {
+    if (e == NULL)
+        return;
+
+    e->count = 0;
+    e->sorted = true;
+}
+
+/**
+ * @fn bool string_edits_add_view(string_edits_t *e, uint32_t pos, uint32_t del, string_view_t insert)
+ * @brief Queue an edit: replace del bytes at pos (of the original string) with insert
+ *
+ * @param e Edit batch
+ * @param pos Position
+ * @param del Bytes to delete
+ * @param insert Bytes to insert (must stay valid until apply)
+ * @return Boolean
+ */
+bool string_edits_add_view(string_edits_t *e, uint32_t pos, uint32_t del, string_view_t insert) {
+    if (e == NULL || (insert.data == NULL && insert.length > 0) || del > UINT32_MAX - pos)
+        return false;
+
+    if (e->count == e->cap) {
+        const uint32_t cap = e->cap ? e->cap * 2 : 16;
+        string_edit_t *tmp = realloc(e->edits, cap * sizeof(string_edit_t));
+        if (tmp == NULL)
+            return false;
+        e->edits = tmp;
+        e->cap = cap;
+    }
+
+    if (e->count > 0 && pos < e->edits[e->count - 1].pos)
+        e->sorted = false;
+
+    e->edits[e->count].pos = pos;
+    e->edits[e->count].del = del;
+    e->edits[e->count].text = insert;
+    e->edits[e->count].seq = e->count;
+    ++e->count;
+
+    return true;
+}
+
+/**
+ * @fn bool string_edits_add(string_edits_t *e, uint32_t pos, uint32_t del, const String insert)
+ * @brief Queue an edit: replace del bytes at pos (of the original string) with insert
+ *
+ * @param e Edit batch
+ * @param pos Position
+ * @param del Bytes to delete
+ * @param insert Buffered string to insert (NULL: none, must stay valid until apply)
+ * @return Boolean
+ */
+bool string_edits_add(string_edits_t *e, uint32_t pos, uint32_t del, const String insert) {
+    string_view_t view = { "", 0 };
+
+    if (insert != NULL)
+        view = string_view(insert);
+
+    return string_edits_add_view(e, pos, del, view);
+}
+
+/**
+ * @fn String string_edits_apply(const String buf, string_edits_t *e)
+ * @brief Apply all edits in one allocation and one copy pass. Edits must not overlap.
+ *
+ * @param buf Buffered string
+ * @param e Edit batch (sorted in place)
+ * @return Buffered string|NULL (overlap or out of range)
+ */
+String string_edits_apply(const String buf, string_edits_t *e) {
+    if (buf == NULL || e == NULL)
+        return NULL;
+
+    if (!e->sorted) {
+        qsort(e->edits, e->count, sizeof(string_edit_t), edit_cmp);
+        e->sorted = true;
+    }
+
+    uint64_t length = buf->length;
+    uint32_t end = 0;
+    for (uint32_t n = 0; n < e->count; n++) {
+        const string_edit_t *ed = &e->edits[n];
+        if (ed->pos < end || ed->pos + ed->del > buf->length)
+            return NULL;
+
+        end = ed->pos + ed->del;
+        length += ed->text.length;
+        length -= ed->del;
+    }
+
+    if (length > UINT32_MAX - 1)
+        return NULL;
+
+    String result = string_new_uninit(length);
+    if (result == NULL)
+        return NULL;
+
+    char *out = result->data;
+    uint32_t from = 0;
+    for (uint32_t n = 0; n < e->count; n++) {
+        const string_edit_t *ed = &e->edits[n];
+        memcpy(out, buf->data + from, ed->pos - from);
+        out += ed->pos - from;
+        memcpy(out, ed->text.data, ed->text.length);
+        out += ed->text.length;
+        from = ed->pos + ed->del;
+    }
+    memcpy(out, buf->data + from, buf->length - from);
+
+    result->length = length;
+
+    return result;
+}
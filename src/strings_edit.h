@@ -0,0 +1,72 @@
+/**
+ * @file strings_edit.h
+ * @brief batched edits applied in one pass
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef STRINGS_EDIT_H_
+#define STRINGS_EDIT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "strings.h"
+
+/**
+ * @struct string_edit_s
+ * @brief One edit: replace del bytes at pos with text
+ *
+ */
+struct string_edit_s {
+         uint32_t pos;  /**< offset in original string >**/
+         uint32_t del;  /**< bytes removed >**/
+    string_view_t text; /**< bytes inserted (must stay valid until apply) >**/
+         uint32_t seq;  /**< insertion order (ties at same pos) >**/
+};
+typedef struct string_edit_s string_edit_t; /**< edit type >**/
+
+/**
+ * @struct string_edits_s
+ * @brief Batch of non-overlapping edits
+ *
+ */
+struct string_edits_s {
+    string_edit_t *edits; /**< edits >**/
+         uint32_t count;  /**< number of edits >**/
+         uint32_t cap;    /**< allocated edits >**/
+             bool sorted; /**< edits are in (pos, seq) order >**/
+};
+typedef struct string_edits_s string_edits_t; /**< edit batch type >**/
+
+string_edits_t* string_edits_new(void);
+           void string_edits_free(string_edits_t *e);
+           void string_edits_clear(string_edits_t *e);
+           bool string_edits_add(string_edits_t *e, uint32_t pos, uint32_t del, const String insert);
+           bool string_edits_add_view(string_edits_t *e, uint32_t pos, uint32_t del, string_view_t insert);
+         String string_edits_apply(const String buf, string_edits_t *e);
+
+#endif /* STRINGS_EDIT_H_ */
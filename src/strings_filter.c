@@ -0,0 +1,604 @@
+/**
+ * @file strings_filter.c
+ * @brief approximate membership filters keyed by string hashes
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "strings.h"
+#include "strings_filter.h"
+#include "strings_internal.h"
+
+#ifndef M_LN2
+#define M_LN2 0.69314718055994530942
+#endif
+
+/**
+ * @def BLOOM_BLOCK_BITS
+ * @brief bits per bloom block
+ *
+ */
+#define BLOOM_BLOCK_BITS (STRING_BLOOM_BLOCK_WORDS * 64)
+
+/**
+ * @def CUCKOO_MAX_KICKS
+ * @brief relocations tried before an insert gives up
+ *
+ */
+#define CUCKOO_MAX_KICKS 500
+
+/**
+ * @def FILTER_BLOOM_MAGIC
+ * @brief serialization magic of bloom filter
+ *
+ */
+#define FILTER_BLOOM_MAGIC  0x31464253 // "SBF1"
+
+/**
+ * @def FILTER_CUCKOO_MAGIC
+ * @brief serialization magic of cuckoo filter
+ *
+ */
+#define FILTER_CUCKOO_MAGIC 0x31464353 // "SCF1"
+
+///// bloom /////
+
+/**
+ * @fn string_bloom_t* bloom_alloc(uint32_t nblocks, uint8_t k, const uint8_t key[16])
+ * @brief Allocate an empty bloom filter
+ *
+ */
+static string_bloom_t* bloom_alloc(uint32_t nblocks, uint8_t k, const uint8_t key[16]) {
+    string_bloom_t *bf = malloc(sizeof(string_bloom_t));
+    if (bf == NULL)
+        return NULL;
+
+    bf->blocks = aligned_alloc(64, (size_t) nblocks * sizeof(*bf->blocks));
+    if (bf->blocks == NULL) {
+        free(bf);
+        return NULL;
+    }
+
+    memset(bf->blocks, 0, (size_t) nblocks * sizeof(*bf->blocks));
+    bf->nblocks = nblocks;
+    bf->k = k;
+    memcpy(bf->key, key, 16);
+
+    return bf;
+}
+
+/**
+ * @fn void bloom_locate(const string_bloom_t *bf, const String buf, uint32_t *block, uint64_t mask[STRING_BLOOM_BLOCK_WORDS])
+ * @brief Compute block and bit mask of a key.
+ *        High half of h1 selects the block, h2 and low half of h1 select k distinct bits inside it.
+ *
+ */
+static void bloom_locate(const string_bloom_t *bf, const String buf, uint32_t *block, uint64_t mask[STRING_BLOOM_BLOCK_WORDS]) {
+    uint64_t h1, h2;
+    string_hash128_view(string_view(buf), bf->key, &h1, &h2);
+
+    *block = (uint32_t) (((h1 >> 32) * (uint64_t) bf->nblocks) >> 32);
+    memset(mask, 0, STRING_BLOOM_BLOCK_WORDS * sizeof(uint64_t));
+
+    uint32_t pos = (uint32_t) h2;
+    const uint32_t step = (uint32_t) h1 | 1;
+    for (uint8_t n = 0; n < bf->k; n++) {
+        const uint32_t bit = (pos ^ (uint32_t) (h2 >> 32)) & (BLOOM_BLOCK_BITS - 1);
+        mask[bit >> 6] |= (uint64_t) 1 << (bit & 63);
+        pos += step;
+    }
+}
+
+/**
+ * @fn bool bloom_block_test(const uint64_t *block, const uint64_t *mask)
+ * @brief Test all mask bits against a block at once
+ *
+ */
+static inline bool bloom_block_test(const uint64_t *block, const uint64_t *mask) {
+#if defined(__SSE2__)
+    __m128i miss = _mm_setzero_si128();
+    for (int w = 0; w < STRING_BLOOM_BLOCK_WORDS; w += 2) {
+        const __m128i m = _mm_loadu_si128((const __m128i*) (mask + w));
+        const __m128i b = _mm_load_si128((const __m128i*) (block + w));
+        miss = _mm_or_si128(miss, _mm_andnot_si128(b, m));
+    }
+
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(miss, _mm_setzero_si128())) == 0xFFFF;
+#else
+    uint64_t miss = 0;
+    for (int w = 0; w < STRING_BLOOM_BLOCK_WORDS; w++)
+        miss |= mask[w] & ~block[w];
+
+    return miss == 0;
+#endif
+}
+
+/**
+ * @fn string_bloom_t* string_bloom_new(uint32_t n, double fpr, uint8_t key[16])
+ * @brief Allocate a blocked bloom filter sized for `n` keys at false positive rate `fpr`
+ *
+ * @param n Expected number of keys
+ * @param fpr Target false positive rate (0 < fpr < 1)
+ * @param key Siphash key
+ * @return Bloom filter|NULL
+ */
+string_bloom_t* string_bloom_new(uint32_t n, double fpr, uint8_t key[16]) {
+    if (key == NULL || fpr <= 0 || fpr >= 1)
+        return NULL;
+
+    if (n == 0)
+        n = 1;
+
+    // classic sizing plus 20% to compensate the load variance between blocks
+    const double bits = -(double) n * log(fpr) / (M_LN2 * M_LN2) * 1.2;
+    const double nblocks = ceil(bits / BLOOM_BLOCK_BITS);
+    if (nblocks > (double) (UINT32_MAX / sizeof(uint64_t[STRING_BLOOM_BLOCK_WORDS])))
+        return NULL;
+
+    double k = round(-log(fpr) / M_LN2);
+    if (k < 1)
+        k = 1;
+    if (k > 16)
+        k = 16;
+
+    return bloom_alloc((uint32_t) nblocks, (uint8_t) k, key);
+}
+
+/**
+ * @fn void string_bloom_free(string_bloom_t *bf)
+ * @brief Free bloom filter
+ *
+ * @param bf Bloom filter
+ */
+void string_bloom_free(string_bloom_t *bf) {
+    if (bf == NULL)
+        return;
+
+    free(bf->blocks);
+    free(bf);
+}
+
+/**
+ * @fn void string_bloom_add(string_bloom_t *bf, const String buf)
+ * @brief Add string to bloom filter
+ *
+ * @param bf Bloom filter
+ * @param buf Buffered string
+ */
+void string_bloom_add(string_bloom_t *bf, const String buf) {
+    if (bf == NULL || buf == NULL)
+        return;
+
+    uint32_t block;
+    uint64_t mask[STRING_BLOOM_BLOCK_WORDS];
+    bloom_locate(bf, buf, &block, mask);
+
+    for (int w = 0; w < STRING_BLOOM_BLOCK_WORDS; w++)
+        bf->blocks[block][w] |= mask[w];
+}
+
+/**
+ * @fn bool string_bloom_contains(const string_bloom_t *bf, const String buf)
+ * @brief Check if string may be in bloom filter
+ *
+ * @param bf Bloom filter
+ * @param buf Buffered string
+ * @return Boolean (false: definitely not present)
+ */
+bool string_bloom_contains(const string_bloom_t *bf, const String buf) {
+    if (bf == NULL || buf == NULL)
+        return false;
+
+    uint32_t block;
+    uint64_t mask[STRING_BLOOM_BLOCK_WORDS];
+    bloom_locate(bf, buf, &block, mask);
+
+    return bloom_block_test(bf->blocks[block], mask);
+}
+
+/**
+ * @fn String string_bloom_serialize(const string_bloom_t *bf)
+ * @brief Serialize bloom filter (little endian, includes key)
+ *
+ * @param bf Bloom filter
+ * @return Buffered string|NULL
+ */
+String string_bloom_serialize(const string_bloom_t *bf) {
+    if (bf == NULL)
+        return NULL;
+
+    const size_t words = (size_t) bf->nblocks * STRING_BLOOM_BLOCK_WORDS;
+    const size_t len = 4 + 4 + 1 + 16 + words * 8;
+    if (len > UINT32_MAX - 1)
+        return NULL;
+
+    String buf = string_new(len);
+    if (buf == NULL)
+        return NULL;
+
+    uint8_t *p = (uint8_t*) buf->data;
+    put_u32(p, FILTER_BLOOM_MAGIC);
+    put_u32(p + 4, bf->nblocks);
+    p[8] = bf->k;
+    memcpy(p + 9, bf->key, 16);
+    p += 25;
+
+    const uint64_t *w = bf->blocks[0];
+    for (size_t n = 0; n < words; n++, p += 8)
+        put_u64(p, w[n]);
+
+    buf->length = len;
+
+    return buf;
+}
+
+/**
+ * @fn string_bloom_t* string_bloom_deserialize(const String buf)
+ * @brief Rebuild bloom filter from string_bloom_serialize output
+ *
+ * @param buf Buffered string
+ * @return Bloom filter|NULL
+ */
+string_bloom_t* string_bloom_deserialize(const String buf) {
+    if (buf == NULL || buf->length < 25)
+        return NULL;
+
+    const uint8_t *p = (const uint8_t*) buf->data;
+    if (get_u32(p) != FILTER_BLOOM_MAGIC)
+        return NULL;
+
+    const uint32_t nblocks = get_u32(p + 4);
+    const uint8_t k = p[8];
+    if (nblocks == 0 || k == 0 || k > 16 || buf->length != 25 + (uint64_t) nblocks * STRING_BLOOM_BLOCK_WORDS * 8)
+        return NULL;
+
+    string_bloom_t *bf = bloom_alloc(nblocks, k, p + 9);
+    if (bf == NULL)
+        return NULL;
+
+    p += 25;
+    uint64_t *w = bf->blocks[0];
+    for (size_t n = 0; n < (size_t) nblocks * STRING_BLOOM_BLOCK_WORDS; n++, p += 8)
+        w[n] = get_u64(p);
+
+    return bf;
+}
+
+///// cuckoo /////
+
+/**
+ * @fn uint32_t cuckoo_alt(const string_cuckoo_t *cf, uint32_t index, uint16_t fp)
+ * @brief Alternate bucket of a fingerprint (partial-key cuckoo hashing)
+ *
+ */
+static inline uint32_t cuckoo_alt(const string_cuckoo_t *cf, uint32_t index, uint16_t fp) {
+    return (index ^ (uint32_t) (fp * UINT32_C(0x5bd1e995))) & (cf->nbuckets - 1);
+}
+
+/**
+ * @fn void cuckoo_locate(const string_cuckoo_t *cf, const String buf, uint32_t *i1, uint32_t *i2, uint16_t *fp)
+ * @brief Compute both candidate buckets and the fingerprint of a key
+ *
+ */
+static void cuckoo_locate(const string_cuckoo_t *cf, const String buf, uint32_t *i1, uint32_t *i2, uint16_t *fp) {
+    uint64_t h1, h2;
+    string_hash128_view(string_view(buf), cf->key, &h1, &h2);
+
+    *fp = (uint16_t) (h2 >> 48);
+    if (*fp == 0)
+        *fp = 1;
+
+    *i1 = (uint32_t) h1 & (cf->nbuckets - 1);
+    *i2 = cuckoo_alt(cf, *i1, *fp);
+}
+
+/**
+ * @fn bool cuckoo_bucket_put(string_cuckoo_t *cf, uint32_t index, uint16_t fp)
+ * @brief Store fingerprint in a free slot of bucket
+ *
+ */
+static inline bool cuckoo_bucket_put(string_cuckoo_t *cf, uint32_t index, uint16_t fp) {
+    for (int n = 0; n < STRING_CUCKOO_BUCKET_SIZE; n++) {
+        if (cf->buckets[index][n] == 0) {
+            cf->buckets[index][n] = fp;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @fn bool cuckoo_bucket_has(const string_cuckoo_t *cf, uint32_t index, uint16_t fp)
+ * @brief Check fingerprint in bucket
+ *
+ */
+static inline bool cuckoo_bucket_has(const string_cuckoo_t *cf, uint32_t index, uint16_t fp) {
+    const uint16_t *b = cf->buckets[index];
+
+    return (b[0] == fp) | (b[1] == fp) | (b[2] == fp) | (b[3] == fp);
+}
+
+/**
+ * @fn string_cuckoo_t* cuckoo_alloc(uint32_t nbuckets, const uint8_t key[16])
+ * @brief Allocate an empty cuckoo filter
+ *
+ */
+static string_cuckoo_t* cuckoo_alloc(uint32_t nbuckets, const uint8_t key[16]) {
+    string_cuckoo_t *cf = malloc(sizeof(string_cuckoo_t));
+    if (cf == NULL)
+        return NULL;
+
+    cf->buckets = calloc(nbuckets, sizeof(*cf->buckets));
+    if (cf->buckets == NULL) {
+        free(cf);
+        return NULL;
+    }
+
+    cf->nbuckets = nbuckets;
+    cf->count = 0;
+    cf->victim_index = 0;
+    cf->victim_fp = 0;
+    cf->rnd = UINT64_C(0x9E3779B97F4A7C15);
+    memcpy(cf->key, key, 16);
+
+    return cf;
+}
+
+/**
+ * @fn string_cuckoo_t* string_cuckoo_new(uint32_t n, uint8_t key[16])
+ * @brief Allocate a cuckoo filter for `n` keys (about 0.1% false positive rate)
+ *
+ * @param n Expected number of keys
+ * @param key Siphash key
+ * @return Cuckoo filter|NULL
+ */
+string_cuckoo_t* string_cuckoo_new(uint32_t n, uint8_t key[16]) {
+    if (key == NULL)
+        return NULL;
+
+    // 95% maximum load
+    uint64_t need = ((uint64_t) n * 100 / 95 + STRING_CUCKOO_BUCKET_SIZE - 1) / STRING_CUCKOO_BUCKET_SIZE;
+    uint64_t nbuckets = 1;
+    while (nbuckets < need)
+        nbuckets <<= 1;
+
+    if (nbuckets > (UINT32_MAX / sizeof(uint16_t[STRING_CUCKOO_BUCKET_SIZE])) + 1)
+        return NULL;
+
+    return cuckoo_alloc((uint32_t) nbuckets, key);
+}
+
+/**
+ * @fn void string_cuckoo_free(string_cuckoo_t *cf)
+ * @brief Free cuckoo filter
+ *
+ * @param cf Cuckoo filter
+ */
+void string_cuckoo_free(string_cuckoo_t *cf) {
+    if (cf == NULL)
+        return;
+
+    free(cf->buckets);
+    free(cf);
+}
+
+/**
+ * @fn bool string_cuckoo_add(string_cuckoo_t *cf, const String buf)
+ * @brief Add string to cuckoo filter
+ *
+ * @param cf Cuckoo filter
+ * @param buf Buffered string
+ * @return Boolean (false: filter full)
+ */
+bool string_cuckoo_add(string_cuckoo_t *cf, const String buf) {
+    if (cf == NULL || buf == NULL || cf->victim_fp != 0)
+        return false;
+
+    uint32_t i1, i2;
+    uint16_t fp;
+    cuckoo_locate(cf, buf, &i1, &i2, &fp);
+
+    if (cuckoo_bucket_put(cf, i1, fp) || cuckoo_bucket_put(cf, i2, fp)) {
+        ++cf->count;
+        return true;
+    }
+
+    uint32_t index = (cf->rnd & 1) ? i1 : i2;
+    for (int kick = 0; kick < CUCKOO_MAX_KICKS; kick++) {
+        // xorshift64
+        cf->rnd ^= cf->rnd << 13;
+        cf->rnd ^= cf->rnd >> 7;
+        cf->rnd ^= cf->rnd << 17;
+
+        const int slot = cf->rnd % STRING_CUCKOO_BUCKET_SIZE;
+        const uint16_t evicted = cf->buckets[index][slot];
+        cf->buckets[index][slot] = fp;
+        fp = evicted;
+        index = cuckoo_alt(cf, index, fp);
+
+        if (cuckoo_bucket_put(cf, index, fp)) {
+            ++cf->count;
+            return true;
+        }
+    }
+
+    // keep the homeless fingerprint so no inserted key is lost
+    cf->victim_fp = fp;
+    cf->victim_index = index;
+    ++cf->count;
+
+    return true;
+}
+
+/**
+ * @fn bool string_cuckoo_contains(const string_cuckoo_t *cf, const String buf)
+ * @brief Check if string may be in cuckoo filter
+ *
+ * @param cf Cuckoo filter
+ * @param buf Buffered string
+ * @return Boolean (false: definitely not present)
+ */
+bool string_cuckoo_contains(const string_cuckoo_t *cf, const String buf) {
+    if (cf == NULL || buf == NULL)
+        return false;
+
+    uint32_t i1, i2;
+    uint16_t fp;
+    cuckoo_locate(cf, buf, &i1, &i2, &fp);
+
+    if (cf->victim_fp == fp && (cf->victim_index == i1 || cf->victim_index == i2))
+        return true;
+
+    return cuckoo_bucket_has(cf, i1, fp) || cuckoo_bucket_has(cf, i2, fp);
+}
+
+/**
+ * @fn bool string_cuckoo_remove(string_cuckoo_t *cf, const String buf)
+ * @brief Remove string from cuckoo filter. Only remove strings previously added.
+ *
+ * @param cf Cuckoo filter
+ * @param buf Buffered string
+ * @return Boolean (false: not found)
+ */
+bool string_cuckoo_remove(string_cuckoo_t *cf, const String buf) {
+    if (cf == NULL || buf == NULL)
+        return false;
+
+    uint32_t i1, i2;
+    uint16_t fp;
+    cuckoo_locate(cf, buf, &i1, &i2, &fp);
+
+    const uint32_t idx[2] = { i1, i2 };
+    for (int i = 0; i < 2; i++) {
+        for (int n = 0; n < STRING_CUCKOO_BUCKET_SIZE; n++) {
+            if (cf->buckets[idx[i]][n] == fp) {
+                cf->buckets[idx[i]][n] = 0;
+                --cf->count;
+
+                // the stashed victim may fit now
+                if (cf->victim_fp != 0 && cuckoo_bucket_put(cf, cf->victim_index, cf->victim_fp))
+                    cf->victim_fp = 0;
+
+                return true;
+            }
+        }
+    }
+
+    if (cf->victim_fp == fp && (cf->victim_index == i1 || cf->victim_index == i2)) {
+        cf->victim_fp = 0;
+        --cf->count;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @fn String string_cuckoo_serialize(const string_cuckoo_t *cf)
+ * @brief Serialize cuckoo filter (little endian, includes key)
+ *
+ * @param cf Cuckoo filter
+ * @return Buffered string|NULL
+ */
+String string_cuckoo_serialize(const string_cuckoo_t *cf) {
+    if (cf == NULL)
+        return NULL;
+
+    const size_t slots = (size_t) cf->nbuckets * STRING_CUCKOO_BUCKET_SIZE;
+    const size_t len = 4 + 4 + 4 + 4 + 2 + 16 + slots * 2;
+    if (len > UINT32_MAX - 1)
+        return NULL;
+
+    String buf = string_new(len);
+    if (buf == NULL)
+        return NULL;
+
+    uint8_t *p = (uint8_t*) buf->data;
+    put_u32(p, FILTER_CUCKOO_MAGIC);
+    put_u32(p + 4, cf->nbuckets);
+    put_u32(p + 8, cf->count);
+    put_u32(p + 12, cf->victim_index);
+    p[16] = (uint8_t) cf->victim_fp;
+    p[17] = (uint8_t) (cf->victim_fp >> 8);
+    memcpy(p + 18, cf->key, 16);
+    p += 34;
+
+    const uint16_t *s = cf->buckets[0];
+    for (size_t n = 0; n < slots; n++, p += 2) {
+        p[0] = (uint8_t) s[n];
+        p[1] = (uint8_t) (s[n] >> 8);
+    }
+
+    buf->length = len;
+
+    return buf;
+}
+
+/**
+ * @fn string_cuckoo_t* string_cuckoo_deserialize(const String buf)
+ * @brief Rebuild cuckoo filter from string_cuckoo_serialize output
+ *
+ * @param buf Buffered string
+ * @return Cuckoo filter|NULL
+ */
+string_cuckoo_t* string_cuckoo_deserialize(const String buf) {
+    if (buf == NULL || buf->length < 34)
+        return NULL;
+
+    const uint8_t *p = (const uint8_t*) buf->data;
+    if (get_u32(p) != FILTER_CUCKOO_MAGIC)
+        return NULL;
+
+    const uint32_t nbuckets = get_u32(p + 4);
+    if (nbuckets == 0 || (nbuckets & (nbuckets - 1)) != 0
+            || buf->length != 34 + (uint64_t) nbuckets * STRING_CUCKOO_BUCKET_SIZE * 2)
+        return NULL;
+
+    string_cuckoo_t *cf = cuckoo_alloc(nbuckets, p + 18);
+    if (cf == NULL)
+        return NULL;
+
+    cf->count = get_u32(p + 8);
+    cf->victim_index = get_u32(p + 12) & (nbuckets - 1);
+    cf->victim_fp = (uint16_t) (p[16] | (p[17] << 8));
+    p += 34;
+
+    uint16_t *s = cf->buckets[0];
+    for (size_t n = 0; n < (size_t) nbuckets * STRING_CUCKOO_BUCKET_SIZE; n++, p += 2)
+        s[n] = (uint16_t) (p[0] | (p[1] << 8));
+
+    return cf;
+}
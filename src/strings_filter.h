@@ -0,0 +1,98 @@
+/**
+ * @file strings_filter.h
+ * @brief approximate membership filters keyed by string hashes
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef STRINGS_FILTER_H_
+#define STRINGS_FILTER_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "strings.h"
+
+/**
+ * @def STRING_BLOOM_BLOCK_WORDS
+ * @brief 64 bit words per bloom block (one cache line)
+ *
+ */
+#define STRING_BLOOM_BLOCK_WORDS 8
+
+/**
+ * @def STRING_CUCKOO_BUCKET_SIZE
+ * @brief Fingerprints per cuckoo bucket
+ *
+ */
+#define STRING_CUCKOO_BUCKET_SIZE 4
+
+/**
+ * @struct string_bloom_s
+ * @brief Blocked bloom filter
+ *
+ */
+struct string_bloom_s {
+    uint64_t (*blocks)[STRING_BLOOM_BLOCK_WORDS]; /**< cache line aligned blocks >**/
+    uint32_t nblocks;                             /**< number of blocks >**/
+     uint8_t k;                                   /**< bits set per key (1..16) >**/
+     uint8_t key[16];                             /**< siphash key >**/
+};
+typedef struct string_bloom_s string_bloom_t; /**< blocked bloom filter type >**/
+
+/**
+ * @struct string_cuckoo_s
+ * @brief Cuckoo filter (16 bit fingerprints, 4 per bucket)
+ *
+ */
+struct string_cuckoo_s {
+    uint16_t (*buckets)[STRING_CUCKOO_BUCKET_SIZE]; /**< buckets >**/
+    uint32_t nbuckets;                              /**< number of buckets (power of 2) >**/
+    uint32_t count;                                 /**< stored fingerprints >**/
+    uint32_t victim_index;                          /**< bucket of evicted fingerprint >**/
+    uint16_t victim_fp;                             /**< evicted fingerprint (0: none) >**/
+    uint64_t rnd;                                   /**< victim selection state >**/
+     uint8_t key[16];                               /**< siphash key >**/
+};
+typedef struct string_cuckoo_s string_cuckoo_t; /**< cuckoo filter type >**/
+
+string_bloom_t* string_bloom_new(uint32_t n, double fpr, uint8_t key[16]);
+           void string_bloom_free(string_bloom_t *bf);
+           void string_bloom_add(string_bloom_t *bf, const String buf);
+           bool string_bloom_contains(const string_bloom_t *bf, const String buf);
+         String string_bloom_serialize(const string_bloom_t *bf);
+string_bloom_t* string_bloom_deserialize(const String buf);
+
+string_cuckoo_t* string_cuckoo_new(uint32_t n, uint8_t key[16]);
+            void string_cuckoo_free(string_cuckoo_t *cf);
+            bool string_cuckoo_add(string_cuckoo_t *cf, const String buf);
+            bool string_cuckoo_contains(const string_cuckoo_t *cf, const String buf);
+            bool string_cuckoo_remove(string_cuckoo_t *cf, const String buf);
+          String string_cuckoo_serialize(const string_cuckoo_t *cf);
+string_cuckoo_t* string_cuckoo_deserialize(const String buf);
+
+#endif /* STRINGS_FILTER_H_ */
@@ -0,0 +1,442 @@
+/**
+ * @file strings_intern.c
+ * @brief intern table with mmap loadable snapshots
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "strings.h"
+#include "strings_intern.h"
+
+/**
+ * @def INTERN_MAGIC
+ * @brief Snapshot signature (native byte order, format 1)
+ *
+ */
+#define INTERN_MAGIC 0x314e5245544e4953ull
+
+/**
+ * @def INTERN_ALIGN
+ * @brief Alignment of snapshot sections
+ *
+ */
+#define INTERN_ALIGN 64
+
+/**
+ * @def INTERN_KEY_MEM
+ * @brief Snapshot bytes of a key stored as string_t (header, data and terminator).
+ *        The following key provides the STRING_PAD readable bytes, the last one is followed by STRING_PAD zeros.
+ *
+ */
+#define INTERN_KEY_MEM(len) ((sizeof(string_t) + (uint64_t) (len) + 1 + STRING_ALIGN - 1) & ~(uint64_t) (STRING_ALIGN - 1))
+
+/**
+ * @struct intern_file_s
+ * @brief Snapshot header. Sections follow: hashes, String offsets, index, keys.
+ *
+ */
+struct intern_file_s {
+    uint64_t magic;     /**< INTERN_MAGIC >**/
+    uint64_t size;      /**< file size >**/
+    uint32_t count;     /**< entries >**/
+    uint32_t slots;     /**< index slots >**/
+     uint8_t key[16];   /**< siphash key >**/
+    uint64_t hash_off;  /**< uint64_t hash[count] >**/
+    uint64_t str_off;   /**< uint64_t string offset[count] >**/
+    uint64_t index_off; /**< uint32_t index[slots] >**/
+    uint64_t keys_off;  /**< string_t keys >**/
+};
+
+/**
+ * @fn uint64_t align_up(uint64_t n)
+ * @brief Round up to INTERN_ALIGN
+ *
+ */
+static inline uint64_t align_up(uint64_t n) {
+    return (n + INTERN_ALIGN - 1) & ~(uint64_t) (INTERN_ALIGN - 1);
+}
+
+/**
+ * @fn bool intern_rehash(string_intern_t *t, uint32_t slots)
+ * @brief Rebuild index with slots slots from the cached hashes
+ *
+ */
+static bool intern_rehash(string_intern_t *t, uint32_t slots) {
+    uint32_t *index = calloc(slots, sizeof(uint32_t));
+    if (index == NULL)
+        return false;
+
+    for (uint32_t id = 0; id < t->count; id++) {
+        uint32_t s = string_intern_hash(t, id) & (slots - 1);
+        while (index[s] != 0)
+            s = (s + 1) & (slots - 1);
+        index[s] = id + 1;
+    }
+
+    if (t->own_index)
+        free(t->index);
+    t->index = index;
+    t->own_index = true;
+    t->slots = slots;
+
+    return true;
+}
+
+/**
+ * @fn uint32_t intern_lookup(const string_intern_t *t, string_view_t view, uint64_t h, uint32_t *slot)
+ * @brief Find view, return id or STR_ERROR with the free slot where it goes
+ *
+ */
+static uint32_t intern_lookup(const string_intern_t *t, string_view_t view, uint64_t h, uint32_t *slot) {
+    uint32_t s = h & (t->slots - 1);
+
+    while (t->index[s] != 0) {
+        const uint32_t id = t->index[s] - 1;
+
+        if (string_intern_hash(t, id) == h) {
+            const String key = string_intern_get(t, id);
+            if (key->length == view.length && !memcmp(key->data, view.data, view.length))
+                return id;
+        }
+
+        s = (s + 1) & (t->slots - 1);
+    }
+
+    if (slot != NULL)
+        *slot = s;
+
+    return STR_ERROR;
+}
+
+/**
+ * @fn string_intern_t* string_intern_new(uint32_t n, uint8_t key[16])
+ * @brief New intern table
+ *
+ * @param n Expected entries
+ * @param key SIP64 key (NULL: zero key)
+ * @return Intern table
+ */
+string_intern_t* string_intern_new(uint32_t n, uint8_t key[16]) {
+    if (n > (1u << 30))
+        return NULL;
+
+    string_intern_t *t = calloc(1, sizeof(string_intern_t));
+    if (t == NULL)
+        return NULL;
+
+    if (key != NULL)
+        memcpy(t->key, key, 16);
+
+    uint32_t slots = 16;
+    while (slots / 4 * 3 < n)
+        slots <<= 1;
+
+    if (!intern_rehash(t, slots)) {
+        free(t);
+        return NULL;
+    }
+
+    return t;
+}
+
+/**
+ * @fn void string_intern_free(string_intern_t *t)
+ * @brief Free intern table (and unmap its snapshot)
+ *
+ * @param t Intern table
+ */
+void string_intern_free(string_intern_t *t) {
+    if (t == NULL)
+        return;
+
+    for (uint32_t id = t->base; id < t->count; id++)
+        free(t->str[id - t->base]);
+    free(t->str);
+    free(t->hash);
+    if (t->own_index)
+        free(t->index);
+    if (t->map != NULL)
+        munmap(t->map, t->map_size);
+    free(t);
+}
+
+/**
+ * @fn uint32_t string_intern_add(string_intern_t *t, string_view_t view)
+ * @brief Intern view
+ *
+ * @param t Intern table
+ * @param view Bytes
+ * @return Entry id (existing or new), STR_ERROR on error
+ */
+uint32_t string_intern_add(string_intern_t *t, string_view_t view) {
+    if (t == NULL || view.data == NULL)
+        return STR_ERROR;
+
+    const uint64_t h = string_hash64_view(view, t->key);
+    uint32_t slot;
+    uint32_t id = intern_lookup(t, view, h, &slot);
+
+    if (id != STR_ERROR)
+        return id;
+
+    if (t->count >= (1u << 30))
+        return STR_ERROR;
+
+    if (t->count + 1 > t->slots / 4 * 3) {
+        if (!intern_rehash(t, t->slots * 2))
+            return STR_ERROR;
+        intern_lookup(t, view, h, &slot);
+    }
+
+    const uint32_t heap = t->count - t->base;
+    if (heap == t->cap) {
+        const uint32_t cap = t->cap ? t->cap * 2 : 64;
+        uint64_t *hash = realloc(t->hash, cap * sizeof(uint64_t));
+        if (hash == NULL)
+            return STR_ERROR;
+        t->hash = hash;
+
+        String *str = realloc(t->str, cap * sizeof(String));
+        if (str == NULL)
+            return STR_ERROR;
+        t->str = str;
+        t->cap = cap;
+    }
+
+    String key = string_new_view(view);
+    if (key == NULL)
+        return STR_ERROR;
+
+    id = t->count++;
+    t->hash[heap] = h;
+    t->str[heap] = key;
+    t->index[slot] = id + 1;
+
+    return id;
+}
+
+/**
+ * @fn uint32_t string_intern_find(const string_intern_t *t, string_view_t view)
+ * @brief Find interned view
+ *
+ * @param t Intern table
+ * @param view Bytes
+ * @return Entry id, STR_ERROR if not interned
+ */
+uint32_t string_intern_find(const string_intern_t *t, string_view_t view) {
+    if (t == NULL || view.data == NULL)
+        return STR_ERROR;
+
+    return intern_lookup(t, view, string_hash64_view(view, t->key), NULL);
+}
+
+/**
+ * @fn String string_intern_get(const string_intern_t *t, uint32_t id)
+ * @brief Canonical String of an entry
+ *
+ * @param t Intern table
+ * @param id Entry id
+ * @return Buffered string (owned by the table, read-only)
+ */
+String string_intern_get(const string_intern_t *t, uint32_t id) {
+    if (t == NULL || id >= t->count)
+        return NULL;
+
+    if (id < t->base)
+        return (String) (t->map + t->map_str[id]);
+
+    return t->str[id - t->base];
+}
+
+/**
+ * @fn uint64_t string_intern_hash(const string_intern_t *t, uint32_t id)
+ * @brief Cached SIP64 hash of an entry (first 8 bytes of string_hash with the table key)
+ *
+ * @param t Intern table
+ * @param id Entry id
+ * @return Hash (0 if id is invalid)
+ */
+uint64_t string_intern_hash(const string_intern_t *t, uint32_t id) {
+    if (t == NULL || id >= t->count)
+        return 0;
+
+    return id < t->base ? t->map_hash[id] : t->hash[id - t->base];
+}
+
+/**
+ * @fn bool string_intern_save(const string_intern_t *t, const char *path)
+ * @brief Write table snapshot (keys, cached hashes and index) for string_intern_load.
+ *        Written beside path and renamed over it, so mapped snapshots (even of t itself) stay valid.
+ *
+ * @param t Intern table
+ * @param path File
+ * @return Boolean
+ */
+bool string_intern_save(const string_intern_t *t, const char *path) {
+    if (t == NULL || path == NULL)
+        return false;
+
+    struct intern_file_s hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = INTERN_MAGIC;
+    hdr.count = t->count;
+    hdr.slots = t->slots;
+    memcpy(hdr.key, t->key, 16);
+    hdr.hash_off = align_up(sizeof(hdr));
+    hdr.str_off = align_up(hdr.hash_off + (uint64_t) t->count * sizeof(uint64_t));
+    hdr.index_off = align_up(hdr.str_off + (uint64_t) t->count * sizeof(uint64_t));
+    hdr.keys_off = align_up(hdr.index_off + (uint64_t) t->slots * sizeof(uint32_t));
+
+    uint64_t size = hdr.keys_off;
+    for (uint32_t id = 0; id < t->count; id++)
+        size += INTERN_KEY_MEM(string_intern_get(t, id)->length);
+    hdr.size = size + STRING_PAD;
+
+    const size_t plen = strlen(path);
+    char *tmp = malloc(plen + 5);
+    if (tmp == NULL)
+        return false;
+    memcpy(tmp, path, plen);
+    memcpy(tmp + plen, ".tmp", 5);
+
+    FILE *f = fopen(tmp, "wb");
+    if (f == NULL) {
+        free(tmp);
+        return false;
+    }
+
+    setvbuf(f, NULL, _IOFBF, 1 << 20);
+
+    static const uint8_t zero[INTERN_ALIGN + STRING_PAD + STRING_ALIGN];
+    bool ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1;
+    uint64_t pos = sizeof(hdr);
+
+    // sections, each padded to its offset
+#define INTERN_PAD(off) do { ok = ok && fwrite(zero, 1, (off) - pos, f) == (off) - pos; pos = (off); } while (0)
+    INTERN_PAD(hdr.hash_off);
+    for (uint32_t id = 0; ok && id < t->count; id++) {
+        const uint64_t h = string_intern_hash(t, id);
+        ok = fwrite(&h, sizeof(h), 1, f) == 1;
+    }
+    pos += (uint64_t) t->count * sizeof(uint64_t);
+
+    INTERN_PAD(hdr.str_off);
+    uint64_t off = hdr.keys_off;
+    for (uint32_t id = 0; ok && id < t->count; id++) {
+        ok = fwrite(&off, sizeof(off), 1, f) == 1;
+        off += INTERN_KEY_MEM(string_intern_get(t, id)->length);
+    }
+    pos += (uint64_t) t->count * sizeof(uint64_t);
+
+    INTERN_PAD(hdr.index_off);
+    ok = ok && fwrite(t->index, sizeof(uint32_t), t->slots, f) == t->slots;
+    pos += (uint64_t) t->slots * sizeof(uint32_t);
+
+    INTERN_PAD(hdr.keys_off);
+    for (uint32_t id = 0; ok && id < t->count; id++) {
+        const String key = string_intern_get(t, id);
+        const string_t kh = { .capacity = key->length, .length = key->length };
+        const uint64_t tail = INTERN_KEY_MEM(key->length) - sizeof(string_t) - key->length;
+
+        ok = fwrite(&kh, sizeof(string_t), 1, f) == 1
+                && fwrite(key->data, 1, key->length, f) == key->length
+                && fwrite(zero, 1, tail, f) == tail;
+    }
+    ok = ok && fwrite(zero, 1, STRING_PAD, f) == STRING_PAD;
+#undef INTERN_PAD
+
+    ok = (fclose(f) == 0) && ok;
+    ok = ok && rename(tmp, path) == 0;
+    if (!ok)
+        remove(tmp);
+    free(tmp);
+
+    return ok;
+}
+
+/**
+ * @fn string_intern_t* string_intern_load(const char *path)
+ * @brief Map a table snapshot. No per entry work: lookups use the mapped index and hashes,
+ *        new entries go to the heap (index pages are copied on first write).
+ *
+ * @param path File
+ * @return Intern table
+ */
+string_intern_t* string_intern_load(const char *path) {
+    if (path == NULL)
+        return NULL;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(struct intern_file_s)) {
+        close(fd);
+        return NULL;
+    }
+
+    uint8_t *map = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return NULL;
+
+    const struct intern_file_s *hdr = (const struct intern_file_s*) map;
+    if (hdr->magic != INTERN_MAGIC || hdr->size != (uint64_t) st.st_size || hdr->slots < 16
+            || (hdr->slots & (hdr->slots - 1)) != 0 || hdr->count > hdr->slots / 4 * 3
+            || hdr->hash_off + (uint64_t) hdr->count * sizeof(uint64_t) > hdr->str_off
+            || hdr->str_off + (uint64_t) hdr->count * sizeof(uint64_t) > hdr->index_off
+            || hdr->index_off + (uint64_t) hdr->slots * sizeof(uint32_t) > hdr->keys_off || hdr->keys_off > hdr->size) {
+        munmap(map, st.st_size);
+        return NULL;
+    }
+
+    string_intern_t *t = calloc(1, sizeof(string_intern_t));
+    if (t == NULL) {
+        munmap(map, st.st_size);
+        return NULL;
+    }
+
+    t->map = map;
+    t->map_size = st.st_size;
+    t->count = t->base = hdr->count;
+    t->slots = hdr->slots;
+    t->index = (uint32_t*) (map + hdr->index_off);
+    t->map_hash = (const uint64_t*) (map + hdr->hash_off);
+    t->map_str = (const uint64_t*) (map + hdr->str_off);
+    memcpy(t->key, hdr->key, 16);
+
+    return t;
+}
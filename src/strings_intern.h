@@ -0,0 +1,72 @@
+/**
+ * @file strings_intern.h
+ * @brief intern table with mmap loadable snapshots
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef STRINGS_INTERN_H_
+#define STRINGS_INTERN_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "strings.h"
+
+/**
+ * @struct string_intern_s
+ * @brief Intern table: one canonical read-only String per distinct key, found by cached SIP64 hash.
+ *        Entries below base live in a mapped snapshot, later ones on the heap.
+ *
+ */
+struct string_intern_s {
+          uint32_t count;     /**< entries (ids 0..count-1) >**/
+          uint32_t slots;     /**< index slots (power of 2) >**/
+          uint32_t *index;    /**< slot: entry id + 1 (0: empty) >**/
+              bool own_index; /**< index allocated (not in the mapping) >**/
+          uint32_t base;      /**< entries in the mapping >**/
+    const uint64_t *map_hash; /**< cached hashes of mapped entries >**/
+    const uint64_t *map_str;  /**< String offsets of mapped entries >**/
+           uint8_t *map;      /**< snapshot mapping (NULL if none) >**/
+            size_t map_size;  /**< mapping size >**/
+          uint64_t *hash;     /**< cached hashes of heap entries >**/
+            String *str;      /**< heap entries >**/
+          uint32_t cap;       /**< heap entry capacity >**/
+           uint8_t key[16];   /**< siphash key >**/
+};
+typedef struct string_intern_s string_intern_t; /**< intern table type >**/
+
+string_intern_t* string_intern_new(uint32_t n, uint8_t key[16]);
+            void string_intern_free(string_intern_t *t);
+        uint32_t string_intern_add(string_intern_t *t, string_view_t view);
+        uint32_t string_intern_find(const string_intern_t *t, string_view_t view);
+          String string_intern_get(const string_intern_t *t, uint32_t id);
+        uint64_t string_intern_hash(const string_intern_t *t, uint32_t id);
+            bool string_intern_save(const string_intern_t *t, const char *path);
+string_intern_t* string_intern_load(const char *path);
+
+#endif /* STRINGS_INTERN_H_ */
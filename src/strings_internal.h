@@ -0,0 +1,104 @@
+/**
+ * @file strings_internal.h
+ * @brief internal helpers shared by the modules (not part of the API)
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef STRINGS_INTERNAL_H_
+#define STRINGS_INTERNAL_H_
+
+#include <stdint.h>
+
+/**
+ * @def STRING_MIX64_M1
+ * @brief First splitmix64 multiplier
+ *
+ */
+#define STRING_MIX64_M1 UINT64_C(0xbf58476d1ce4e5b9)
+
+/**
+ * @def STRING_MIX64_M2
+ * @brief Second splitmix64 multiplier
+ *
+ */
+#define STRING_MIX64_M2 UINT64_C(0x94d049bb133111eb)
+
+/**
+ * @fn uint64_t string_mix64(uint64_t v)
+ * @brief 64 bit finalizer (splitmix64)
+ *
+ */
+static inline uint64_t string_mix64(uint64_t v) {
+    v ^= v >> 30;
+    v *= STRING_MIX64_M1;
+    v ^= v >> 27;
+    v *= STRING_MIX64_M2;
+    v ^= v >> 31;
+
+    return v;
+}
+
+/**
+ * @fn void put_u32(uint8_t *p, uint32_t v)
+ * @brief Store little endian 32 bit value
+ *
+ */
+static inline void put_u32(uint8_t *p, uint32_t v) {
+    for (int n = 0; n < 4; n++)
+        p[n] = (uint8_t) (v >> (8 * n));
+}
+
+/**
+ * @fn void put_u64(uint8_t *p, uint64_t v)
+ * @brief Store little endian 64 bit value
+ *
+ */
+static inline void put_u64(uint8_t *p, uint64_t v) {
+    for (int n = 0; n < 8; n++)
+        p[n] = (uint8_t) (v >> (8 * n));
+}
+
+/**
+ * @fn uint32_t get_u32(const uint8_t *p)
+ * @brief Load little endian 32 bit value (one load on little endian targets)
+ *
+ */
+static inline uint32_t get_u32(const uint8_t *p) {
+    return (uint32_t) p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16 | (uint32_t) p[3] << 24;
+}
+
+/**
+ * @fn uint64_t get_u64(const uint8_t *p)
+ * @brief Load little endian 64 bit value (one load on little endian targets)
+ *
+ */
+static inline uint64_t get_u64(const uint8_t *p) {
+    return (uint64_t) p[0] | (uint64_t) p[1] << 8 | (uint64_t) p[2] << 16 | (uint64_t) p[3] << 24 |
+           (uint64_t) p[4] << 32 | (uint64_t) p[5] << 40 | (uint64_t) p[6] << 48 | (uint64_t) p[7] << 56;
+}
+
+#endif /* STRINGS_INTERNAL_H_ */
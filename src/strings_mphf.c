@@ -0,0 +1,613 @@
+/**
+ * @file strings_mphf.c
+ * @brief minimal perfect hash functions over static String key sets
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+#include "strings.h"
+#include "strings_mphf.h"
+#include "strings_internal.h"
+
+/**
+ * @def MPHF_MAGIC
+ * @brief Serialization signature
+ *
+ */
+#define MPHF_MAGIC 0x31484d53 // "SMH1"
+
+/**
+ * @def MPHF_BUCKET_KEYS
+ * @brief Average keys per bucket
+ *
+ */
+#define MPHF_BUCKET_KEYS 4
+
+/**
+ * @def MPHF_SEEDS
+ * @brief Seeds tried before giving up
+ *
+ */
+#define MPHF_SEEDS 32
+
+/**
+ * @fn uint64_t mphf_hash(const char *s, size_t len, uint64_t seed)
+ * @brief Seeded key hash (not keyed: lookups verify the stored key). Kept in step with MPHF_HASH_SRC.
+ *
+ */
+static uint64_t mphf_hash(const char *s, size_t len, uint64_t seed) {
+    const uint8_t *p = (const uint8_t*) s;
+    uint64_t h = seed ^ ((uint64_t) len * 0x9e3779b97f4a7c15ull);
+    uint64_t v;
+
+    for (; len >= 8; len -= 8, p += 8) {
+        v = get_u64(p);
+        h = string_mix64(h ^ v);
+    }
+
+    v = 0;
+    for (size_t n = 0; n < len; n++)
+        v |= (uint64_t) p[n] << (8 * n);
+
+    return string_mix64(h ^ v ^ 0xff);
+}
+
+/**
+ * @fn uint32_t mphf_slot(uint64_t h, uint32_t pilot, uint32_t n)
+ * @brief Slot of a key hash under pilot
+ *
+ */
+static inline uint32_t mphf_slot(uint64_t h, uint32_t pilot, uint32_t n) {
+    return (h ^ string_mix64(pilot + 1)) % n;
+}
+
+/**
+ * @fn uint32_t mphf_bucket(uint64_t h, uint32_t nbuckets)
+ * @brief Bucket of a key hash
+ *
+ */
+static inline uint32_t mphf_bucket(uint64_t h, uint32_t nbuckets) {
+    return (h >> 32) % nbuckets;
+}
+
+/**
+ * @fn uint32_t mphf_pilot(const string_mphf_t *f, uint32_t b)
+ * @brief Pilot of bucket b
+ *
+ */
+static inline uint32_t mphf_pilot(const string_mphf_t *f, uint32_t b) {
+    const uint8_t *p = f->pilots + (size_t) b * f->width;
+
+    switch (f->width) {
+        case 1:
+            return p[0];
+        case 2:
+            return p[0] | (uint32_t) p[1] << 8;
+        default:
+            return get_u32(p);
+    }
+}
+
+/**
+ * @fn string_mphf_t* mphf_alloc(uint32_t n, uint32_t nbuckets, uint8_t width, uint32_t keys_len)
+ * @brief Allocate function arrays
+ *
+ */
+static string_mphf_t* mphf_alloc(uint32_t n, uint32_t nbuckets, uint8_t width, uint32_t keys_len) {
+    string_mphf_t *f = calloc(1, sizeof(string_mphf_t));
+    if (f == NULL)
+        return NULL;
+
+    f->n = n;
+    f->nbuckets = nbuckets;
+    f->width = width;
+    f->pilots = calloc(nbuckets, width);
+    f->ids = malloc((size_t) n * sizeof(uint32_t));
+    f->offsets = malloc(((size_t) n + 1) * sizeof(uint32_t));
+    f->keys = malloc((size_t) keys_len + 1);
+
+    if (f->pilots == NULL || f->ids == NULL || f->offsets == NULL || f->keys == NULL) {
+        string_mphf_free(f);
+        return NULL;
+    }
+
+    return f;
+}
+
+/**
+ * @fn bool mphf_search(const uint64_t *hash, uint32_t n, uint32_t nbuckets, uint32_t *order, uint32_t *start, uint32_t *pilots, uint32_t *slot_of)
+ * @brief Place buckets, largest first, each with the first pilot sending all its keys to free slots
+ *
+ */
+static bool mphf_search(const uint64_t *hash, uint32_t n, uint32_t nbuckets, uint32_t *order, uint32_t *start, uint32_t *pilots, uint32_t *slot_of) {
+    uint32_t *size_order = malloc((size_t) nbuckets * sizeof(uint32_t));
+    uint32_t *count = calloc((size_t) nbuckets + 1, sizeof(uint32_t));
+    uint8_t *taken = calloc(n, 1);
+    uint32_t max_size = 0;
+    bool ok = false;
+
+    if (size_order == NULL || count == NULL || taken == NULL)
+        goto done;
+
+    // empty buckets keep pilot 0 (also after an earlier seed failed)
+    memset(pilots, 0, (size_t) nbuckets * sizeof(uint32_t));
+
+    // keys grouped by bucket
+    for (uint32_t k = 0; k < n; k++)
+        ++count[mphf_bucket(hash[k], nbuckets) + 1];
+    for (uint32_t b = 0; b < nbuckets; b++) {
+        if (count[b + 1] > max_size)
+            max_size = count[b + 1];
+        count[b + 1] += count[b];
+    }
+    memcpy(start, count, ((size_t) nbuckets + 1) * sizeof(uint32_t));
+    for (uint32_t k = 0; k < n; k++)
+        order[count[mphf_bucket(hash[k], nbuckets)]++] = k;
+
+    // buckets by decreasing size
+    uint32_t pos = 0;
+    for (uint32_t s = max_size; s > 0; s--)
+        for (uint32_t b = 0; b < nbuckets; b++)
+            if (start[b + 1] - start[b] == s)
+                size_order[pos++] = b;
+
+    const uint64_t limit = (n < (UINT32_MAX >> 6)) ? 64 * (uint64_t) n + 4096 : UINT32_MAX;
+    for (uint32_t i = 0; i < pos; i++) {
+        const uint32_t b = size_order[i];
+        uint64_t p;
+
+        for (p = 0; p < limit; p++) {
+            uint32_t k;
+
+            for (k = start[b]; k < start[b + 1]; k++) {
+                const uint32_t s = mphf_slot(hash[order[k]], p, n);
+                if (taken[s])
+                    break;
+                taken[s] = 1;
+                slot_of[order[k]] = s;
+            }
+
+            if (k == start[b + 1])
+                break;
+
+            while (k-- > start[b])
+                taken[slot_of[order[k]]] = 0;
+        }
+
+        if (p == limit)
+            goto done;
+
+        pilots[b] = p;
+    }
+
+    ok = true;
+
+done:
+    free(taken);
+    free(count);
+    free(size_order);
+    return ok;
+}
+
+/**
+ * @fn string_mphf_t* string_mphf_build(const String *keys, uint32_t n)
+ * @brief Build a minimal perfect hash function of keys
+ *
+ * @param keys Distinct keys
+ * @param n Number of keys
+ * @return Function (NULL on duplicate keys or error)
+ */
+string_mphf_t* string_mphf_build(const String *keys, uint32_t n) {
+    if (keys == NULL || n == 0)
+        return NULL;
+
+    uint64_t keys_len = 0;
+    for (uint32_t k = 0; k < n; k++) {
+        if (keys[k] == NULL)
+            return NULL;
+        keys_len += keys[k]->length;
+    }
+    if (keys_len > UINT32_MAX - 1)
+        return NULL;
+
+    const uint32_t nbuckets = (n + MPHF_BUCKET_KEYS - 1) / MPHF_BUCKET_KEYS;
+    uint64_t *hash = malloc((size_t) n * sizeof(uint64_t));
+    uint32_t *order = malloc((size_t) n * sizeof(uint32_t));
+    uint32_t *slot_of = malloc((size_t) n * sizeof(uint32_t));
+    uint32_t *start = malloc(((size_t) nbuckets + 1) * sizeof(uint32_t));
+    uint32_t *pilots = calloc(nbuckets, sizeof(uint32_t));
+    string_mphf_t *f = NULL;
+    uint64_t seed = 0;
+    bool found = false;
+
+    if (hash == NULL || order == NULL || slot_of == NULL || start == NULL || pilots == NULL)
+        goto done;
+
+    for (uint32_t attempt = 0; attempt < MPHF_SEEDS && !found; attempt++) {
+        seed = string_mix64(0x9e3779b97f4a7c15ull * (attempt + 1));
+        for (uint32_t k = 0; k < n; k++)
+            hash[k] = mphf_hash(keys[k]->data, keys[k]->length, seed);
+
+        found = mphf_search(hash, n, nbuckets, order, start, pilots, slot_of);
+
+        // equal hashes in one bucket never separate: stop on duplicate keys
+        if (!found && attempt == 0) {
+            for (uint32_t b = 0; b < nbuckets; b++)
+                for (uint32_t i = start[b]; i < start[b + 1]; i++)
+                    for (uint32_t j = i + 1; j < start[b + 1]; j++)
+                        if (hash[order[i]] == hash[order[j]] && string_equals(keys[order[i]], keys[order[j]]))
+                            goto done;
+        }
+    }
+
+    if (!found)
+        goto done;
+
+    uint32_t max_pilot = 0;
+    for (uint32_t b = 0; b < nbuckets; b++)
+        if (pilots[b] > max_pilot)
+            max_pilot = pilots[b];
+
+    f = mphf_alloc(n, nbuckets, max_pilot <= UINT8_MAX ? 1 : max_pilot <= UINT16_MAX ? 2 : 4, keys_len);
+    if (f == NULL)
+        goto done;
+
+    f->seed = seed;
+    for (uint32_t b = 0; b < nbuckets; b++)
+        for (uint8_t i = 0; i < f->width; i++)
+            f->pilots[(size_t) b * f->width + i] = (uint8_t) (pilots[b] >> (8 * i));
+
+    for (uint32_t k = 0; k < n; k++)
+        f->ids[slot_of[k]] = k;
+
+    uint32_t off = 0;
+    for (uint32_t s = 0; s < n; s++) {
+        const String key = keys[f->ids[s]];
+        f->offsets[s] = off;
+        memcpy(f->keys + off, key->data, key->length);
+        off += key->length;
+    }
+    f->offsets[n] = off;
+    f->keys[off] = '\0';
+
+done:
+    free(pilots);
+    free(start);
+    free(slot_of);
+    free(order);
+    free(hash);
+    return f;
+}
+
+/**
+ * @fn void string_mphf_free(string_mphf_t *f)
+ * @brief Free function
+ *
+ * @param f Function
+ */
+void string_mphf_free(string_mphf_t *f) {
+    if (f == NULL)
+        return;
+
+    free(f->keys);
+    free(f->offsets);
+    free(f->ids);
+    free(f->pilots);
+    free(f);
+}
+
+/**
+ * @fn uint32_t string_mphf_lookup(const string_mphf_t *f, string_view_t view)
+ * @brief Index of view in the build array: one bucket pilot, one slot, one key compare
+ *
+ * @param f Function
+ * @param view Bytes
+ * @return Index, STR_ERROR if view is not a key
+ */
+uint32_t string_mphf_lookup(const string_mphf_t *f, string_view_t view) {
+    if (f == NULL || view.data == NULL)
+        return STR_ERROR;
+
+    const uint64_t h = mphf_hash(view.data, view.length, f->seed);
+    const uint32_t s = mphf_slot(h, mphf_pilot(f, mphf_bucket(h, f->nbuckets)), f->n);
+
+    if (f->offsets[s + 1] - f->offsets[s] != view.length || memcmp(f->keys + f->offsets[s], view.data, view.length))
+        return STR_ERROR;
+
+    return f->ids[s];
+}
+
+/**
+ * @fn String string_mphf_serialize(const string_mphf_t *f)
+ * @brief Serialize function (little endian, keys included)
+ *
+ * @param f Function
+ * @return Buffered string
+ */
+String string_mphf_serialize(const string_mphf_t *f) {
+    if (f == NULL)
+        return NULL;
+
+    const uint64_t len = 4 + 4 + 4 + 8 + 1 + (uint64_t) f->nbuckets * f->width + (uint64_t) f->n * 8 + 4 + f->offsets[f->n];
+    if (len > UINT32_MAX - 1)
+        return NULL;
+
+    String buf = string_new_uninit(len);
+    if (buf == NULL)
+        return NULL;
+
+    uint8_t *p = (uint8_t*) buf->data;
+    put_u32(p, MPHF_MAGIC);
+    put_u32(p + 4, f->n);
+    put_u32(p + 8, f->nbuckets);
+    put_u32(p + 12, (uint32_t) f->seed);
+    put_u32(p + 16, (uint32_t) (f->seed >> 32));
+    p[20] = f->width;
+    p += 21;
+
+    memcpy(p, f->pilots, (size_t) f->nbuckets * f->width);
+    p += (size_t) f->nbuckets * f->width;
+    for (uint32_t s = 0; s < f->n; s++, p += 4)
+        put_u32(p, f->ids[s]);
+    for (uint32_t s = 0; s <= f->n; s++, p += 4)
+        put_u32(p, f->offsets[s]);
+    memcpy(p, f->keys, f->offsets[f->n]);
+
+    buf->length = len;
+    buf->data[len] = '\0';
+
+    return buf;
+}
+
+/**
+ * @fn string_mphf_t* string_mphf_deserialize(const String buf)
+ * @brief Rebuild function from string_mphf_serialize output
+ *
+ * @param buf Buffered string
+ * @return Function|NULL
+ */
+string_mphf_t* string_mphf_deserialize(const String buf) {
+    if (buf == NULL || buf->length < 21)
+        return NULL;
+
+    const uint8_t *p = (const uint8_t*) buf->data;
+    if (get_u32(p) != MPHF_MAGIC)
+        return NULL;
+
+    const uint32_t n = get_u32(p + 4);
+    const uint32_t nbuckets = get_u32(p + 8);
+    const uint8_t width = p[20];
+    if (n == 0 || nbuckets != (n + MPHF_BUCKET_KEYS - 1) / MPHF_BUCKET_KEYS || (width != 1 && width != 2 && width != 4))
+        return NULL;
+
+    const uint64_t fixed = 21 + (uint64_t) nbuckets * width + (uint64_t) n * 8 + 4;
+    if (buf->length < fixed)
+        return NULL;
+
+    const uint8_t *off = p + fixed - 4 - (uint64_t) n * 4;
+    const uint32_t keys_len = get_u32(off + (uint64_t) n * 4);
+    if (buf->length != fixed + keys_len)
+        return NULL;
+
+    string_mphf_t *f = mphf_alloc(n, nbuckets, width, keys_len);
+    if (f == NULL)
+        return NULL;
+
+    f->seed = get_u64(p + 12);
+    p += 21;
+    memcpy(f->pilots, p, (size_t) nbuckets * width);
+    p += (size_t) nbuckets * width;
+
+    for (uint32_t s = 0; s < n; s++, p += 4)
+        if ((f->ids[s] = get_u32(p)) >= n)
+            goto fail;
+    for (uint32_t s = 0; s <= n; s++, p += 4)
+        if ((f->offsets[s] = get_u32(p)) > keys_len || (s > 0 && f->offsets[s] < f->offsets[s - 1]))
+            goto fail;
+    if (f->offsets[0] != 0)
+        goto fail;
+    memcpy(f->keys, p, keys_len);
+    f->keys[keys_len] = '\0';
+
+    return f;
+
+fail:
+    string_mphf_free(f);
+    return NULL;
+}
+
+/**
+ * @def MPHF_STR
+ * @brief Expand a macro and make it a string literal
+ *
+ */
+#define MPHF_STR_(x) #x
+#define MPHF_STR(x)  MPHF_STR_(x)
+
+/**
+ * @def MPHF_HASH_SRC
+ * @brief Generated lookup code (%1$s: prefix, %2$s: seed literal). Must stay in step with mphf_hash; the
+ *        mixer is string_mix64 with its multipliers taken from strings_internal.h.
+ *
+ */
+#define MPHF_HASH_SRC \
+    "static inline uint64_t %1$s_mix(uint64_t x) {\n" \
+    "    x ^= x >> 30;\n" \
+    "    x *= " MPHF_STR(STRING_MIX64_M1) ";\n" \
+    "    x ^= x >> 27;\n" \
+    "    x *= " MPHF_STR(STRING_MIX64_M2) ";\n" \
+    "    x ^= x >> 31;\n" \
+    "    return x;\n" \
+    "}\n" \
+    "\n" \
+    "static inline uint64_t %1$s_hash(const char *s, size_t len) {\n" \
+    "    const uint8_t *p = (const uint8_t*) s;\n" \
+    "    uint64_t h = %2$s ^ ((uint64_t) len * 0x9e3779b97f4a7c15ull);\n" \
+    "    uint64_t v;\n" \
+    "\n" \
+    "    for (; len >= 8; len -= 8, p += 8) {\n" \
+    "        v = 0;\n" \
+    "        for (int n = 0; n < 8; n++)\n" \
+    "            v |= (uint64_t) p[n] << (8 * n);\n" \
+    "        h = %1$s_mix(h ^ v);\n" \
+    "    }\n" \
+    "\n" \
+    "    v = 0;\n" \
+    "    for (size_t n = 0; n < len; n++)\n" \
+    "        v |= (uint64_t) p[n] << (8 * n);\n" \
+    "\n" \
+    "    return %1$s_mix(h ^ v ^ 0xff);\n" \
+    "}\n" \
+    "\n" \
+    "/* index of s in the build key array, UINT32_MAX if s is not a key */\n" \
+    "uint32_t %1$s_lookup(const char *s, size_t len) {\n" \
+    "    const uint64_t h = %1$s_hash(s, len);\n" \
+    "    const uint32_t b = (uint32_t) ((h >> 32) %% %3$s);\n" \
+    "    const uint32_t slot = (uint32_t) ((h ^ %1$s_mix((uint64_t) %1$s_pilots[b] + 1)) %% %4$s);\n" \
+    "    const uint32_t off = %1$s_offsets[slot];\n" \
+    "\n" \
+    "    if (%1$s_offsets[slot + 1] - off != len || memcmp(%1$s_keys + off, s, len) != 0)\n" \
+    "        return UINT32_MAX;\n" \
+    "\n" \
+    "    return %1$s_ids[slot];\n" \
+    "}\n"
+
+/**
+ * @fn bool gen_append(String *out, const char *fmt, ...)
+ * @brief printf to the end of *out, growing it
+ *
+ */
+static bool gen_append(String *out, const char *fmt, ...) {
+    va_list args;
+
+    va_start(args, fmt);
+    const int len = vsnprintf(NULL, 0, fmt, args);
+    va_end(args);
+
+    if (len < 0 || !string_reserve(out, len))
+        return false;
+
+    va_start(args, fmt);
+    vsnprintf((*out)->data + (*out)->length, (size_t) len + 1, fmt, args);
+    va_end(args);
+
+    return string_commit(*out, len);
+}
+
+/**
+ * @fn bool gen_u32_array(String *out, const char *type, const char *prefix, const char *name, uint32_t count, const string_mphf_t *f, uint32_t (*get)(const string_mphf_t*, uint32_t))
+ * @brief Emit a constant array
+ *
+ */
+static bool gen_u32_array(String *out, const char *type, const char *prefix, const char *name, uint32_t count, const string_mphf_t *f, uint32_t (*get)(const string_mphf_t*, uint32_t)) {
+    bool ok = gen_append(out, "static const %s %s_%s[%u] = {", type, prefix, name, count);
+
+    for (uint32_t i = 0; ok && i < count; i++)
+        ok = gen_append(out, "%s%u%s", (i % 12) ? " " : "\n    ", get(f, i), (i + 1 < count) ? "," : "\n");
+
+    return ok && gen_append(out, "};\n\n");
+}
+
+/**
+ * @fn uint32_t gen_id(const string_mphf_t *f, uint32_t i)
+ * @brief ids accessor for gen_u32_array
+ *
+ */
+static uint32_t gen_id(const string_mphf_t *f, uint32_t i) {
+    return f->ids[i];
+}
+
+/**
+ * @fn uint32_t gen_offset(const string_mphf_t *f, uint32_t i)
+ * @brief offsets accessor for gen_u32_array
+ *
+ */
+static uint32_t gen_offset(const string_mphf_t *f, uint32_t i) {
+    return f->offsets[i];
+}
+
+/**
+ * @fn String string_mphf_codegen(const string_mphf_t *f, const char *prefix)
+ * @brief C source embedding the function: constant tables and uint32_t <prefix>_lookup(const char *s, size_t len)
+ *
+ * @param f Function
+ * @param prefix Identifier prefix
+ * @return Buffered string
+ */
+String string_mphf_codegen(const string_mphf_t *f, const char *prefix) {
+    if (f == NULL || prefix == NULL || *prefix == '\0')
+        return NULL;
+
+    for (const char *c = prefix; *c; c++)
+        if (!(*c == '_' || (*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z') || (c != prefix && *c >= '0' && *c <= '9')))
+            return NULL;
+
+    String out = string_new(4096);
+    if (out == NULL)
+        return NULL;
+
+    static const char *pilot_type[] = { NULL, "uint8_t", "uint16_t", NULL, "uint32_t" };
+    bool ok = gen_append(&out, "/* minimal perfect hash over %u keys, generated by string_mphf_codegen */\n\n"
+            "#include <stddef.h>\n#include <stdint.h>\n#include <string.h>\n\n", f->n);
+
+    ok = ok && gen_u32_array(&out, pilot_type[f->width], prefix, "pilots", f->nbuckets, f, mphf_pilot);
+    ok = ok && gen_u32_array(&out, "uint32_t", prefix, "ids", f->n, f, gen_id);
+    ok = ok && gen_u32_array(&out, "uint32_t", prefix, "offsets", f->n + 1, f, gen_offset);
+
+    // keys as one literal, octal escapes keep trigraphs and hex continuations out
+    ok = ok && gen_append(&out, "static const char %s_keys[] =\n    \"", prefix);
+    for (uint32_t i = 0; ok && i < f->offsets[f->n]; i++) {
+        const unsigned char c = f->keys[i];
+
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || (c != '\0' && strchr(" _-.,:;/+=", c) != NULL))
+            ok = gen_append(&out, "%c", c);
+        else
+            ok = gen_append(&out, "\\%03o", c);
+
+        if (ok && i % 64 == 63 && i + 1 < f->offsets[f->n])
+            ok = gen_append(&out, "\"\n    \"");
+    }
+    ok = ok && gen_append(&out, "\";\n\n");
+
+    char seed[24], nb[16], n[16];
+    snprintf(seed, sizeof(seed), "0x%016llxull", (unsigned long long) f->seed);
+    snprintf(nb, sizeof(nb), "%uu", f->nbuckets);
+    snprintf(n, sizeof(n), "%uu", f->n);
+    ok = ok && gen_append(&out, MPHF_HASH_SRC, prefix, seed, nb, n);
+
+    if (!ok) {
+        free(out);
+        return NULL;
+    }
+
+    return out;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file strings_mphf.h
+ * @brief minimal perfect hash functions over static String key sets
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef STRINGS_MPHF_H_
+#define STRINGS_MPHF_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "strings.h"
+
+/**
+ * @struct string_mphf_s
+ * @brief Minimal perfect hash function (hash and displace, one pilot per bucket) with stored keys
+ *
+ */
+struct string_mphf_s {
+    uint32_t n;        /**< keys (and slots) >**/
+    uint32_t nbuckets; /**< buckets >**/
+    uint64_t seed;     /**< key hash seed >**/
+     uint8_t width;    /**< bytes per pilot (1, 2 or 4) >**/
+     uint8_t *pilots;  /**< pilot of each bucket (little endian) >**/
+    uint32_t *ids;     /**< slot: index of the key in the build array >**/
+    uint32_t *offsets; /**< slot: key bytes are keys[offsets[slot]] .. keys[offsets[slot + 1]] >**/
+        char *keys;    /**< key bytes in slot order >**/
+};
+typedef struct string_mphf_s string_mphf_t; /**< minimal perfect hash type >**/
+
+string_mphf_t* string_mphf_build(const String *keys, uint32_t n);
+          void string_mphf_free(string_mphf_t *f);
+      uint32_t string_mphf_lookup(const string_mphf_t *f, string_view_t view);
+        String string_mphf_serialize(const string_mphf_t *f);
+string_mphf_t* string_mphf_deserialize(const String buf);
+        String string_mphf_codegen(const string_mphf_t *f, const char *prefix);
+
+#endif /* STRINGS_MPHF_H_ */
@@ -0,0 +1,603 @@
+/**
+ * @file strings_pipe.c
+ * @brief fused byte-level transform pipelines
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "strings.h"
+#include "strings_simd.h"
+#include "strings_tr.h"
+#include "strings_pipe.h"
+
+/**
+ * @def PIPE_CHUNK
+ * @brief Input bytes run through all stages at a time (fits in L1)
+ *
+ */
+#define PIPE_CHUNK 4096
+
+/**
+ * @struct pipe_run_s
+ * @brief State of one pipeline execution
+ *
+ */
+struct pipe_run_s {
+    const string_pipe_t *pipe;                            /**< pipeline >**/
+                 String out;                              /**< output (NULL when hashing) >**/
+    string_hash_state_t *hash;                            /**< hash state (NULL when building output) >**/
+                int16_t last[STRING_PIPE_MAX_STAGES];     /**< squeeze: last byte (-1: none). ltrim: 1 once past leading space >**/
+                  char *pending[STRING_PIPE_MAX_STAGES];  /**< rtrim: held white space >**/
+               uint32_t plen[STRING_PIPE_MAX_STAGES];     /**< rtrim: held bytes >**/
+               uint32_t pcap[STRING_PIPE_MAX_STAGES];     /**< rtrim: pending capacity >**/
+                  char *scratch[2];                       /**< chunk buffers (stages ping-pong between them) >**/
+                 size_t scap[2];                          /**< chunk buffer capacities >**/
+                   bool ok;                               /**< no allocation failure >**/
+};
+
+/**
+ * @fn bool is_space(uint8_t c)
+ * @brief ASCII white space (' ', \t, \n, \v, \f, \r)
+ *
+ */
+static inline bool is_space(uint8_t c) {
+    return c == ' ' || (uint8_t) (c - 9) < 5;
+}
+
+/**
+ * @fn void set_add(string_byteset_t *set, uint8_t c)
+ * @brief Add byte to set
+ *
+ */
+static inline void set_add(string_byteset_t *set, uint8_t c) {
+    (c & 0x80 ? set->hi : set->lo)[c & 0x0f] |= (uint8_t) (1 << ((c >> 4) & 7));
+}
+
+/**
+ * @fn void sink_write(struct pipe_run_s *run, const char *data, size_t n)
+ * @brief Deliver bytes to the output String or the hash
+ *
+ */
+static void sink_write(struct pipe_run_s *run, const char *data, size_t n) {
+    if (run->hash != NULL) {
+        string_hash_update(run->hash, data, n);
+        return;
+    }
+
+    if (n > UINT32_MAX || !string_reserve(&run->out, n)) {
+        run->ok = false;
+        return;
+    }
+
+    memcpy(string_spare(run->out, NULL), data, n);
+    string_commit(run->out, n);
+}
+
+/**
+ * @fn bool hold(struct pipe_run_s *run, uint8_t stage, const char *data, size_t n, bool append)
+ * @brief Set or extend the white space held back by a right trim stage
+ *
+ */
+static bool hold(struct pipe_run_s *run, uint8_t stage, const char *data, size_t n, bool append) {
+    const size_t base = append ? run->plen[stage] : 0;
+
+    if (n == 0) {
+        run->plen[stage] = base;
+        return true;
+    }
+
+    if (base + n > UINT32_MAX) {
+        run->ok = false;
+        return false;
+    }
+
+    if (base + n > run->pcap[stage]) {
+        const size_t cap = (base + n) * 2 < UINT32_MAX ? (base + n) * 2 : UINT32_MAX;
+        char *tmp = realloc(run->pending[stage], cap);
+        if (tmp == NULL) {
+            run->ok = false;
+            return false;
+        }
+        run->pending[stage] = tmp;
+        run->pcap[stage] = cap;
+    }
+
+    memcpy(run->pending[stage] + base, data, n);
+    run->plen[stage] = base + n;
+
+    return true;
+}
+
+/**
+ * @fn char* scratch(struct pipe_run_s *run, int idx, size_t size)
+ * @brief Scratch buffer idx with at least size bytes
+ *
+ */
+static char* scratch(struct pipe_run_s *run, int idx, size_t size) {
+    if (size > run->scap[idx]) {
+        char *tmp = realloc(run->scratch[idx], size);
+        if (tmp == NULL) {
+            run->ok = false;
+            return NULL;
+        }
+        run->scratch[idx] = tmp;
+        run->scap[idx] = size;
+    }
+
+    return run->scratch[idx];
+}
+
+/**
+ * @fn size_t escape_chunk(char *out, const char *in, size_t n)
+ * @brief C escape n bytes into out (room for 4 * n)
+ *
+ */
+static size_t escape_chunk(char *out, const char *in, size_t n) {
+    const char *hex = "0123456789abcdef";
+    char *o = out;
+
+    for (size_t i = 0; i < n; i++) {
+        const uint8_t c = (uint8_t) in[i];
+
+        if (c >= 0x20 && c < 0x7f && c != '\\' && c != '"') {
+            *o++ = (char) c;
+            continue;
+        }
+
+        *o++ = '\\';
+        switch (c) {
+            case '\n':
+                *o++ = 'n';
+                break;
+            case '\t':
+                *o++ = 't';
+                break;
+            case '\r':
+                *o++ = 'r';
+                break;
+            case '\\':
+            case '"':
+                *o++ = (char) c;
+                break;
+            default:
+                *o++ = 'x';
+                *o++ = hex[c >> 4];
+                *o++ = hex[c & 15];
+        }
+    }
+
+    return o - out;
+}
+
+/**
+ * @fn void run_chunk(struct pipe_run_s *run, uint8_t first, const char *in, size_t n)
+ * @brief Run one input chunk through the stages from first (the data stays cache resident) and deliver it
+ *
+ */
+static void run_chunk(struct pipe_run_s *run, uint8_t first, const char *in, size_t n) {
+    const string_pipe_t *pipe = run->pipe;
+    const char *cur = in;
+    int owned = -1; // scratch buffer holding cur (-1: input)
+
+    for (uint8_t i = first; i < pipe->count && n > 0; i++) {
+        const string_pipe_stage_t *st = &pipe->stages[i];
+        const int to = owned < 0 ? 0 : owned;
+        char *out;
+
+        switch (st->kind) {
+            case PIPE_MAP:
+                if ((out = scratch(run, to, n)) == NULL)
+                    return;
+                if (!st->deletes)
+                    string_simd->translate(out, cur, n, st->map);
+                else {
+                    size_t k = 0;
+                    for (size_t j = 0; j < n; j++) {
+                        const uint8_t c = (uint8_t) cur[j];
+                        out[k] = (char) st->map[c];
+                        k += !string_byteset_has(&st->set, c);
+                    }
+                    n = k;
+                }
+                cur = out;
+                owned = to;
+                break;
+
+            case PIPE_LTRIM:
+                if (!run->last[i]) {
+                    const size_t skip = string_simd->skip_space(cur, n);
+                    cur += skip;
+                    n -= skip;
+                    run->last[i] = n > 0;
+                }
+                break;
+
+            case PIPE_RTRIM: {
+                const size_t keep = string_simd->rskip_space(cur, n);
+                const uint32_t held = run->plen[i];
+
+                // trailing white space is held back until more bytes follow it
+                if (keep == 0) {
+                    hold(run, i, cur, n, true);
+                    n = 0;
+                    break;
+                }
+
+                if (held > 0) {
+                    const int other = owned < 0 ? 0 : owned ^ 1;
+                    if ((out = scratch(run, other, held + keep)) == NULL)
+                        return;
+                    memcpy(out, run->pending[i], held);
+                    memcpy(out + held, cur, keep);
+                    if (!hold(run, i, cur + keep, n - keep, false))
+                        return;
+                    cur = out;
+                    n = held + keep;
+                    owned = other;
+                } else {
+                    if (!hold(run, i, cur + keep, n - keep, false))
+                        return;
+                    n = keep;
+                }
+                break;
+            }
+
+            case PIPE_SQUEEZE: {
+                if ((out = scratch(run, to, n)) == NULL)
+                    return;
+                size_t k = 0;
+                int last = run->last[i];
+                for (size_t j = 0; j < n; j++) {
+                    const uint8_t c = (uint8_t) cur[j];
+                    out[k] = (char) c;
+                    k += !(c == last && string_byteset_has(&st->set, c));
+                    last = c;
+                }
+                run->last[i] = last;
+                n = k;
+                cur = out;
+                owned = to;
+                break;
+            }
+
+            case PIPE_ESCAPE: {
+                const int other = owned < 0 ? 0 : owned ^ 1;
+                if (n > SIZE_MAX / 4 || (out = scratch(run, other, 4 * n)) == NULL)
+                    return;
+                n = escape_chunk(out, cur, n);
+                cur = out;
+                owned = other;
+                break;
+            }
+        }
+    }
+
+    if (n > 0)
+        sink_write(run, cur, n);
+}
+
+/**
+ * @fn bool pipe_exec(const string_pipe_t *pipe, const String buf, struct pipe_run_s *run)
+ * @brief Run the pipeline over buf into run's sink in a single pass, one cache sized chunk at a time
+ *
+ */
+static bool pipe_exec(const string_pipe_t *pipe, const String buf, struct pipe_run_s *run) {
+    const char *s = buf->data;
+    size_t n = buf->length;
+    uint8_t first = 0;
+
+    run->pipe = pipe;
+    run->ok = true;
+    for (int i = 0; i < STRING_PIPE_MAX_STAGES; i++) {
+        run->last[i] = (i < pipe->count && pipe->stages[i].kind == PIPE_SQUEEZE) ? -1 : 0;
+        run->pending[i] = NULL;
+        run->plen[i] = run->pcap[i] = 0;
+    }
+    run->scratch[0] = run->scratch[1] = NULL;
+    run->scap[0] = run->scap[1] = 0;
+
+    // leading trims apply to the whole input
+    for (; first < pipe->count; first++) {
+        const uint8_t kind = pipe->stages[first].kind;
+        if (kind == PIPE_LTRIM) {
+            const size_t skip = string_simd->skip_space(s, n);
+            s += skip;
+            n -= skip;
+        } else if (kind == PIPE_RTRIM)
+            n = string_simd->rskip_space(s, n);
+        else
+            break;
+    }
+
+    while (n > 0 && run->ok) {
+        const size_t k = n < PIPE_CHUNK ? n : PIPE_CHUNK;
+        run_chunk(run, first, s, k);
+        s += k;
+        n -= k;
+    }
+
+    for (int i = 0; i < STRING_PIPE_MAX_STAGES; i++)
+        free(run->pending[i]);
+    free(run->scratch[0]);
+    free(run->scratch[1]);
+
+    return run->ok;
+}
+
+/**
+ * @fn string_pipe_stage_t* map_stage(string_pipe_t *pipe)
+ * @brief Last stage when it is a map stage (new map stages fuse into it), else a new identity map stage
+ *
+ */
+static string_pipe_stage_t* map_stage(string_pipe_t *pipe) {
+    if (pipe->count > 0 && pipe->stages[pipe->count - 1].kind == PIPE_MAP)
+        return &pipe->stages[pipe->count - 1];
+
+    if (pipe->count == STRING_PIPE_MAX_STAGES)
+        return NULL;
+
+    string_pipe_stage_t *st = &pipe->stages[pipe->count++];
+    memset(st, 0, sizeof(*st));
+    st->kind = PIPE_MAP;
+    for (int c = 0; c < 256; c++)
+        st->map[c] = (uint8_t) c;
+
+    return st;
+}
+
+/**
+ * @fn bool add_stage(string_pipe_t *pipe, uint8_t kind)
+ * @brief Append a stage without table
+ *
+ */
+static bool add_stage(string_pipe_t *pipe, uint8_t kind) {
+    if (pipe == NULL || pipe->count == STRING_PIPE_MAX_STAGES)
+        return false;
+
+    string_pipe_stage_t *st = &pipe->stages[pipe->count++];
+    memset(st, 0, sizeof(*st));
+    st->kind = kind;
+
+    return true;
+}
+
+/**
+ * @fn string_pipe_t* string_pipe_new(void)
+ * @brief New empty pipeline (identity)
+ *
+ * @return Pipeline
+ */
+string_pipe_t* string_pipe_new(void) {
+    return calloc(1, sizeof(string_pipe_t));
+}
+
+/**
+ * @fn void string_pipe_free(string_pipe_t *pipe)
+ * @brief Free pipeline
+ *
+ * @param pipe Pipeline
+ */
+void string_pipe_free(string_pipe_t *pipe) {
+    free(pipe);
+}
+
+/**
+ * @fn bool string_pipe_ltrim(string_pipe_t *pipe)
+ * @brief Append left trim stage
+ *
+ * @param pipe Pipeline
+ * @return Boolean (false: too many stages)
+ */
+bool string_pipe_ltrim(string_pipe_t *pipe) {
+    return add_stage(pipe, PIPE_LTRIM);
+}
+
+/**
+ * @fn bool string_pipe_rtrim(string_pipe_t *pipe)
+ * @brief Append right trim stage
+ *
+ * @param pipe Pipeline
+ * @return Boolean (false: too many stages)
+ */
+bool string_pipe_rtrim(string_pipe_t *pipe) {
+    return add_stage(pipe, PIPE_RTRIM);
+}
+
+/**
+ * @fn bool string_pipe_trim(string_pipe_t *pipe)
+ * @brief Append trim stages
+ *
+ * @param pipe Pipeline
+ * @return Boolean (false: too many stages)
+ */
+bool string_pipe_trim(string_pipe_t *pipe) {
+    if (pipe == NULL || pipe->count + 2 > STRING_PIPE_MAX_STAGES)
+        return false;
+
+    return add_stage(pipe, PIPE_LTRIM) && add_stage(pipe, PIPE_RTRIM);
+}
+
+/**
+ * @fn bool string_pipe_upper(string_pipe_t *pipe)
+ * @brief Append ASCII upper case stage
+ *
+ * @param pipe Pipeline
+ * @return Boolean (false: too many stages)
+ */
+bool string_pipe_upper(string_pipe_t *pipe) {
+    string_pipe_stage_t *st = pipe == NULL ? NULL : map_stage(pipe);
+    if (st == NULL)
+        return false;
+
+    for (int c = 0; c < 256; c++)
+        if (st->map[c] >= 'a' && st->map[c] <= 'z')
+            st->map[c] -= 'a' - 'A';
+
+    return true;
+}
+
+/**
+ * @fn bool string_pipe_lower(string_pipe_t *pipe)
+ * @brief Append ASCII lower case stage
+ *
+ * @param pipe Pipeline
+ * @return Boolean (false: too many stages)
+ */
+bool string_pipe_lower(string_pipe_t *pipe) {
+    string_pipe_stage_t *st = pipe == NULL ? NULL : map_stage(pipe);
+    if (st == NULL)
+        return false;
+
+    for (int c = 0; c < 256; c++)
+        if (st->map[c] >= 'A' && st->map[c] <= 'Z')
+            st->map[c] += 'a' - 'A';
+
+    return true;
+}
+
+/**
+ * @fn bool string_pipe_tr(string_pipe_t *pipe, const string_tr_t *tr)
+ * @brief Append compiled translation (delete, translate, squeeze as string_tr)
+ *
+ * @param pipe Pipeline
+ * @param tr Compiled translation
+ * @return Boolean (false: too many stages)
+ */
+bool string_pipe_tr(string_pipe_t *pipe, const string_tr_t *tr) {
+    if (pipe == NULL || tr == NULL)
+        return false;
+
+    if (tr->translate || tr->deletes) {
+        string_pipe_stage_t *st = map_stage(pipe);
+        if (st == NULL)
+            return false;
+
+        for (int c = 0; c < 256; c++) {
+            if (tr->deletes && string_byteset_has(&tr->del, st->map[c])) {
+                set_add(&st->set, (uint8_t) c);
+                st->deletes = true;
+            }
+            st->map[c] = tr->map[st->map[c]];
+        }
+    }
+
+    if (tr->squeezes) {
+        if (!add_stage(pipe, PIPE_SQUEEZE))
+            return false;
+        pipe->stages[pipe->count - 1].set = tr->squeeze;
+    }
+
+    return true;
+}
+
+/**
+ * @fn bool string_pipe_squeeze(string_pipe_t *pipe, const char *chars)
+ * @brief Append squeeze stage (runs of a byte in chars collapse to one)
+ *
+ * @param pipe Pipeline
+ * @param chars Bytes (string_tr_compile set syntax)
+ * @return Boolean (false: bad set or too many stages)
+ */
+bool string_pipe_squeeze(string_pipe_t *pipe, const char *chars) {
+    string_tr_t tr;
+
+    if (pipe == NULL || chars == NULL || !string_tr_compile(&tr, NULL, NULL, NULL, chars))
+        return false;
+
+    return string_pipe_tr(pipe, &tr);
+}
+
+/**
+ * @fn bool string_pipe_escape(string_pipe_t *pipe)
+ * @brief Append C escape stage
+ *
+ * @param pipe Pipeline
+ * @return Boolean (false: too many stages)
+ */
+bool string_pipe_escape(string_pipe_t *pipe) {
+    return add_stage(pipe, PIPE_ESCAPE);
+}
+
+/**
+ * @fn String string_pipe_run(const string_pipe_t *pipe, const String buf)
+ * @brief Run pipeline over buf in one pass
+ *
+ * @param pipe Pipeline
+ * @param buf Buffered string
+ * @return Buffered string
+ */
+String string_pipe_run(const string_pipe_t *pipe, const String buf) {
+    struct pipe_run_s run;
+
+    if (pipe == NULL || buf == NULL)
+        return NULL;
+
+    run.hash = NULL;
+    run.out = string_new_uninit(buf->length);
+    if (run.out == NULL)
+        return NULL;
+
+    if (!pipe_exec(pipe, buf, &run)) {
+        free(run.out);
+        return NULL;
+    }
+
+    if (run.out->capacity > run.out->length)
+        string_resize(&run.out, run.out->length);
+
+    return run.out;
+}
+
+/**
+ * @fn string_hash_t string_pipe_hash(const string_pipe_t *pipe, const String buf, uint8_t version, uint8_t key[16])
+ * @brief Hash of the pipeline output without building it (equals string_hash of string_pipe_run)
+ *
+ * @param pipe Pipeline
+ * @param buf Buffered string
+ * @param version Hash version
+ * @param key Key
+ * @return Hash (outlen 0 on error)
+ */
+string_hash_t string_pipe_hash(const string_pipe_t *pipe, const String buf, uint8_t version, uint8_t key[16]) {
+    struct pipe_run_s run;
+    string_hash_state_t hash;
+    string_hash_t result;
+
+    result.outlen = 0;
+    if (pipe == NULL || buf == NULL || !string_hash_init(&hash, version, key))
+        return result;
+
+    run.hash = &hash;
+    run.out = NULL;
+    if (!pipe_exec(pipe, buf, &run))
+        return result;
+
+    return string_hash_final(&hash);
+}
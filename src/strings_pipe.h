@@ -0,0 +1,97 @@
+/**
+ * @file strings_pipe.h
+ * @brief fused byte-level transform pipelines
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef STRINGS_PIPE_H_
+#define STRINGS_PIPE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "strings.h"
+#include "strings_tr.h"
+
+/**
+ * @def STRING_PIPE_MAX_STAGES
+ * @brief Maximum compiled stages of a pipeline (adjacent map stages count as one)
+ *
+ */
+#define STRING_PIPE_MAX_STAGES 16
+
+/**
+ * @enum STRING_PIPE_STAGE
+ * @brief Compiled stage kind
+ *
+ */
+enum STRING_PIPE_STAGE {
+    PIPE_MAP,     /**< delete then translate bytes (case map, tr) >**/
+    PIPE_LTRIM,   /**< drop leading white space >**/
+    PIPE_RTRIM,   /**< drop trailing white space >**/
+    PIPE_SQUEEZE, /**< collapse runs of set bytes >**/
+    PIPE_ESCAPE   /**< C escape (\\n \\t \\r \\\\ \\" \\xHH) >**/
+};
+
+/**
+ * @struct string_pipe_stage_s
+ * @brief Compiled stage
+ *
+ */
+struct string_pipe_stage_s {
+             uint8_t kind;     /**< enum STRING_PIPE_STAGE >**/
+             uint8_t map[256]; /**< PIPE_MAP: translation table >**/
+    string_byteset_t set;      /**< PIPE_MAP: deleted bytes. PIPE_SQUEEZE: squeezed bytes >**/
+                bool deletes;  /**< PIPE_MAP: set is not empty >**/
+};
+typedef struct string_pipe_stage_s string_pipe_stage_t; /**< compiled stage type >**/
+
+/**
+ * @struct string_pipe_s
+ * @brief Pipeline of byte-level stages run fused in one pass
+ *
+ */
+struct string_pipe_s {
+    string_pipe_stage_t stages[STRING_PIPE_MAX_STAGES]; /**< stages in order >**/
+                uint8_t count;                          /**< number of stages >**/
+};
+typedef struct string_pipe_s string_pipe_t; /**< pipeline type >**/
+
+string_pipe_t* string_pipe_new(void);
+          void string_pipe_free(string_pipe_t *pipe);
+          bool string_pipe_ltrim(string_pipe_t *pipe);
+          bool string_pipe_rtrim(string_pipe_t *pipe);
+          bool string_pipe_trim(string_pipe_t *pipe);
+          bool string_pipe_upper(string_pipe_t *pipe);
+          bool string_pipe_lower(string_pipe_t *pipe);
+          bool string_pipe_tr(string_pipe_t *pipe, const string_tr_t *tr);
+          bool string_pipe_squeeze(string_pipe_t *pipe, const char *chars);
+          bool string_pipe_escape(string_pipe_t *pipe);
+        String string_pipe_run(const string_pipe_t *pipe, const String buf);
+ string_hash_t string_pipe_hash(const string_pipe_t *pipe, const String buf, uint8_t version, uint8_t key[16]);
+
+#endif /* STRINGS_PIPE_H_ */
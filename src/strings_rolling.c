@@ -0,0 +1,744 @@
+/**
+ * @file strings_rolling.c
+ * @brief rolling hashes, multi-pattern search and content-defined chunking
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "strings.h"
+#include "strings_simd.h"
+#include "strings_rolling.h"
+
+/**
+ * @def RK_BASE
+ * @brief rabin-karp polynomial base (odd)
+ *
+ */
+#define RK_BASE UINT64_C(0x100000001b3)
+
+/**
+ * @def RK_NONE
+ * @brief end of bucket chain
+ *
+ */
+#define RK_NONE UINT32_MAX
+
+/**
+ * @var gear
+ * @brief random byte table of buzhash and gear hash
+ *
+ */
+static const uint64_t gear[256] = {
+    UINT64_C(0xfbfd33b4b6e4d3f7), UINT64_C(0xe32b9bc4598b0c68), UINT64_C(0x272a85352b21bfcf), UINT64_C(0xac591be38eacdfe9),
+    UINT64_C(0xa2aad7f99ef86ee7), UINT64_C(0x09e2f0ccc942092d), UINT64_C(0x9027ae202ac1bc2e), UINT64_C(0x4c54f5d4f16d29e5),
+    UINT64_C(0x81158102e8218aca), UINT64_C(0x09b273e7a1fb9e9b), UINT64_C(0xf435ad3a80eedeb9), UINT64_C(0x278c279483f12332),
+    UINT64_C(0x451064feda1a4f21), UINT64_C(0x665567138caeb6e3), UINT64_C(0xf6636950b7117403), UINT64_C(0x144651fa83820246),
+    UINT64_C(0x372ed99018c37e0a), UINT64_C(0xd2e68d7c6d8ceba4), UINT64_C(0x61363f5af069ff39), UINT64_C(0x813b741eec48b80a),
+    UINT64_C(0xa61aa4a8cde732b6), UINT64_C(0x99e1a50cd567365f), UINT64_C(0x8609619f5a71013e), UINT64_C(0x8e42d6c9fadac95d),
+    UINT64_C(0xaf217dc34650cf44), UINT64_C(0x68e816c687bb74b1), UINT64_C(0x2785902fb927d651), UINT64_C(0x4dca11d52d56b562),
+    UINT64_C(0x045e9bae2b6a0fac), UINT64_C(0x588c0bd814245422), UINT64_C(0x0522c32508c89e61), UINT64_C(0x11fec785f1ec0b28),
+    UINT64_C(0x63f512e43a92fc12), UINT64_C(0x202d0b3c7b6707f9), UINT64_C(0x094a74149d4910ce), UINT64_C(0xc05a908d4c4d6073),
+    UINT64_C(0xb87eb6cb32df03bd), UINT64_C(0x89def6bb383bb967), UINT64_C(0x0390d561ca352a0b), UINT64_C(0x7ae42ea6bd0c474d),
+    UINT64_C(0x516c05b346da7948), UINT64_C(0xebafca2fed52338e), UINT64_C(0x012f56542e0809a5), UINT64_C(0xe82348edce0cab22),
+    UINT64_C(0x319357a0dff464ff), UINT64_C(0xa8a35a6f65a85c90), UINT64_C(0x343ef0611320fe3c), UINT64_C(0x14abbf88b693a65a),
+    UINT64_C(0x169a314427bb40dc), UINT64_C(0x6d7022d5b3eefef0), UINT64_C(0xbbd45d568363cef1), UINT64_C(0xce40f02a54f84313),
+    UINT64_C(0x569d302b08e84847), UINT64_C(0x3bb089d5d6ca9518), UINT64_C(0x92da902abb10377c), UINT64_C(0x73efb6f29069fdd2),
+    UINT64_C(0xae8e4fa8f067a9e9), UINT64_C(0xadaa406e0382f2c1), UINT64_C(0x8ba41c716244af84), UINT64_C(0xf9fd6af54b1b7f8d),
+    UINT64_C(0xc9b4115ed1366c8f), UINT64_C(0x25256ed6cf120e22), UINT64_C(0x26a4b4c07c1297aa), UINT64_C(0x4e34e9d59dfacadf),
+    UINT64_C(0x14433ccaf07ce5cd), UINT64_C(0x081f5cf6a82f634d), UINT64_C(0xc136d7e687f7f31f), UINT64_C(0x13fdb75aa5b72d19),
+    UINT64_C(0xc78bc9e14ae49b3f), UINT64_C(0xfd0943999fa15c7e), UINT64_C(0x8db2cf18f09eb253), UINT64_C(0x5f8492c2e02f6b21),
+    UINT64_C(0x377b6605d09f8842), UINT64_C(0x52c20dfee141187c), UINT64_C(0x3f6266be22ea796d), UINT64_C(0xc16d923a878e7603),
+    UINT64_C(0x1083eefb600c07d4), UINT64_C(0x765ce2da1577f16c), UINT64_C(0x8901ba3516bf423d), UINT64_C(0x672569b989a117af),
+    UINT64_C(0x682127cd87fa7f44), UINT64_C(0x3e0d5df983f28015), UINT64_C(0xcf14e97e83f7e2a4), UINT64_C(0x706f98e695a0a52d),
+    UINT64_C(0x2bb9ad96a24acba8), UINT64_C(0x923c4382370372b9), UINT64_C(0x250e78f2f4930df1), UINT64_C(0x03489867b9c8d388),
+    UINT64_C(0x91fbeded1f447a55), UINT64_C(0x2aad84589927ed32), UINT64_C(0xe302197d2d5b02f3), UINT64_C(0x1eca97df284715f6),
+    UINT64_C(0xf769398bfebed3ff), UINT64_C(0x31f88f562d0b938a), UINT64_C(0x9055780266e17ae5), UINT64_C(0x00063f8f8b7e8b86),
+    UINT64_C(0x9b09cceff8029d37), UINT64_C(0xeb80a6751423fe85), UINT64_C(0xc016c03c64484ec2), UINT64_C(0xafc4defc35e29fa4),
+    UINT64_C(0x6abcf4121e12ad94), UINT64_C(0x461ca9ea3cbf5a66), UINT64_C(0x94b667213714dd9d), UINT64_C(0x8b0d2334605b0483),
+    UINT64_C(0x8b8bde12101f073d), UINT64_C(0xd638b4ed6858ea5e), UINT64_C(0x1ca4fc7f761f8112), UINT64_C(0xa624c1e3e9a78a2f),
+    UINT64_C(0x0841e3df49ca2754), UINT64_C(0xd3e50e63b5c59963), UINT64_C(0x4eadb26b1811d1db), UINT64_C(0xcd32b6bbd545636e),
+    UINT64_C(0xa72f2bacda68c6a2), UINT64_C(0x36173d53b4ca9bec), UINT64_C(0x8525e3bcc3f3a133), UINT64_C(0x9f2e2b139c524003),
+    UINT64_C(0x8c99f807349b9bd1), UINT64_C(0x4e2f708c8554d42f), UINT64_C(0xda7895ee2b757db7), UINT64_C(0xd852deb89b1fc748),
+    UINT64_C(0xad7bd0c6fa4aca68), UINT64_C(0x6e0e73e3287a0de9), UINT64_C(0x284d9dd06d367319), UINT64_C(0xba836163a2f00f6c),
+    UINT64_C(0x8d621ac99656c3da), UINT64_C(0x3ff5271b440bec2c), UINT64_C(0x861f8adaf0f8dea2), UINT64_C(0x27961e1a92865217),
+    UINT64_C(0xf102e2ece4b62879), UINT64_C(0xaa66885254752a64), UINT64_C(0x7d97e03c69467585), UINT64_C(0x8a6e6521dc3820aa),
+    UINT64_C(0xa3dcd8e482661d97), UINT64_C(0x0883b8b94b826bac), UINT64_C(0x06dc81d65033cfcf), UINT64_C(0xcdcca7513808e46f),
+    UINT64_C(0x194b5a2900dbc39b), UINT64_C(0xa10eccf7527bcd50), UINT64_C(0xa02f449df86aaacd), UINT64_C(0x277207db64e3d6a3),
+    UINT64_C(0x765c9f72143c4b65), UINT64_C(0xba0282b2f82e0a2f), UINT64_C(0x8acd1510bb322aa6), UINT64_C(0xa602c90c455a8a3b),
+    UINT64_C(0xa26256d1ac604d1f), UINT64_C(0xa22859034507f2dc), UINT64_C(0x8525c2adec285c96), UINT64_C(0xa92d9f7f446710be),
+    UINT64_C(0xab6a309ad797e307), UINT64_C(0x139a17c81816e3c5), UINT64_C(0x92eaa6cc6f87b6cb), UINT64_C(0xc9aeb9a346f91229),
+    UINT64_C(0x4d0b6c4fdf61061e), UINT64_C(0x646f958114cb581a), UINT64_C(0xea52789f2795d39c), UINT64_C(0x011bea72f05842c6),
+    UINT64_C(0x98198d7f6049f913), UINT64_C(0x6a8f1662f28fe4b3), UINT64_C(0x934621b93b698c6e), UINT64_C(0xeedef69fd82f83cf),
+    UINT64_C(0x2e950a1c07a84931), UINT64_C(0x09d3c921439849ee), UINT64_C(0x5177fcb33020965a), UINT64_C(0xbc3ada1684487582),
+    UINT64_C(0x707e653e935beb6b), UINT64_C(0x8c6648ee07d02dce), UINT64_C(0x9d777045ea6fe81f), UINT64_C(0xe266bfe1972f1df7),
+    UINT64_C(0xec6985fbdd482a53), UINT64_C(0x2525564bf74578ff), UINT64_C(0xac9e98b9fd224e54), UINT64_C(0x5ea1bc15b557aa93),
+    UINT64_C(0x608c50677839ab91), UINT64_C(0x2c5ff9e17b633bf7), UINT64_C(0x5775bc9eeb0b3be9), UINT64_C(0xfc16e12fc6b96f75),
+    UINT64_C(0x4bfe92d09e47b5a5), UINT64_C(0xfe11dbae9c7d3663), UINT64_C(0x0626948b1f6ce72b), UINT64_C(0x1cb00eee75a1e205),
+    UINT64_C(0x5d797ff00d9ee780), UINT64_C(0x8119fe019c8c1054), UINT64_C(0xf169f2d736e012c4), UINT64_C(0x637c57f209aa01f4),
+    UINT64_C(0x6020a1d13ac274a0), UINT64_C(0x54823e1c029a5ce9), UINT64_C(0x301d706982cf17ea), UINT64_C(0x92717476a090ed6d),
+    UINT64_C(0x0474c830abb06a37), UINT64_C(0x573151660f3bf336), UINT64_C(0x94b84da4b602a788), UINT64_C(0x5e46e17a2e52e723),
+    UINT64_C(0xd91dad37c1ca754c), UINT64_C(0x52fdd18dc60449fb), UINT64_C(0x60221480b96082c9), UINT64_C(0xcb7e355130ba65d5),
+    UINT64_C(0x7805ac57a0cd3970), UINT64_C(0x5402744451c6d1ca), UINT64_C(0x528ba793b6126c97), UINT64_C(0x4d006b97fe0a20c4),
+    UINT64_C(0xed465ff809dd3576), UINT64_C(0xd504081a8df73243), UINT64_C(0x8bd8f5f52797dc3a), UINT64_C(0xd66247d35681c4d5),
+    UINT64_C(0xdf1a8eef0f57a138), UINT64_C(0x208f36ebc7cffa55), UINT64_C(0xbd1e22d5de8ee967), UINT64_C(0x3d656c17ab57269f),
+    UINT64_C(0x4e574bb00a1f8768), UINT64_C(0x7f39f01daf990024), UINT64_C(0x9cd11de229fc52b6), UINT64_C(0xc933e1c31492ea10),
+    UINT64_C(0xdee0aaeb5586dcff), UINT64_C(0xba9b1e06aa2d4455), UINT64_C(0xfacb4c54b8bf7565), UINT64_C(0x0560179c7aa8716b),
+    UINT64_C(0x2a1d42040a10796c), UINT64_C(0xef2d22882e9456df), UINT64_C(0x407055bb8147fa3a), UINT64_C(0x417024433db99b83),
+    UINT64_C(0x4111fc98b35b6824), UINT64_C(0x736423514d22d53d), UINT64_C(0xf3039c43d89d5c41), UINT64_C(0x4197edf9156eac87),
+    UINT64_C(0x3fb86838c94e4dc9), UINT64_C(0xe407eec5bdaf2dea), UINT64_C(0x42a302be88ad6457), UINT64_C(0x789944e7240c723f),
+    UINT64_C(0xe2ca04b892d037fe), UINT64_C(0x7a32d98639efc0a0), UINT64_C(0x65a91d972e2af3d8), UINT64_C(0x629bdf12e0a38176),
+    UINT64_C(0x9d9debf7ce55730a), UINT64_C(0x42d6e30fa101d564), UINT64_C(0x4dbbe98991f0da4e), UINT64_C(0x6ff3d9c8603ebd11),
+    UINT64_C(0xcd4748d8394d828b), UINT64_C(0xe113550d385cce1a), UINT64_C(0x63c3fa49ce210fee), UINT64_C(0x2f65cc8d7a21aa98),
+    UINT64_C(0x9ca45880e5b17a36), UINT64_C(0xcc9f5eb2fd458833), UINT64_C(0x29e4f09493f18864), UINT64_C(0xcaa09a626d4a0629),
+    UINT64_C(0x0062d286e5dbcbed), UINT64_C(0x5b137c293e6cca2b), UINT64_C(0x335ca22282deaf1d), UINT64_C(0x860a07919deca86e),
+    UINT64_C(0xfb6eca7f187a109d), UINT64_C(0x6431de729a5a33bf), UINT64_C(0x351cc538a976ede6), UINT64_C(0x63e8177b81bdd572),
+    UINT64_C(0xa33efbe21ea487da), UINT64_C(0x49f1ae3b4a834ae7), UINT64_C(0xe2dcaf31c4128c38), UINT64_C(0x25733612ae064e09)
+};
+
+/**
+ * @fn uint64_t rotl64(uint64_t v, uint32_t r)
+ * @brief Rotate left
+ *
+ */
+static inline uint64_t rotl64(uint64_t v, uint32_t r) {
+    r &= 63;
+
+    return r ? (v << r) | (v >> (64 - r)) : v;
+}
+
+/**
+ * @fn uint64_t rk_pow(uint32_t window)
+ * @brief base^(window-1)
+ *
+ */
+static uint64_t rk_pow(uint32_t window) {
+    uint64_t pow = 1;
+    for (uint32_t n = 1; n < window; n++)
+        pow *= RK_BASE;
+
+    return pow;
+}
+
+/**
+ * @fn uint8_t rk_byte(uint8_t c, bool nocase)
+ * @brief Byte as hashed (ASCII lower case if nocase)
+ *
+ */
+static inline uint8_t rk_byte(uint8_t c, bool nocase) {
+    return (nocase && (uint8_t) (c - 'A') < 26) ? c | 0x20 : c;
+}
+
+/**
+ * @fn uint64_t rk_hash(const char *data, uint32_t len, bool nocase)
+ * @brief Rabin-Karp hash of bytes
+ *
+ */
+static inline uint64_t rk_hash(const char *data, uint32_t len, bool nocase) {
+    uint64_t hash = 0;
+    for (uint32_t n = 0; n < len; n++)
+        hash = hash * RK_BASE + rk_byte(data[n], nocase);
+
+    return hash;
+}
+
+/**
+ * @fn bool string_rolling_init(string_rolling_t *rh, uint8_t type, uint32_t window)
+ * @brief Initialize rolling hash
+ *
+ * @param rh Rolling hash
+ * @param type enum STRING_ROLLING_TYPE
+ * @param window Window length
+ * @return Boolean (false: bad arguments)
+ */
+bool string_rolling_init(string_rolling_t *rh, uint8_t type, uint32_t window) {
+    if (rh == NULL || window == 0 || type > ROLLING_BUZHASH)
+        return false;
+
+    rh->type = type;
+    rh->window = window;
+    rh->hash = 0;
+    rh->pow = rk_pow(window);
+
+    return true;
+}
+
+/**
+ * @fn uint64_t string_rolling_start(string_rolling_t *rh, const char *data)
+ * @brief Hash the first window
+ *
+ * @param rh Rolling hash
+ * @param data At least window bytes
+ * @return Hash
+ */
+uint64_t string_rolling_start(string_rolling_t *rh, const char *data) {
+    if (rh == NULL || data == NULL)
+        return 0;
+
+    if (rh->type == ROLLING_RABIN_KARP) {
+        rh->hash = rk_hash(data, rh->window, false);
+    } else {
+        rh->hash = 0;
+        for (uint32_t n = 0; n < rh->window; n++)
+            rh->hash = rotl64(rh->hash, 1) ^ gear[(uint8_t) data[n]];
+    }
+
+    return rh->hash;
+}
+
+/**
+ * @fn uint64_t string_rolling_roll(string_rolling_t *rh, uint8_t out, uint8_t in)
+ * @brief Slide window one byte
+ *
+ * @param rh Rolling hash
+ * @param out Byte leaving the window
+ * @param in Byte entering the window
+ * @return Hash
+ */
+uint64_t string_rolling_roll(string_rolling_t *rh, uint8_t out, uint8_t in) {
+    if (rh == NULL)
+        return 0;
+
+    if (rh->type == ROLLING_RABIN_KARP)
+        rh->hash = (rh->hash - out * rh->pow) * RK_BASE + in;
+    else
+        rh->hash = rotl64(rh->hash, 1) ^ rotl64(gear[out], rh->window) ^ gear[in];
+
+    return rh->hash;
+}
+
+///// multi-pattern rabin-karp /////
+
+/**
+ * @fn string_rk_t* rk_new(const String *patterns, uint32_t n, bool nocase)
+ * @brief Compile a set of patterns of equal (non-zero) length
+ *
+ */
+static string_rk_t* rk_new(const String *patterns, uint32_t n, bool nocase) {
+    if (patterns == NULL || n == 0 || n > UINT32_MAX / 2 || patterns[0] == NULL || patterns[0]->length == 0)
+        return NULL;
+
+    const uint32_t m = patterns[0]->length;
+    for (uint32_t p = 1; p < n; p++)
+        if (patterns[p] == NULL || patterns[p]->length != m)
+            return NULL;
+
+    string_rk_t *rk = calloc(1, sizeof(string_rk_t));
+    if (rk == NULL)
+        return NULL;
+
+    uint32_t buckets = 16;
+    while (buckets < 2 * n)
+        buckets <<= 1;
+
+    rk->m = m;
+    rk->n = n;
+    rk->nocase = nocase;
+    rk->mask = buckets - 1;
+    rk->pow = rk_pow(m);
+    rk->bytes = malloc((size_t) n * m);
+    rk->hashes = malloc(n * sizeof(uint64_t));
+    rk->heads = malloc(buckets * sizeof(uint32_t));
+    rk->next = malloc(n * sizeof(uint32_t));
+
+    if (rk->bytes == NULL || rk->hashes == NULL || rk->heads == NULL || rk->next == NULL) {
+        string_rk_free(rk);
+        return NULL;
+    }
+
+    memset(rk->heads, 0xff, buckets * sizeof(uint32_t));
+
+    // insert backwards so chains list lower pattern indexes first
+    for (uint32_t p = n; p-- > 0;) {
+        memcpy(rk->bytes + (size_t) p * m, patterns[p]->data, m);
+        rk->hashes[p] = rk_hash(patterns[p]->data, m, nocase);
+        rk->next[p] = rk->heads[rk->hashes[p] & rk->mask];
+        rk->heads[rk->hashes[p] & rk->mask] = p;
+    }
+
+    return rk;
+}
+
+/**
+ * @fn string_rk_t* string_rk_new(const String *patterns, uint32_t n)
+ * @brief Compile a set of patterns of equal (non-zero) length
+ *
+ * @param patterns Array of buffered strings
+ * @param n Number of patterns
+ * @return Multi-pattern finder|NULL
+ */
+string_rk_t* string_rk_new(const String *patterns, uint32_t n) {
+    return rk_new(patterns, n, false);
+}
+
+/**
+ * @fn string_rk_t* string_rk_new_nocase(const String *patterns, uint32_t n)
+ * @brief Compile a set of patterns of equal (non-zero) length matching ignoring ASCII case
+ *
+ * @param patterns Array of buffered strings
+ * @param n Number of patterns
+ * @return Multi-pattern finder|NULL
+ */
+string_rk_t* string_rk_new_nocase(const String *patterns, uint32_t n) {
+    return rk_new(patterns, n, true);
+}
+
+/**
+ * @fn void string_rk_free(string_rk_t *rk)
+ * @brief Free multi-pattern finder
+ *
+ * @param rk Multi-pattern finder
+ */
+void string_rk_free(string_rk_t *rk) {
+    if (rk == NULL)
+        return;
+
+    free(rk->bytes);
+    free(rk->hashes);
+    free(rk->heads);
+    free(rk->next);
+    free(rk);
+}
+
+/**
+ * @fn bool rk_equal(const string_rk_t *rk, uint32_t p, const char *at)
+ * @brief Pattern p is at `at`
+ *
+ */
+static inline bool rk_equal(const string_rk_t *rk, uint32_t p, const char *at) {
+    const char *pattern = rk->bytes + (size_t) p * rk->m;
+
+    return rk->nocase ? string_simd->equal_nocase(pattern, at, rk->m) : !memcmp(pattern, at, rk->m);
+}
+
+/**
+ * @fn uint32_t rk_match(const string_rk_t *rk, uint64_t hash, const char *at)
+ * @brief Pattern matching the window at `at`
+ *
+ * @return Pattern index|RK_NONE
+ */
+static inline uint32_t rk_match(const string_rk_t *rk, uint64_t hash, const char *at) {
+    for (uint32_t p = rk->heads[hash & rk->mask]; p != RK_NONE; p = rk->next[p])
+        if (rk->hashes[p] == hash && rk_equal(rk, p, at))
+            return p;
+
+    return RK_NONE;
+}
+
+/**
+ * @fn uint32_t string_rk_find(const string_rk_t *rk, const String buf, uint32_t pos, uint32_t *pattern)
+ * @brief Find first occurrence of any pattern starting at position
+ *
+ * @param rk Multi-pattern finder
+ * @param buf Buffered string
+ * @param pos Start position
+ * @param pattern Matched pattern index (may be NULL)
+ * @return Position|STR_ERROR
+ */
+uint32_t string_rk_find(const string_rk_t *rk, const String buf, uint32_t pos, uint32_t *pattern) {
+    if (rk == NULL || buf == NULL || pos > buf->length || buf->length - pos < rk->m)
+        return STR_ERROR;
+
+    const uint8_t *d = (const uint8_t*) buf->data;
+    uint64_t hash = rk_hash(buf->data + pos, rk->m, rk->nocase);
+
+    for (uint32_t i = pos;; i++) {
+        const uint32_t p = rk_match(rk, hash, buf->data + i);
+        if (p != RK_NONE) {
+            if (pattern != NULL)
+                *pattern = p;
+            return i;
+        }
+
+        if (i + rk->m >= buf->length)
+            return STR_ERROR;
+
+        hash = (hash - rk_byte(d[i], rk->nocase) * rk->pow) * RK_BASE + rk_byte(d[i + rk->m], rk->nocase);
+    }
+}
+
+/**
+ * @fn void rk_scan(const string_rk_t *rk, const char *data, uint32_t len, bool (*hit)(void*, uint32_t, uint32_t), void *ctx)
+ * @brief Report all (possibly overlapping) occurrences of all patterns. Stops when hit returns false.
+ *
+ */
+static void rk_scan(const string_rk_t *rk, const char *data, uint32_t len, bool (*hit)(void*, uint32_t, uint32_t), void *ctx) {
+    if (len < rk->m)
+        return;
+
+    const uint8_t *d = (const uint8_t*) data;
+    uint64_t hash = rk_hash(data, rk->m, rk->nocase);
+
+    for (uint32_t i = 0;; i++) {
+        // equal patterns all report
+        for (uint32_t p = rk->heads[hash & rk->mask]; p != RK_NONE; p = rk->next[p]) {
+            if (rk->hashes[p] == hash && rk_equal(rk, p, data + i) && !hit(ctx, i, p))
+                return;
+        }
+
+        if (i + rk->m >= len)
+            return;
+
+        hash = (hash - rk_byte(d[i], rk->nocase) * rk->pow) * RK_BASE + rk_byte(d[i + rk->m], rk->nocase);
+    }
+}
+
+/**
+ * @struct rk_list_s
+ * @brief Growing array of matches
+ *
+ */
+struct rk_list_s {
+    string_rk_match_t *matches; /**< matches >**/
+             uint32_t len;      /**< used >**/
+             uint32_t cap;      /**< allocated >**/
+};
+
+/**
+ * @fn bool rk_list_add(void *ctx, uint32_t pos, uint32_t pattern)
+ * @brief rk_scan callback appending to a rk_list_s
+ *
+ */
+static bool rk_list_add(void *ctx, uint32_t pos, uint32_t pattern) {
+    struct rk_list_s *list = ctx;
+
+    if (list->len == list->cap) {
+        const uint32_t cap = list->cap ? list->cap * 2 : 16;
+        string_rk_match_t *tmp = realloc(list->matches, cap * sizeof(string_rk_match_t));
+        if (tmp == NULL)
+            return false;
+        list->matches = tmp;
+        list->cap = cap;
+    }
+
+    list->matches[list->len].pos = pos;
+    list->matches[list->len++].pattern = pattern;
+
+    return true;
+}
+
+/**
+ * @fn uint32_t string_rk_find_all(const string_rk_t *rk, const String buf, string_rk_match_t **matches)
+ * @brief Find all (possibly overlapping) occurrences of all patterns in one pass
+ *
+ * @param rk Multi-pattern finder
+ * @param buf Buffered string
+ * @param matches Array of matches (allocated, free by caller)
+ * @return Number of matches
+ */
+uint32_t string_rk_find_all(const string_rk_t *rk, const String buf, string_rk_match_t **matches) {
+    if (rk == NULL || buf == NULL || matches == NULL)
+        return 0;
+
+    struct rk_list_s list = { NULL, 0, 0 };
+    rk_scan(rk, buf->data, buf->length, rk_list_add, &list);
+    *matches = list.matches;
+
+    return list.len;
+}
+
+///// streaming match /////
+
+/**
+ * @struct stream_list_s
+ * @brief Growing array of stream matches for one feed
+ *
+ */
+struct stream_list_s {
+    string_stream_match_t *matches; /**< matches >**/
+                 uint32_t len;      /**< used >**/
+                 uint32_t cap;      /**< allocated >**/
+                 uint64_t base;     /**< absolute offset of scanned bytes >**/
+                 uint32_t limit;    /**< accept starts below (seam scan) >**/
+};
+
+/**
+ * @fn bool stream_add(void *ctx, uint32_t pos, uint32_t pattern)
+ * @brief rk_scan callback appending to a stream_list_s
+ *
+ */
+static bool stream_add(void *ctx, uint32_t pos, uint32_t pattern) {
+    struct stream_list_s *list = ctx;
+
+    if (pos >= list->limit)
+        return false;
+
+    if (list->len == list->cap) {
+        const uint32_t cap = list->cap ? list->cap * 2 : 16;
+        string_stream_match_t *tmp = realloc(list->matches, cap * sizeof(string_stream_match_t));
+        if (tmp == NULL)
+            return false;
+        list->matches = tmp;
+        list->cap = cap;
+    }
+
+    list->matches[list->len].pos = list->base + pos;
+    list->matches[list->len++].pattern = pattern;
+
+    return true;
+}
+
+/**
+ * @fn void stream_scan(const string_stream_t *st, const char *data, uint32_t len, struct stream_list_s *list)
+ * @brief Report matches of the stream patterns in data
+ *
+ */
+static void stream_scan(const string_stream_t *st, const char *data, uint32_t len, struct stream_list_s *list) {
+    if (st->rk != NULL) {
+        rk_scan(st->rk, data, len, stream_add, list);
+        return;
+    }
+
+    size_t pos = 0, p;
+    while (pos + st->m <= len && (p = string_simd->find(data + pos, len - pos, st->needle, st->m)) != STRING_SIMD_NOT_FOUND) {
+        if (!stream_add(list, pos + p, 0))
+            return;
+        pos += p + 1;
+    }
+}
+
+/**
+ * @fn string_stream_t* stream_new(const char *needle, uint32_t m, const string_rk_t *rk)
+ * @brief Allocate stream matcher with room for needle and 3 * (m - 1) bytes of carry and seam
+ *
+ */
+static string_stream_t* stream_new(const char *needle, uint32_t m, const string_rk_t *rk) {
+    const size_t keep = m - 1;
+    string_stream_t *st = calloc(1, sizeof(string_stream_t) + m + 3 * keep);
+    if (st == NULL)
+        return NULL;
+
+    st->rk = rk;
+    st->m = m;
+    st->needle = st->bytes;
+    st->carry = st->bytes + m;
+    st->seam = st->carry + keep;
+    memcpy(st->needle, needle, m);
+
+    return st;
+}
+
+/**
+ * @fn string_stream_t* string_stream_new(const String needle)
+ * @brief Streaming matcher of one pattern
+ *
+ * @param needle Buffered string (not empty, copied)
+ * @return Stream matcher|NULL
+ */
+string_stream_t* string_stream_new(const String needle) {
+    if (needle == NULL || needle->length == 0)
+        return NULL;
+
+    return stream_new(needle->data, needle->length, NULL);
+}
+
+/**
+ * @fn string_stream_t* string_stream_new_rk(const string_rk_t *rk)
+ * @brief Streaming matcher of a compiled pattern set
+ *
+ * @param rk Multi-pattern finder (must outlive the matcher)
+ * @return Stream matcher|NULL
+ */
+string_stream_t* string_stream_new_rk(const string_rk_t *rk) {
+    if (rk == NULL)
+        return NULL;
+
+    return stream_new(rk->bytes, rk->m, rk);
+}
+
+/**
+ * @fn void string_stream_free(string_stream_t *st)
+ * @brief Free stream matcher
+ *
+ * @param st Stream matcher
+ */
+void string_stream_free(string_stream_t *st) {
+    free(st);
+}
+
+/**
+ * @fn void string_stream_reset(string_stream_t *st)
+ * @brief Restart at offset 0 forgetting carried bytes
+ *
+ * @param st Stream matcher
+ */
+void string_stream_reset(string_stream_t *st) {
+    if (st == NULL)
+        return;
+
+    st->carry_len = 0;
+    st->offset = 0;
+}
+
+/**
+ * @fn uint32_t string_stream_feed(string_stream_t *st, string_view_t chunk, string_stream_match_t **matches)
+ * @brief Feed the next chunk. Reports every (possibly overlapping) match ending in this chunk,
+ *        including those starting in previous chunks. Only the last pattern length - 1 bytes are kept.
+ *
+ * @param st Stream matcher
+ * @param chunk Next bytes of the stream
+ * @param matches Array of matches with absolute positions (allocated, free by caller)
+ * @return Number of matches
+ */
+uint32_t string_stream_feed(string_stream_t *st, string_view_t chunk, string_stream_match_t **matches) {
+    if (st == NULL || matches == NULL || (chunk.data == NULL && chunk.length > 0))
+        return 0;
+
+    struct stream_list_s list = { NULL, 0, 0, 0, 0 };
+    const uint32_t keep = st->m - 1;
+
+    // matches starting in carried bytes and ending in this chunk
+    if (st->carry_len > 0 && chunk.length > 0) {
+        const uint32_t take = chunk.length < keep ? chunk.length : keep;
+        memcpy(st->seam, st->carry, st->carry_len);
+        memcpy(st->seam + st->carry_len, chunk.data, take);
+        list.base = st->offset - st->carry_len;
+        list.limit = st->carry_len;
+        stream_scan(st, st->seam, st->carry_len + take, &list);
+    }
+
+    list.base = st->offset;
+    list.limit = UINT32_MAX;
+    stream_scan(st, chunk.data, chunk.length, &list);
+
+    // carry the last keep bytes of carry + chunk
+    if (chunk.length >= keep) {
+        memcpy(st->carry, chunk.data + chunk.length - keep, keep);
+        st->carry_len = keep;
+    } else {
+        const uint32_t old = (st->carry_len < keep - chunk.length) ? st->carry_len : keep - chunk.length;
+        memmove(st->carry, st->carry + st->carry_len - old, old);
+        memcpy(st->carry + old, chunk.data, chunk.length);
+        st->carry_len = old + chunk.length;
+    }
+
+    st->offset += chunk.length;
+    *matches = list.matches;
+
+    return list.len;
+}
+
+///// content-defined chunking /////
+
+/**
+ * @fn uint64_t cdc_mask(uint32_t bits)
+ * @brief Mask of `bits` high bits (gear hash high bits cover the last 64 bytes)
+ *
+ */
+static inline uint64_t cdc_mask(uint32_t bits) {
+    if (bits == 0)
+        return 0;
+    if (bits >= 64)
+        return UINT64_MAX;
+
+    return ~((uint64_t) 0) << (64 - bits);
+}
+
+/**
+ * @fn bool string_cdc_init(string_cdc_t *cdc, const String buf, uint32_t min, uint32_t avg, uint32_t max)
+ * @brief Start chunking buf. Uses normalized chunking (strict mask below avg, loose above).
+ *
+ * @param cdc Chunker
+ * @param buf Buffered string
+ * @param min Minimum chunk size
+ * @param avg Normal chunk size (power of 2 recommended)
+ * @param max Maximum chunk size
+ * @return Boolean (false: bad arguments)
+ */
+bool string_cdc_init(string_cdc_t *cdc, const String buf, uint32_t min, uint32_t avg, uint32_t max) {
+    if (cdc == NULL || buf == NULL || min == 0 || min > avg || avg > max)
+        return false;
+
+    uint32_t bits = 0;
+    while (((uint64_t) 1 << (bits + 1)) <= avg)
+        ++bits;
+
+    cdc->rest = string_view(buf);
+    cdc->min = min;
+    cdc->avg = avg;
+    cdc->max = max;
+    cdc->mask_s = cdc_mask(bits + 2);
+    cdc->mask_l = cdc_mask(bits > 2 ? bits - 2 : 0);
+
+    return true;
+}
+
+/**
+ * @fn uint32_t cdc_cut(const string_cdc_t *cdc, const uint8_t *d, uint32_t n)
+ * @brief Length of the next chunk of n bytes
+ *
+ */
+static uint32_t cdc_cut(const string_cdc_t *cdc, const uint8_t *d, uint32_t n) {
+    if (n <= cdc->min)
+        return n;
+
+    if (n > cdc->max)
+        n = cdc->max;
+
+    const uint32_t normal = (n < cdc->avg) ? n : cdc->avg;
+    uint64_t fp = 0;
+    uint32_t i = cdc->min;
+
+    // cut-point skipping: the first min bytes are never hashed
+    for (; i < normal; i++) {
+        fp = (fp << 1) + gear[d[i]];
+        if (!(fp & cdc->mask_s))
+            return i + 1;
+    }
+
+    for (; i < n; i++) {
+        fp = (fp << 1) + gear[d[i]];
+        if (!(fp & cdc->mask_l))
+            return i + 1;
+    }
+
+    return n;
+}
+
+/**
+ * @fn bool string_cdc_next(string_cdc_t *cdc, string_view_t *chunk)
+ * @brief Next chunk (view into the chunked string)
+ *
+ * @param cdc Chunker
+ * @param chunk String view
+ * @return Boolean (false: no more chunks)
+ */
+bool string_cdc_next(string_cdc_t *cdc, string_view_t *chunk) {
+    if (cdc == NULL || chunk == NULL || cdc->rest.length == 0)
+        return false;
+
+    const uint32_t cut = cdc_cut(cdc, (const uint8_t*) cdc->rest.data, cdc->rest.length);
+
+    chunk->data = cdc->rest.data;
+    chunk->length = cut;
+    cdc->rest.data += cut;
+    cdc->rest.length -= cut;
+
+    return true;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file strings_rolling.h
+ * @brief rolling hashes, multi-pattern search and content-defined chunking
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef STRINGS_ROLLING_H_
+#define STRINGS_ROLLING_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "strings.h"
+
+/**
+ * @enum STRING_ROLLING_TYPE
+ * @brief Rolling hash type
+ *
+ */
+enum STRING_ROLLING_TYPE {
+    ROLLING_RABIN_KARP, /**< polynomial hash modulo 2^64 >**/
+    ROLLING_BUZHASH     /**< cyclic polynomial over a random byte table >**/
+};
+
+/**
+ * @struct string_rolling_s
+ * @brief Fixed window rolling hash
+ *
+ */
+struct string_rolling_s {
+     uint8_t type;   /**< enum STRING_ROLLING_TYPE >**/
+    uint32_t window; /**< window length >**/
+    uint64_t hash;   /**< hash of current window >**/
+    uint64_t pow;    /**< base^(window-1) (rabin-karp) >**/
+};
+typedef struct string_rolling_s string_rolling_t; /**< rolling hash type >**/
+
+/**
+ * @struct string_rk_match_s
+ * @brief Multi-pattern match
+ *
+ */
+struct string_rk_match_s {
+    uint32_t pos;     /**< position in string >**/
+    uint32_t pattern; /**< pattern index >**/
+};
+typedef struct string_rk_match_s string_rk_match_t; /**< match type >**/
+
+/**
+ * @struct string_rk_s
+ * @brief Compiled set of same-length patterns (Rabin-Karp)
+ *
+ */
+struct string_rk_s {
+    uint32_t m;        /**< pattern length >**/
+    uint32_t n;        /**< number of patterns >**/
+        char *bytes;   /**< n * m pattern bytes >**/
+    uint64_t *hashes;  /**< pattern hashes >**/
+    uint32_t *heads;   /**< hash buckets >**/
+    uint32_t *next;    /**< bucket chains >**/
+    uint32_t mask;     /**< buckets - 1 >**/
+    uint64_t pow;      /**< base^(m-1) >**/
+        bool nocase;   /**< ASCII case-insensitive >**/
+};
+typedef struct string_rk_s string_rk_t; /**< multi-pattern finder type >**/
+
+/**
+ * @struct string_stream_match_s
+ * @brief Stream match
+ *
+ */
+struct string_stream_match_s {
+    uint64_t pos;     /**< absolute position in stream >**/
+    uint32_t pattern; /**< pattern index (0 for a single pattern) >**/
+};
+typedef struct string_stream_match_s string_stream_match_t; /**< stream match type >**/
+
+/**
+ * @struct string_stream_s
+ * @brief Resumable matcher fed consecutive chunks
+ *
+ */
+struct string_stream_s {
+    const string_rk_t *rk;        /**< pattern set (NULL: single needle) >**/
+             uint32_t m;          /**< pattern length >**/
+                 char *needle;    /**< single pattern >**/
+                 char *carry;     /**< last m - 1 bytes seen >**/
+             uint32_t carry_len;  /**< carried bytes >**/
+                 char *seam;      /**< carry + head of chunk scratch >**/
+             uint64_t offset;     /**< absolute offset of next chunk >**/
+                 char bytes[];    /**< needle, carry and seam storage >**/
+};
+typedef struct string_stream_s string_stream_t; /**< stream matcher type >**/
+
+/**
+ * @struct string_cdc_s
+ * @brief Content-defined chunker (FastCDC)
+ *
+ */
+struct string_cdc_s {
+    string_view_t rest;   /**< not yet chunked bytes >**/
+         uint32_t min;    /**< minimum chunk size >**/
+         uint32_t avg;    /**< normal chunk size >**/
+         uint32_t max;    /**< maximum chunk size >**/
+         uint64_t mask_s; /**< strict mask (below avg) >**/
+         uint64_t mask_l; /**< loose mask (above avg) >**/
+};
+typedef struct string_cdc_s string_cdc_t; /**< chunker type >**/
+
+    bool string_rolling_init(string_rolling_t *rh, uint8_t type, uint32_t window);
+uint64_t string_rolling_start(string_rolling_t *rh, const char *data);
+uint64_t string_rolling_roll(string_rolling_t *rh, uint8_t out, uint8_t in);
+
+string_rk_t* string_rk_new(const String *patterns, uint32_t n);
+string_rk_t* string_rk_new_nocase(const String *patterns, uint32_t n);
+        void string_rk_free(string_rk_t *rk);
+    uint32_t string_rk_find(const string_rk_t *rk, const String buf, uint32_t pos, uint32_t *pattern);
+    uint32_t string_rk_find_all(const string_rk_t *rk, const String buf, string_rk_match_t **matches);
+
+string_stream_t* string_stream_new(const String needle);
+string_stream_t* string_stream_new_rk(const string_rk_t *rk);
+            void string_stream_free(string_stream_t *st);
+            void string_stream_reset(string_stream_t *st);
+        uint32_t string_stream_feed(string_stream_t *st, string_view_t chunk, string_stream_match_t **matches);
+
+    bool string_cdc_init(string_cdc_t *cdc, const String buf, uint32_t min, uint32_t avg, uint32_t max);
+    bool string_cdc_next(string_cdc_t *cdc, string_view_t *chunk);
+
+#endif /* STRINGS_ROLLING_H_ */
@@ -0,0 +1,284 @@
+/**
+ * @file strings_shard.c
+ * @brief consistent hashing of strings to shards
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "strings.h"
+#include "strings_internal.h"
+#include "strings_shard.h"
+
+/**
+ * @fn uint32_t jump(uint64_t h, uint32_t buckets)
+ * @brief Jump consistent hash (Lamping, Veach)
+ *
+ */
+static inline uint32_t jump(uint64_t h, uint32_t buckets) {
+    int64_t b = -1, j = 0;
+
+    while (j < buckets) {
+        b = j;
+        h = h * UINT64_C(2862933555777941757) + 1;
+        j = (int64_t) ((b + 1) * ((double) ((int64_t) 1 << 31) / (double) ((h >> 33) + 1)));
+    }
+
+    return (uint32_t) b;
+}
+
+/**
+ * @fn uint32_t string_shard_jump(const String key, uint32_t buckets, uint8_t hkey[16])
+ * @brief Shard of key among `buckets`. Growing to buckets + 1 moves only 1 / (buckets + 1) of keys.
+ *
+ * @param key Buffered string
+ * @param buckets Number of shards
+ * @param hkey Siphash key
+ * @return Shard|STR_ERROR
+ */
+uint32_t string_shard_jump(const String key, uint32_t buckets, uint8_t hkey[16]) {
+    if (key == NULL || hkey == NULL || buckets == 0)
+        return STR_ERROR;
+
+    return jump(string_hash64_view(string_view(key), hkey), buckets);
+}
+
+/**
+ * @fn bool string_shard_jump_batch(const String *keys, uint32_t n, uint32_t buckets, uint8_t hkey[16], uint32_t *shards)
+ * @brief Shards of an array of keys
+ *
+ * @param keys Array of buffered strings
+ * @param n Number of keys
+ * @param buckets Number of shards
+ * @param hkey Siphash key
+ * @param shards Array of n results (STR_ERROR for NULL keys)
+ * @return Boolean (false: bad arguments)
+ */
+bool string_shard_jump_batch(const String *keys, uint32_t n, uint32_t buckets, uint8_t hkey[16], uint32_t *shards) {
+    if (keys == NULL || hkey == NULL || shards == NULL || buckets == 0)
+        return false;
+
+    for (uint32_t i = 0; i < n; i++)
+        shards[i] = (keys[i] == NULL) ? STR_ERROR : jump(string_hash64_view(string_view(keys[i]), hkey), buckets);
+
+    return true;
+}
+
+/**
+ * @fn int ring_cmp(const void *a, const void *b)
+ * @brief Order ring points
+ *
+ */
+static int ring_cmp(const void *a, const void *b) {
+    const uint64_t pa = ((const uint64_t*) a)[0], pb = ((const uint64_t*) b)[0];
+
+    return (pa > pb) - (pa < pb);
+}
+
+/**
+ * @fn string_shard_ring_t* string_shard_ring_new(const String *nodes, uint32_t n, uint32_t vnodes, uint8_t key[16])
+ * @brief Build ring of nodes with `vnodes` points each. Node names also drive rendezvous hashing.
+ *
+ * @param nodes Array of node names
+ * @param n Number of nodes
+ * @param vnodes Points per node
+ * @param key Siphash key
+ * @return Shard ring|NULL
+ */
+string_shard_ring_t* string_shard_ring_new(const String *nodes, uint32_t n, uint32_t vnodes, uint8_t key[16]) {
+    if (nodes == NULL || key == NULL || n == 0 || vnodes == 0 || (uint64_t) n * vnodes > UINT32_MAX / 2)
+        return NULL;
+
+    string_shard_ring_t *ring = calloc(1, sizeof(string_shard_ring_t));
+    if (ring == NULL)
+        return NULL;
+
+    ring->nodes = n;
+    ring->npoints = n * vnodes;
+    memcpy(ring->key, key, 16);
+    ring->node_hash = malloc(n * sizeof(uint64_t));
+    ring->points = malloc(ring->npoints * sizeof(uint64_t));
+    ring->owners = malloc(ring->npoints * sizeof(uint32_t));
+    uint64_t (*pairs)[2] = malloc(ring->npoints * sizeof(*pairs));
+
+    if (ring->node_hash == NULL || ring->points == NULL || ring->owners == NULL || pairs == NULL) {
+        free(pairs);
+        string_shard_ring_free(ring);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        if (nodes[i] == NULL) {
+            free(pairs);
+            string_shard_ring_free(ring);
+            return NULL;
+        }
+
+        ring->node_hash[i] = string_hash64_view(string_view(nodes[i]), key);
+        for (uint32_t v = 0; v < vnodes; v++) {
+            pairs[i * vnodes + v][0] = string_mix64(ring->node_hash[i] + v * UINT64_C(0x9E3779B97F4A7C15));
+            pairs[i * vnodes + v][1] = i;
+        }
+    }
+
+    qsort(pairs, ring->npoints, sizeof(*pairs), ring_cmp);
+    for (uint32_t p = 0; p < ring->npoints; p++) {
+        ring->points[p] = pairs[p][0];
+        ring->owners[p] = (uint32_t) pairs[p][1];
+    }
+
+    free(pairs);
+
+    return ring;
+}
+
+/**
+ * @fn void string_shard_ring_free(string_shard_ring_t *ring)
+ * @brief Free shard ring
+ *
+ * @param ring Shard ring
+ */
+void string_shard_ring_free(string_shard_ring_t *ring) {
+    if (ring == NULL)
+        return;
+
+    free(ring->node_hash);
+    free(ring->points);
+    free(ring->owners);
+    free(ring);
+}
+
+/**
+ * @fn uint32_t ring_lookup(const string_shard_ring_t *ring, uint64_t h)
+ * @brief Owner of first point at or after h (wrapping)
+ *
+ */
+static inline uint32_t ring_lookup(const string_shard_ring_t *ring, uint64_t h) {
+    uint32_t lo = 0, hi = ring->npoints;
+
+    while (lo < hi) {
+        const uint32_t mid = lo + (hi - lo) / 2;
+        if (ring->points[mid] < h)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return ring->owners[lo == ring->npoints ? 0 : lo];
+}
+
+/**
+ * @fn uint32_t rendezvous(const string_shard_ring_t *ring, uint64_t h)
+ * @brief Node with highest score for h
+ *
+ */
+static inline uint32_t rendezvous(const string_shard_ring_t *ring, uint64_t h) {
+    uint32_t best = 0;
+    uint64_t best_score = 0;
+
+    for (uint32_t i = 0; i < ring->nodes; i++) {
+        const uint64_t score = string_mix64(h ^ ring->node_hash[i]);
+        if (score > best_score || i == 0) {
+            best_score = score;
+            best = i;
+        }
+    }
+
+    return best;
+}
+
+/**
+ * @fn uint32_t string_shard_ring(const string_shard_ring_t *ring, const String key)
+ * @brief Node of key on the ring
+ *
+ * @param ring Shard ring
+ * @param key Buffered string
+ * @return Node index|STR_ERROR
+ */
+uint32_t string_shard_ring(const string_shard_ring_t *ring, const String key) {
+    if (ring == NULL || key == NULL)
+        return STR_ERROR;
+
+    return ring_lookup(ring, string_hash64_view(string_view(key), ring->key));
+}
+
+/**
+ * @fn bool string_shard_ring_batch(const string_shard_ring_t *ring, const String *keys, uint32_t n, uint32_t *shards)
+ * @brief Nodes of an array of keys on the ring
+ *
+ * @param ring Shard ring
+ * @param keys Array of buffered strings
+ * @param n Number of keys
+ * @param shards Array of n results (STR_ERROR for NULL keys)
+ * @return Boolean (false: bad arguments)
+ */
+bool string_shard_ring_batch(const string_shard_ring_t *ring, const String *keys, uint32_t n, uint32_t *shards) {
+    if (ring == NULL || keys == NULL || shards == NULL)
+        return false;
+
+    for (uint32_t i = 0; i < n; i++)
+        shards[i] = (keys[i] == NULL) ? STR_ERROR : ring_lookup(ring, string_hash64_view(string_view(keys[i]), ring->key));
+
+    return true;
+}
+
+/**
+ * @fn uint32_t string_shard_rendezvous(const string_shard_ring_t *ring, const String key)
+ * @brief Node of key by highest random weight (rendezvous hashing)
+ *
+ * @param ring Shard ring
+ * @param key Buffered string
+ * @return Node index|STR_ERROR
+ */
+uint32_t string_shard_rendezvous(const string_shard_ring_t *ring, const String key) {
+    if (ring == NULL || key == NULL)
+        return STR_ERROR;
+
+    return rendezvous(ring, string_hash64_view(string_view(key), ring->key));
+}
+
+/**
+ * @fn bool string_shard_rendezvous_batch(const string_shard_ring_t *ring, const String *keys, uint32_t n, uint32_t *shards)
+ * @brief Nodes of an array of keys by rendezvous hashing
+ *
+ * @param ring Shard ring
+ * @param keys Array of buffered strings
+ * @param n Number of keys
+ * @param shards Array of n results (STR_ERROR for NULL keys)
+ * @return Boolean (false: bad arguments)
+ */
+bool string_shard_rendezvous_batch(const string_shard_ring_t *ring, const String *keys, uint32_t n, uint32_t *shards) {
+    if (ring == NULL || keys == NULL || shards == NULL)
+        return false;
+
+    for (uint32_t i = 0; i < n; i++)
+        shards[i] = (keys[i] == NULL) ? STR_ERROR : rendezvous(ring, string_hash64_view(string_view(keys[i]), ring->key));
+
+    return true;
+}
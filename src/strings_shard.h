@@ -0,0 +1,65 @@
+/**
+ * @file strings_shard.h
+ * @brief consistent hashing of strings to shards
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef STRINGS_SHARD_H_
+#define STRINGS_SHARD_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "strings.h"
+
+/**
+ * @struct string_shard_ring_s
+ * @brief Consistent hash ring (virtual nodes) and rendezvous node set
+ *
+ */
+struct string_shard_ring_s {
+    uint32_t nodes;       /**< number of nodes >**/
+    uint64_t *node_hash;  /**< hash of each node name >**/
+    uint32_t npoints;     /**< ring points (nodes * vnodes) >**/
+    uint64_t *points;     /**< sorted ring points >**/
+    uint32_t *owners;     /**< node of each point >**/
+     uint8_t key[16];     /**< siphash key >**/
+};
+typedef struct string_shard_ring_s string_shard_ring_t; /**< shard ring type >**/
+
+            uint32_t string_shard_jump(const String key, uint32_t buckets, uint8_t hkey[16]);
+                bool string_shard_jump_batch(const String *keys, uint32_t n, uint32_t buckets, uint8_t hkey[16], uint32_t *shards);
+
+string_shard_ring_t* string_shard_ring_new(const String *nodes, uint32_t n, uint32_t vnodes, uint8_t key[16]);
+                void string_shard_ring_free(string_shard_ring_t *ring);
+            uint32_t string_shard_ring(const string_shard_ring_t *ring, const String key);
+                bool string_shard_ring_batch(const string_shard_ring_t *ring, const String *keys, uint32_t n, uint32_t *shards);
+            uint32_t string_shard_rendezvous(const string_shard_ring_t *ring, const String key);
+                bool string_shard_rendezvous_batch(const string_shard_ring_t *ring, const String *keys, uint32_t n, uint32_t *shards);
+
+#endif /* STRINGS_SHARD_H_ */
@@ -0,0 +1,453 @@
+/**
+ * @file strings_shm.c
+ * @brief strings in a shared memory heap with an SPMC hand-off ring
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "strings.h"
+#include "strings_shm.h"
+
+/**
+ * @def SHM_MAGIC
+ * @brief Segment signature
+ *
+ */
+#define SHM_MAGIC 0x31534d4853525453ull
+
+/**
+ * @def SHM_UNIT
+ * @brief Allocation granularity (free list links are stored in these units)
+ *
+ */
+#define SHM_UNIT 16
+
+/**
+ * @def SHM_CLASSES
+ * @brief Power of two size classes (1 << SHM_MIN_SHIFT and up)
+ *
+ */
+#define SHM_CLASSES 32
+
+/**
+ * @def SHM_MIN_SHIFT
+ * @brief Smallest block (1 << SHM_MIN_SHIFT)
+ *
+ */
+#define SHM_MIN_SHIFT 6
+
+/**
+ * @struct shm_header_s
+ * @brief Segment header (shared by all processes)
+ *
+ */
+struct shm_header_s {
+                 uint64_t magic;             /**< SHM_MAGIC >**/
+                 uint64_t size;              /**< segment size >**/
+                 uint64_t heap;              /**< first heap byte >**/
+                 uint32_t slots;             /**< ring slots (power of 2) >**/
+         _Atomic uint64_t brk;               /**< bump allocation offset >**/
+         _Atomic uint64_t free[SHM_CLASSES]; /**< free list heads (tag << 32 | offset / SHM_UNIT) >**/
+    _Alignas(64) _Atomic uint64_t head;      /**< next slot to write (producer) >**/
+    _Alignas(64) _Atomic uint64_t tail;      /**< next slot to read (consumers) >**/
+    _Alignas(64) _Atomic uint64_t ring[];    /**< handles >**/
+};
+
+/**
+ * @struct shm_block_s
+ * @brief Block header, followed by the String
+ *
+ */
+struct shm_block_s {
+    _Atomic uint32_t next;  /**< free list link (offset / SHM_UNIT) >**/
+            uint32_t cls;   /**< size class >**/
+            uint64_t pad;   /**< keeps the String STRING_ALIGN aligned >**/
+};
+
+/**
+ * @def HDR
+ * @brief Segment header of a mapping
+ *
+ */
+#define HDR(shm) ((struct shm_header_s*) (shm)->base)
+
+/**
+ * @def BLOCK
+ * @brief Block at offset
+ *
+ */
+#define BLOCK(shm, off) ((struct shm_block_s*) ((shm)->base + (off)))
+
+/**
+ * @fn string_shm_t* shm_map(int fd, size_t size)
+ * @brief Map segment
+ *
+ */
+static string_shm_t* shm_map(int fd, size_t size) {
+    string_shm_t *shm = malloc(sizeof(string_shm_t));
+    if (shm == NULL)
+        return NULL;
+
+    shm->base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (shm->base == MAP_FAILED) {
+        free(shm);
+        return NULL;
+    }
+
+    shm->size = size;
+    shm->fd = fd;
+
+    return shm;
+}
+
+/**
+ * @fn string_shm_t* string_shm_create(const char *name, size_t size, uint32_t slots)
+ * @brief Create a shared String heap
+ *
+ * @param name POSIX shared memory name ("/x") or NULL for an anonymous memfd (shared by fork or descriptor passing)
+ * @param size Segment size
+ * @param slots Hand-off ring slots (rounded up to a power of 2)
+ * @return Shared heap
+ */
+string_shm_t* string_shm_create(const char *name, size_t size, uint32_t slots) {
+    if (slots == 0 || slots > (1u << 30))
+        return NULL;
+
+    uint32_t n = 1;
+    while (n < slots)
+        n <<= 1;
+
+    const uint64_t heap = (sizeof(struct shm_header_s) + (uint64_t) n * sizeof(uint64_t) + 63) & ~63ull;
+    if (size < heap + (1u << SHM_MIN_SHIFT))
+        return NULL;
+
+    int fd;
+    if (name == NULL) {
+#if defined(__linux__)
+        fd = memfd_create("strings_shm", MFD_CLOEXEC);
+#else
+        return NULL;
+#endif
+    } else
+        fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+
+    if (fd < 0)
+        return NULL;
+
+    string_shm_t *shm;
+    if (ftruncate(fd, size) != 0 || (shm = shm_map(fd, size)) == NULL) {
+        close(fd);
+        if (name != NULL)
+            shm_unlink(name);
+        return NULL;
+    }
+
+    struct shm_header_s *hdr = HDR(shm);
+    hdr->size = size;
+    hdr->heap = heap;
+    hdr->slots = n;
+    atomic_init(&hdr->brk, heap);
+    for (uint32_t c = 0; c < SHM_CLASSES; c++)
+        atomic_init(&hdr->free[c], 0);
+    atomic_init(&hdr->head, 0);
+    atomic_init(&hdr->tail, 0);
+    for (uint32_t s = 0; s < n; s++)
+        atomic_init(&hdr->ring[s], STRING_SHM_NULL);
+    atomic_thread_fence(memory_order_release);
+    hdr->magic = SHM_MAGIC;
+
+    return shm;
+}
+
+/**
+ * @fn string_shm_t* string_shm_attach(int fd)
+ * @brief Attach to a segment by descriptor (takes ownership of fd)
+ *
+ * @param fd Segment descriptor
+ * @return Shared heap
+ */
+string_shm_t* string_shm_attach(int fd) {
+    struct stat st;
+
+    if (fd < 0 || fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(struct shm_header_s))
+        return NULL;
+
+    string_shm_t *shm = shm_map(fd, st.st_size);
+    if (shm == NULL)
+        return NULL;
+
+    if (HDR(shm)->magic != SHM_MAGIC || HDR(shm)->size != (uint64_t) st.st_size) {
+        munmap(shm->base, shm->size);
+        free(shm);
+        return NULL;
+    }
+
+    return shm;
+}
+
+/**
+ * @fn string_shm_t* string_shm_open(const char *name)
+ * @brief Attach to a named segment
+ *
+ * @param name POSIX shared memory name
+ * @return Shared heap
+ */
+string_shm_t* string_shm_open(const char *name) {
+    if (name == NULL)
+        return NULL;
+
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0)
+        return NULL;
+
+    string_shm_t *shm = string_shm_attach(fd);
+    if (shm == NULL)
+        close(fd);
+
+    return shm;
+}
+
+/**
+ * @fn void string_shm_close(string_shm_t *shm)
+ * @brief Unmap segment and close its descriptor (segment lives while mapped or named)
+ *
+ * @param shm Shared heap
+ */
+void string_shm_close(string_shm_t *shm) {
+    if (shm == NULL)
+        return;
+
+    munmap(shm->base, shm->size);
+    close(shm->fd);
+    free(shm);
+}
+
+/**
+ * @fn bool string_shm_unlink(const char *name)
+ * @brief Remove a named segment
+ *
+ * @param name POSIX shared memory name
+ * @return Boolean
+ */
+bool string_shm_unlink(const char *name) {
+    return name != NULL && shm_unlink(name) == 0;
+}
+
+/**
+ * @fn String string_shm_new_uninit(string_shm_t *shm, uint32_t cap)
+ * @brief New empty String of capacity cap in the segment (see string_new_uninit)
+ *
+ * @param shm Shared heap
+ * @param cap Capacity
+ * @return Buffered string (read-only for other processes, never passed to free() or resized)
+ */
+String string_shm_new_uninit(string_shm_t *shm, uint32_t cap) {
+    if (shm == NULL || cap > UINT32_MAX - 1)
+        return NULL;
+
+    struct shm_header_s *hdr = HDR(shm);
+    const uint64_t need = sizeof(struct shm_block_s) + sizeof(string_t) + (uint64_t) cap + 1 + STRING_PAD;
+    uint32_t cls = 0;
+
+    while (((uint64_t) 1 << (cls + SHM_MIN_SHIFT)) < need)
+        if (++cls == SHM_CLASSES)
+            return NULL;
+
+    // reuse a freed block (tag defeats ABA between concurrent allocators)
+    uint64_t off = 0;
+    uint64_t top = atomic_load_explicit(&hdr->free[cls], memory_order_acquire);
+    while ((uint32_t) top != 0) {
+        const uint64_t o = (uint64_t) (uint32_t) top * SHM_UNIT;
+        const uint64_t next = ((top & 0xffffffff00000000ull) + (1ull << 32))
+                | atomic_load_explicit(&BLOCK(shm, o)->next, memory_order_relaxed);
+
+        if (atomic_compare_exchange_weak_explicit(&hdr->free[cls], &top, next, memory_order_acq_rel, memory_order_acquire)) {
+            off = o;
+            break;
+        }
+    }
+
+    if (off == 0) {
+        const uint64_t bsize = (uint64_t) 1 << (cls + SHM_MIN_SHIFT);
+        off = atomic_load_explicit(&hdr->brk, memory_order_relaxed);
+        do {
+            if (off + bsize > hdr->size || (off + bsize) / SHM_UNIT > UINT32_MAX)
+                return NULL;
+        } while (!atomic_compare_exchange_weak_explicit(&hdr->brk, &off, off + bsize, memory_order_relaxed, memory_order_relaxed));
+    }
+
+    BLOCK(shm, off)->cls = cls;
+
+    String buf = (String) (shm->base + off + sizeof(struct shm_block_s));
+    buf->capacity = cap;
+    buf->length = 0;
+    buf->data[0] = 0;
+    buf->data[cap] = 0;
+
+    return buf;
+}
+
+/**
+ * @fn String string_shm_new(string_shm_t *shm, string_view_t view)
+ * @brief New String in the segment holding view
+ *
+ * @param shm Shared heap
+ * @param view Bytes
+ * @return Buffered string
+ */
+String string_shm_new(string_shm_t *shm, string_view_t view) {
+    if (view.data == NULL)
+        return NULL;
+
+    String buf = string_shm_new_uninit(shm, view.length);
+    if (buf == NULL)
+        return NULL;
+
+    memcpy(buf->data, view.data, view.length);
+    buf->data[view.length] = '\0';
+    buf->length = view.length;
+
+    return buf;
+}
+
+/**
+ * @fn void string_shm_free(string_shm_t *shm, String buf)
+ * @brief Return a segment String to the heap (any process)
+ *
+ * @param shm Shared heap
+ * @param buf Buffered string
+ */
+void string_shm_free(string_shm_t *shm, String buf) {
+    const string_shm_handle_t h = string_shm_handle(shm, buf);
+    if (h == STRING_SHM_NULL)
+        return;
+
+    struct shm_header_s *hdr = HDR(shm);
+    const uint64_t off = h - sizeof(struct shm_block_s);
+    struct shm_block_s *block = BLOCK(shm, off);
+    uint64_t top = atomic_load_explicit(&hdr->free[block->cls], memory_order_relaxed);
+    uint64_t next;
+
+    do {
+        atomic_store_explicit(&block->next, (uint32_t) top, memory_order_relaxed);
+        next = ((top & 0xffffffff00000000ull) + (1ull << 32)) | (off / SHM_UNIT);
+    } while (!atomic_compare_exchange_weak_explicit(&hdr->free[block->cls], &top, next, memory_order_release, memory_order_relaxed));
+}
+
+/**
+ * @fn string_shm_handle_t string_shm_handle(const string_shm_t *shm, const String buf)
+ * @brief Handle of a segment String, valid in every process mapping the segment
+ *
+ * @param shm Shared heap
+ * @param buf Buffered string
+ * @return Handle (STRING_SHM_NULL if buf is not in the segment)
+ */
+string_shm_handle_t string_shm_handle(const string_shm_t *shm, const String buf) {
+    if (shm == NULL || buf == NULL)
+        return STRING_SHM_NULL;
+
+    const uint8_t *p = (const uint8_t*) buf;
+    if (p < shm->base + HDR(shm)->heap + sizeof(struct shm_block_s) || p >= shm->base + shm->size)
+        return STRING_SHM_NULL;
+
+    return p - shm->base;
+}
+
+/**
+ * @fn String string_shm_string(const string_shm_t *shm, string_shm_handle_t handle)
+ * @brief String of a handle in this process mapping
+ *
+ * @param shm Shared heap
+ * @param handle Handle
+ * @return Buffered string
+ */
+String string_shm_string(const string_shm_t *shm, string_shm_handle_t handle) {
+    if (shm == NULL || handle < HDR(shm)->heap + sizeof(struct shm_block_s) || handle + sizeof(string_t) > shm->size)
+        return NULL;
+
+    return (String) (shm->base + handle);
+}
+
+/**
+ * @fn bool string_shm_push(string_shm_t *shm, const String buf)
+ * @brief Hand a segment String to the consumers (single producer)
+ *
+ * @param shm Shared heap
+ * @param buf Buffered string (owned by the consumer that pops it)
+ * @return Boolean (false if the ring is full)
+ */
+bool string_shm_push(string_shm_t *shm, const String buf) {
+    const string_shm_handle_t h = string_shm_handle(shm, buf);
+    if (h == STRING_SHM_NULL)
+        return false;
+
+    struct shm_header_s *hdr = HDR(shm);
+    const uint64_t head = atomic_load_explicit(&hdr->head, memory_order_relaxed);
+
+    if (head - atomic_load_explicit(&hdr->tail, memory_order_acquire) >= hdr->slots)
+        return false;
+
+    atomic_store_explicit(&hdr->ring[head & (hdr->slots - 1)], h, memory_order_relaxed);
+    atomic_store_explicit(&hdr->head, head + 1, memory_order_release);
+
+    return true;
+}
+
+/**
+ * @fn String string_shm_pop(string_shm_t *shm)
+ * @brief Take the oldest handed-off String (any number of consumers)
+ *
+ * @param shm Shared heap
+ * @return Buffered string (NULL if the ring is empty)
+ */
+String string_shm_pop(string_shm_t *shm) {
+    if (shm == NULL)
+        return NULL;
+
+    struct shm_header_s *hdr = HDR(shm);
+    uint64_t tail = atomic_load_explicit(&hdr->tail, memory_order_relaxed);
+
+    for (;;) {
+        if (tail == atomic_load_explicit(&hdr->head, memory_order_acquire))
+            return NULL;
+
+        // read before claiming: the producer cannot reuse the slot until tail moves past it
+        const string_shm_handle_t h = atomic_load_explicit(&hdr->ring[tail & (hdr->slots - 1)], memory_order_relaxed);
+
+        if (atomic_compare_exchange_weak_explicit(&hdr->tail, &tail, tail + 1, memory_order_acq_rel, memory_order_relaxed))
+            return string_shm_string(shm, h);
+    }
+}
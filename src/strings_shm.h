@@ -0,0 +1,81 @@
+/**
+ * @file strings_shm.h
+ * @brief strings in a shared memory heap with an SPMC hand-off ring
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef STRINGS_SHM_H_
+#define STRINGS_SHM_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "strings.h"
+
+/**
+ * @def STRING_SHM_NULL
+ * @brief Invalid handle
+ *
+ */
+#define STRING_SHM_NULL 0
+
+/**
+ * @struct string_shm_s
+ * @brief Process local mapping of a shared String heap
+ *
+ */
+struct string_shm_s {
+    uint8_t *base; /**< mapping (addresses differ between processes, use handles) >**/
+     size_t size;  /**< segment size >**/
+        int fd;    /**< segment descriptor >**/
+};
+typedef struct string_shm_s string_shm_t; /**< shared heap type >**/
+
+/**
+ * @typedef string_shm_handle_t
+ * @brief Position independent reference to a String in the segment (offset)
+ *
+ */
+typedef uint64_t string_shm_handle_t;
+
+      string_shm_t* string_shm_create(const char *name, size_t size, uint32_t slots);
+      string_shm_t* string_shm_open(const char *name);
+      string_shm_t* string_shm_attach(int fd);
+               void string_shm_close(string_shm_t *shm);
+               bool string_shm_unlink(const char *name);
+
+             String string_shm_new_uninit(string_shm_t *shm, uint32_t cap);
+             String string_shm_new(string_shm_t *shm, string_view_t view);
+               void string_shm_free(string_shm_t *shm, String buf);
+string_shm_handle_t string_shm_handle(const string_shm_t *shm, const String buf);
+             String string_shm_string(const string_shm_t *shm, string_shm_handle_t handle);
+
+               bool string_shm_push(string_shm_t *shm, const String buf);
+             String string_shm_pop(string_shm_t *shm);
+
+#endif /* STRINGS_SHM_H_ */
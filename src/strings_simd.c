@@ -0,0 +1,1825 @@
+/**
+ * @file strings_simd.c
+ * @brief runtime cpu dispatch of simd kernels
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "strings.h"
+#include "strings_simd.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+/**
+ * @def NF
+ * @brief short for STRING_SIMD_NOT_FOUND
+ *
+ */
+#define NF STRING_SIMD_NOT_FOUND
+
+/**
+ * @var crc32c_table
+ * @brief crc32c (Castagnoli, reflected 0x82F63B78) byte table
+ *
+ */
+static const uint32_t crc32c_table[256] = {
+    0x00000000, 0xf26b8303, 0xe13b70f7, 0x1350f3f4, 0xc79a971f, 0x35f1141c, 0x26a1e7e8, 0xd4ca64eb,
+    0x8ad958cf, 0x78b2dbcc, 0x6be22838, 0x9989ab3b, 0x4d43cfd0, 0xbf284cd3, 0xac78bf27, 0x5e133c24,
+    0x105ec76f, 0xe235446c, 0xf165b798, 0x030e349b, 0xd7c45070, 0x25afd373, 0x36ff2087, 0xc494a384,
+    0x9a879fa0, 0x68ec1ca3, 0x7bbcef57, 0x89d76c54, 0x5d1d08bf, 0xaf768bbc, 0xbc267848, 0x4e4dfb4b,
+    0x20bd8ede, 0xd2d60ddd, 0xc186fe29, 0x33ed7d2a, 0xe72719c1, 0x154c9ac2, 0x061c6936, 0xf477ea35,
+    0xaa64d611, 0x580f5512, 0x4b5fa6e6, 0xb93425e5, 0x6dfe410e, 0x9f95c20d, 0x8cc531f9, 0x7eaeb2fa,
+    0x30e349b1, 0xc288cab2, 0xd1d83946, 0x23b3ba45, 0xf779deae, 0x05125dad, 0x1642ae59, 0xe4292d5a,
+    0xba3a117e, 0x4851927d, 0x5b016189, 0xa96ae28a, 0x7da08661, 0x8fcb0562, 0x9c9bf696, 0x6ef07595,
+    0x417b1dbc, 0xb3109ebf, 0xa0406d4b, 0x522bee48, 0x86e18aa3, 0x748a09a0, 0x67dafa54, 0x95b17957,
+    0xcba24573, 0x39c9c670, 0x2a993584, 0xd8f2b687, 0x0c38d26c, 0xfe53516f, 0xed03a29b, 0x1f682198,
+    0x5125dad3, 0xa34e59d0, 0xb01eaa24, 0x42752927, 0x96bf4dcc, 0x64d4cecf, 0x77843d3b, 0x85efbe38,
+    0xdbfc821c, 0x2997011f, 0x3ac7f2eb, 0xc8ac71e8, 0x1c661503, 0xee0d9600, 0xfd5d65f4, 0x0f36e6f7,
+    0x61c69362, 0x93ad1061, 0x80fde395, 0x72966096, 0xa65c047d, 0x5437877e, 0x4767748a, 0xb50cf789,
+    0xeb1fcbad, 0x197448ae, 0x0a24bb5a, 0xf84f3859, 0x2c855cb2, 0xdeeedfb1, 0xcdbe2c45, 0x3fd5af46,
+    0x7198540d, 0x83f3d70e, 0x90a324fa, 0x62c8a7f9, 0xb602c312, 0x44694011, 0x5739b3e5, 0xa55230e6,
+    0xfb410cc2, 0x092a8fc1, 0x1a7a7c35, 0xe811ff36, 0x3cdb9bdd, 0xceb018de, 0xdde0eb2a, 0x2f8b6829,
+    0x82f63b78, 0x709db87b, 0x63cd4b8f, 0x91a6c88c, 0x456cac67, 0xb7072f64, 0xa457dc90, 0x563c5f93,
+    0x082f63b7, 0xfa44e0b4, 0xe9141340, 0x1b7f9043, 0xcfb5f4a8, 0x3dde77ab, 0x2e8e845f, 0xdce5075c,
+    0x92a8fc17, 0x60c37f14, 0x73938ce0, 0x81f80fe3, 0x55326b08, 0xa759e80b, 0xb4091bff, 0x466298fc,
+    0x1871a4d8, 0xea1a27db, 0xf94ad42f, 0x0b21572c, 0xdfeb33c7, 0x2d80b0c4, 0x3ed04330, 0xccbbc033,
+    0xa24bb5a6, 0x502036a5, 0x4370c551, 0xb11b4652, 0x65d122b9, 0x97baa1ba, 0x84ea524e, 0x7681d14d,
+    0x2892ed69, 0xdaf96e6a, 0xc9a99d9e, 0x3bc21e9d, 0xef087a76, 0x1d63f975, 0x0e330a81, 0xfc588982,
+    0xb21572c9, 0x407ef1ca, 0x532e023e, 0xa145813d, 0x758fe5d6, 0x87e466d5, 0x94b49521, 0x66df1622,
+    0x38cc2a06, 0xcaa7a905, 0xd9f75af1, 0x2b9cd9f2, 0xff56bd19, 0x0d3d3e1a, 0x1e6dcdee, 0xec064eed,
+    0xc38d26c4, 0x31e6a5c7, 0x22b65633, 0xd0ddd530, 0x0417b1db, 0xf67c32d8, 0xe52cc12c, 0x1747422f,
+    0x49547e0b, 0xbb3ffd08, 0xa86f0efc, 0x5a048dff, 0x8ecee914, 0x7ca56a17, 0x6ff599e3, 0x9d9e1ae0,
+    0xd3d3e1ab, 0x21b862a8, 0x32e8915c, 0xc083125f, 0x144976b4, 0xe622f5b7, 0xf5720643, 0x07198540,
+    0x590ab964, 0xab613a67, 0xb831c993, 0x4a5a4a90, 0x9e902e7b, 0x6cfbad78, 0x7fab5e8c, 0x8dc0dd8f,
+    0xe330a81a, 0x115b2b19, 0x020bd8ed, 0xf0605bee, 0x24aa3f05, 0xd6c1bc06, 0xc5914ff2, 0x37faccf1,
+    0x69e9f0d5, 0x9b8273d6, 0x88d28022, 0x7ab90321, 0xae7367ca, 0x5c18e4c9, 0x4f48173d, 0xbd23943e,
+    0xf36e6f75, 0x0105ec76, 0x12551f82, 0xe03e9c81, 0x34f4f86a, 0xc69f7b69, 0xd5cf889d, 0x27a40b9e,
+    0x79b737ba, 0x8bdcb4b9, 0x988c474d, 0x6ae7c44e, 0xbe2da0a5, 0x4c4623a6, 0x5f16d052, 0xad7d5351
+};
+
+///// scalar /////
+
+/**
+ * @fn bool is_space(uint8_t c)
+ * @brief ASCII white space (' ', \t, \n, \v, \f, \r)
+ *
+ */
+static inline bool is_space(uint8_t c) {
+    return c == ' ' || (uint8_t) (c - 9) < 5;
+}
+
+/**
+ * @fn size_t scalar_find_byte(const char *s, size_t n, uint8_t c)
+ * @brief Find byte
+ *
+ */
+static size_t scalar_find_byte(const char *s, size_t n, uint8_t c) {
+    const char *p = memchr(s, c, n);
+
+    return p ? (size_t) (p - s) : NF;
+}
+
+/**
+ * @fn size_t scalar_find(const char *s, size_t n, const char *needle, size_t m)
+ * @brief Find substring
+ *
+ */
+static size_t scalar_find(const char *s, size_t n, const char *needle, size_t m) {
+    if (m == 0)
+        return 0;
+    if (m > n)
+        return NF;
+
+    const char *p = s, *end = s + n - m + 1;
+    while ((p = memchr(p, needle[0], end - p)) != NULL) {
+        if (!memcmp(p + 1, needle + 1, m - 1))
+            return p - s;
+        ++p;
+    }
+
+    return NF;
+}
+
+/**
+ * @fn void scalar_case(char *dst, const char *src, size_t n, uint8_t from)
+ * @brief Flip case of ASCII letters from `from` to `from` + 25
+ *
+ */
+static inline void scalar_case(char *dst, const char *src, size_t n, uint8_t from) {
+    for (size_t i = 0; i < n; i++) {
+        const uint8_t c = src[i];
+        dst[i] = ((uint8_t) (c - from) < 26) ? c ^ 0x20 : c;
+    }
+}
+
+/**
+ * @fn void scalar_toupper(char *dst, const char *src, size_t n)
+ * @brief ASCII upper case
+ *
+ */
+static void scalar_toupper(char *dst, const char *src, size_t n) {
+    scalar_case(dst, src, n, 'a');
+}
+
+/**
+ * @fn void scalar_tolower(char *dst, const char *src, size_t n)
+ * @brief ASCII lower case
+ *
+ */
+static void scalar_tolower(char *dst, const char *src, size_t n) {
+    scalar_case(dst, src, n, 'A');
+}
+
+/**
+ * @fn size_t scalar_skip_space(const char *s, size_t n)
+ * @brief Leading white space length
+ *
+ */
+static size_t scalar_skip_space(const char *s, size_t n) {
+    size_t i = 0;
+    while (i < n && is_space(s[i]))
+        ++i;
+
+    return i;
+}
+
+/**
+ * @fn size_t scalar_rskip_space(const char *s, size_t n)
+ * @brief Length without trailing white space
+ *
+ */
+static size_t scalar_rskip_space(const char *s, size_t n) {
+    while (n > 0 && is_space(s[n - 1]))
+        --n;
+
+    return n;
+}
+
+/**
+ * @fn size_t scalar_skip_digits(const char *s, size_t n)
+ * @brief Leading decimal digits length
+ *
+ */
+static size_t scalar_skip_digits(const char *s, size_t n) {
+    size_t i = 0;
+    while (i < n && (uint8_t) (s[i] - '0') < 10)
+        ++i;
+
+    return i;
+}
+
+/**
+ * @fn uint32_t scalar_crc32c(uint32_t crc, const char *s, size_t n)
+ * @brief crc32c update (table driven)
+ *
+ */
+static uint32_t scalar_crc32c(uint32_t crc, const char *s, size_t n) {
+    crc = ~crc;
+    for (size_t i = 0; i < n; i++)
+        crc = crc32c_table[(crc ^ (uint8_t) s[i]) & 0xff] ^ (crc >> 8);
+
+    return ~crc;
+}
+
+/**
+ * @fn size_t scalar_rfind_byte(const char *s, size_t n, uint8_t c)
+ * @brief Find last byte
+ *
+ */
+static size_t scalar_rfind_byte(const char *s, size_t n, uint8_t c) {
+    while (n-- > 0)
+        if ((uint8_t) s[n] == c)
+            return n;
+
+    return NF;
+}
+
+/**
+ * @fn size_t scalar_rfind(const char *s, size_t n, const char *needle, size_t m)
+ * @brief Find last substring
+ *
+ */
+static size_t scalar_rfind(const char *s, size_t n, const char *needle, size_t m) {
+    if (m == 0)
+        return n;
+    if (m > n)
+        return NF;
+
+    for (size_t p = n - m + 1; p-- > 0;)
+        if (s[p] == needle[0] && !memcmp(s + p + 1, needle + 1, m - 1))
+            return p;
+
+    return NF;
+}
+
+/**
+ * @fn size_t scalar_rfind_any(const char *s, size_t n, const char *set, size_t k)
+ * @brief Find last byte of set
+ *
+ */
+static size_t scalar_rfind_any(const char *s, size_t n, const char *set, size_t k) {
+    bool in[256] = { false };
+    for (size_t i = 0; i < k; i++)
+        in[(uint8_t) set[i]] = true;
+
+    while (n-- > 0)
+        if (in[(uint8_t) s[n]])
+            return n;
+
+    return NF;
+}
+
+/**
+ * @fn size_t scalar_span(const char *s, size_t n, const string_byteset_t *set, bool accept)
+ * @brief Length of prefix whose bytes are (accept) or are not (!accept) in set
+ *
+ */
+static size_t scalar_span(const char *s, size_t n, const string_byteset_t *set, bool accept) {
+    for (size_t i = 0; i < n; i++)
+        if (string_byteset_has(set, s[i]) != accept)
+            return i;
+
+    return n;
+}
+
+/**
+ * @fn size_t scalar_count_byte(const char *s, size_t n, uint8_t c)
+ * @brief Count byte
+ *
+ */
+static size_t scalar_count_byte(const char *s, size_t n, uint8_t c) {
+    size_t count = 0;
+
+    for (size_t i = 0; i < n; i++)
+        count += (uint8_t) s[i] == c;
+
+    return count;
+}
+
+/**
+ * @fn size_t scalar_index_byte(const char *s, size_t n, uint8_t c, uint32_t *out, uint32_t base)
+ * @brief Store base + position of every c (out holds count_byte entries)
+ *
+ */
+static size_t scalar_index_byte(const char *s, size_t n, uint8_t c, uint32_t *out, uint32_t base) {
+    const char *p = s, *end = s + n;
+    size_t count = 0;
+
+    while ((p = memchr(p, c, end - p)) != NULL) {
+        out[count++] = base + (p - s);
+        ++p;
+    }
+
+    return count;
+}
+
+/**
+ * @fn void scalar_translate(char *dst, const char *src, size_t n, const uint8_t *table)
+ * @brief Map every byte through a 256 entry table
+ *
+ */
+static void scalar_translate(char *dst, const char *src, size_t n, const uint8_t *table) {
+    for (size_t i = 0; i < n; i++)
+        dst[i] = table[(uint8_t) src[i]];
+}
+
+/**
+ * @fn uint8_t fold(uint8_t c)
+ * @brief ASCII lower case
+ *
+ */
+static inline uint8_t fold(uint8_t c) {
+    return ((uint8_t) (c - 'A') < 26) ? c | 0x20 : c;
+}
+
+/**
+ * @fn bool scalar_equal_nocase(const char *a, const char *b, size_t n)
+ * @brief Compare ignoring ASCII case
+ *
+ */
+static bool scalar_equal_nocase(const char *a, const char *b, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        if (fold(a[i]) != fold(b[i]))
+            return false;
+
+    return true;
+}
+
+/**
+ * @fn size_t scalar_find_nocase(const char *s, size_t n, const char *needle, size_t m)
+ * @brief Find substring ignoring ASCII case
+ *
+ */
+static size_t scalar_find_nocase(const char *s, size_t n, const char *needle, size_t m) {
+    if (m == 0)
+        return 0;
+    if (m > n)
+        return NF;
+
+    const uint8_t first = fold(needle[0]);
+    for (size_t i = 0; i + m <= n; i++)
+        if (fold(s[i]) == first && scalar_equal_nocase(s + i + 1, needle + 1, m - 1))
+            return i;
+
+    return NF;
+}
+
+/**
+ * @fn size_t scalar_find_word(const char *s, size_t n, size_t pos, const char *needle, size_t m, const string_byteset_t *word)
+ * @brief Find needle at or after pos not preceded or followed by a byte of word
+ *
+ */
+static size_t scalar_find_word(const char *s, size_t n, size_t pos, const char *needle, size_t m, const string_byteset_t *word) {
+    if (m == 0)
+        return NF;
+
+    while (pos <= n) {
+        size_t p = scalar_find(s + pos, n - pos, needle, m);
+        if (p == NF)
+            return NF;
+
+        p += pos;
+        if ((p == 0 || !string_byteset_has(word, s[p - 1])) && (p + m == n || !string_byteset_has(word, s[p + m])))
+            return p;
+
+        pos = p + 1;
+    }
+
+    return NF;
+}
+
+/**
+ * @fn bool word_at_start(const char *s, size_t n, const char *needle, size_t m, const string_byteset_t *word)
+ * @brief Whole word needle at position 0 (vector loops start at 1 to load the preceding byte)
+ *
+ */
+static inline bool word_at_start(const char *s, size_t n, const char *needle, size_t m, const string_byteset_t *word) {
+    return m != 0 && m <= n && !memcmp(s, needle, m) && (m == n || !string_byteset_has(word, s[m]));
+}
+
+/**
+ * @fn size_t scalar_mismatch(const char *a, const char *b, size_t n)
+ * @brief Length of common prefix
+ *
+ */
+static size_t scalar_mismatch(const char *a, const char *b, size_t n) {
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        uint64_t x, y;
+        memcpy(&x, a + i, 8);
+        memcpy(&y, b + i, 8);
+        if (x != y)
+            break;
+    }
+
+    while (i < n && a[i] == b[i])
+        ++i;
+
+    return i;
+}
+
+/**
+ * @fn size_t scalar_rmismatch(const char *a, const char *b, size_t n)
+ * @brief Length of common suffix
+ *
+ */
+static size_t scalar_rmismatch(const char *a, const char *b, size_t n) {
+    size_t i = n;
+
+    while (i > 0 && a[i - 1] == b[i - 1])
+        --i;
+
+    return n - i;
+}
+
+#ifdef SIMD_X86
+
+///// sse2 /////
+
+/*
+ * Vector tiers keep the contracts of the scalar kernels. Each loop
+ * handles full vectors and hands the tail to the tier below, except
+ * avx-512 which finishes with masked loads.
+ */
+
+#define SSE2 __attribute__((target("sse2")))
+
+SSE2 static inline __m128i sse2_in_range(__m128i x, uint8_t lo, uint8_t count) {
+    // unsigned (x - lo) < count, via signed compare of the biased value
+    return _mm_cmplt_epi8(_mm_add_epi8(x, _mm_set1_epi8((char) (0x80 - lo))), _mm_set1_epi8((char) (-128 + count)));
+}
+
+SSE2 static inline __m128i sse2_space(__m128i x) {
+    return _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(' ')), sse2_in_range(x, 9, 5));
+}
+
+SSE2 static size_t sse2_find_byte(const char *s, size_t n, uint8_t c) {
+    const __m128i v = _mm_set1_epi8((char) c);
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        const uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) (s + i)), v));
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+
+    const size_t r = scalar_find_byte(s + i, n - i, c);
+
+    return r == NF ? NF : i + r;
+}
+
+SSE2 static size_t sse2_find(const char *s, size_t n, const char *needle, size_t m) {
+    if (m < 2)
+        return m == 0 ? 0 : sse2_find_byte(s, n, needle[0]);
+    if (m > n)
+        return NF;
+
+    // compare first and last needle bytes at once, verify candidates
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[m - 1]);
+    size_t i = 0;
+
+    for (; i + m - 1 + 16 <= n; i += 16) {
+        const __m128i a = _mm_loadu_si128((const __m128i*) (s + i));
+        const __m128i b = _mm_loadu_si128((const __m128i*) (s + i + m - 1));
+        uint32_t mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last)));
+
+        while (mask) {
+            const uint32_t bit = __builtin_ctz(mask);
+            if (!memcmp(s + i + bit + 1, needle + 1, m - 2))
+                return i + bit;
+            mask &= mask - 1;
+        }
+    }
+
+    const size_t r = scalar_find(s + i, n - i, needle, m);
+
+    return r == NF ? NF : i + r;
+}
+
+SSE2 static inline void sse2_case(char *dst, const char *src, size_t n, uint8_t from) {
+    const __m128i flip = _mm_set1_epi8(0x20);
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        const __m128i x = _mm_loadu_si128((const __m128i*) (src + i));
+        _mm_storeu_si128((__m128i*) (dst + i), _mm_xor_si128(x, _mm_and_si128(sse2_in_range(x, from, 26), flip)));
+    }
+
+    scalar_case(dst + i, src + i, n - i, from);
+}
+
+SSE2 static void sse2_toupper(char *dst, const char *src, size_t n) {
+    sse2_case(dst, src, n, 'a');
+}
+
+SSE2 static void sse2_tolower(char *dst, const char *src, size_t n) {
+    sse2_case(dst, src, n, 'A');
+}
+
+SSE2 static void sse2_toupper_padded(char *dst, const char *src, size_t n) {
+    sse2_case(dst, src, (n + 15) & ~(size_t) 15, 'a');
+}
+
+SSE2 static void sse2_tolower_padded(char *dst, const char *src, size_t n) {
+    sse2_case(dst, src, (n + 15) & ~(size_t) 15, 'A');
+}
+
+SSE2 static size_t sse2_skip_space(const char *s, size_t n) {
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        const uint32_t mask = ~_mm_movemask_epi8(sse2_space(_mm_loadu_si128((const __m128i*) (s + i)))) & 0xFFFF;
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+
+    return i + scalar_skip_space(s + i, n - i);
+}
+
+SSE2 static size_t sse2_skip_space_padded(const char *s, size_t n) {
+    const size_t body = n & ~(size_t) 15;
+    const size_t i = sse2_skip_space(s, body);
+
+    if (i < body || body == n)
+        return i;
+
+    const uint32_t mask = ~_mm_movemask_epi8(sse2_space(_mm_loadu_si128((const __m128i*) (s + body)))) & ((1u << (n - body)) - 1);
+
+    return mask ? body + __builtin_ctz(mask) : n;
+}
+
+SSE2 static size_t sse2_rskip_space(const char *s, size_t n) {
+    for (; n >= 16; n -= 16) {
+        const uint32_t mask = ~_mm_movemask_epi8(sse2_space(_mm_loadu_si128((const __m128i*) (s + n - 16)))) & 0xFFFF;
+        if (mask)
+            return n - 16 + (32 - __builtin_clz(mask));
+    }
+
+    return scalar_rskip_space(s, n);
+}
+
+SSE2 static size_t sse2_skip_digits(const char *s, size_t n) {
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        const uint32_t mask = ~_mm_movemask_epi8(sse2_in_range(_mm_loadu_si128((const __m128i*) (s + i)), '0', 10)) & 0xFFFF;
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+
+    return i + scalar_skip_digits(s + i, n - i);
+}
+
+SSE2 static size_t sse2_rfind_byte(const char *s, size_t n, uint8_t c) {
+    const __m128i v = _mm_set1_epi8((char) c);
+
+    for (; n >= 16; n -= 16) {
+        const uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) (s + n - 16)), v));
+        if (mask)
+            return n - 16 + (31 - __builtin_clz(mask));
+    }
+
+    return scalar_rfind_byte(s, n, c);
+}
+
+SSE2 static size_t sse2_rfind(const char *s, size_t n, const char *needle, size_t m) {
+    if (m < 2)
+        return m == 0 ? n : sse2_rfind_byte(s, n, needle[0]);
+    if (m > n)
+        return NF;
+
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[m - 1]);
+    size_t candidates = n - m + 1;
+
+    for (; candidates >= 16; candidates -= 16) {
+        const size_t i = candidates - 16;
+        const __m128i a = _mm_loadu_si128((const __m128i*) (s + i));
+        const __m128i b = _mm_loadu_si128((const __m128i*) (s + i + m - 1));
+        uint32_t mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last)));
+
+        while (mask) {
+            const uint32_t bit = 31 - __builtin_clz(mask);
+            if (!memcmp(s + i + bit + 1, needle + 1, m - 2))
+                return i + bit;
+            mask &= ~((uint32_t) 1 << bit);
+        }
+    }
+
+    return scalar_rfind(s, candidates + m - 1, needle, m);
+}
+
+SSE2 static size_t sse2_rfind_any(const char *s, size_t n, const char *set, size_t k) {
+    if (k == 0)
+        return NF;
+    if (k > 16)
+        return scalar_rfind_any(s, n, set, k);
+
+    for (; n >= 16; n -= 16) {
+        const __m128i x = _mm_loadu_si128((const __m128i*) (s + n - 16));
+        __m128i hit = _mm_setzero_si128();
+        for (size_t j = 0; j < k; j++)
+            hit = _mm_or_si128(hit, _mm_cmpeq_epi8(x, _mm_set1_epi8(set[j])));
+
+        const uint32_t mask = _mm_movemask_epi8(hit);
+        if (mask)
+            return n - 16 + (31 - __builtin_clz(mask));
+    }
+
+    return scalar_rfind_any(s, n, set, k);
+}
+
+SSE2 static size_t sse2_count_byte(const char *s, size_t n, uint8_t c) {
+    const __m128i v = _mm_set1_epi8((char) c);
+    size_t count = 0, i = 0;
+
+    while (i + 16 <= n) {
+        // byte counters absorb at most 255 blocks before they are summed
+        __m128i acc = _mm_setzero_si128();
+        for (int block = 0; block < 255 && i + 16 <= n; block++, i += 16)
+            acc = _mm_sub_epi8(acc, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) (s + i)), v));
+
+        const __m128i sum = _mm_sad_epu8(acc, _mm_setzero_si128());
+        count += (uint32_t) _mm_cvtsi128_si32(sum) + (uint32_t) _mm_cvtsi128_si32(_mm_srli_si128(sum, 8));
+    }
+
+    return count + scalar_count_byte(s + i, n - i, c);
+}
+
+SSE2 static size_t sse2_count_byte_padded(const char *s, size_t n, uint8_t c) {
+    const size_t body = n & ~(size_t) 15;
+    size_t count = sse2_count_byte(s, body, c);
+
+    // last vector reads into the padding, bytes past n are masked out
+    if (body < n) {
+        const uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) (s + body)), _mm_set1_epi8((char) c)));
+        count += __builtin_popcount(mask & ((1u << (n - body)) - 1));
+    }
+
+    return count;
+}
+
+SSE2 static size_t sse2_index_byte(const char *s, size_t n, uint8_t c, uint32_t *out, uint32_t base) {
+    const __m128i v = _mm_set1_epi8((char) c);
+    size_t count = 0, i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) (s + i)), v));
+        for (; mask; mask &= mask - 1)
+            out[count++] = base + i + __builtin_ctz(mask);
+    }
+
+    return count + scalar_index_byte(s + i, n - i, c, out + count, base + i);
+}
+
+SSE2 static inline __m128i sse2_fold(__m128i x) {
+    return _mm_or_si128(x, _mm_and_si128(sse2_in_range(x, 'A', 26), _mm_set1_epi8(0x20)));
+}
+
+SSE2 static bool sse2_equal_nocase(const char *a, const char *b, size_t n) {
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        const __m128i x = sse2_fold(_mm_loadu_si128((const __m128i*) (a + i)));
+        const __m128i y = sse2_fold(_mm_loadu_si128((const __m128i*) (b + i)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xffff)
+            return false;
+    }
+
+    return scalar_equal_nocase(a + i, b + i, n - i);
+}
+
+SSE2 static size_t sse2_find_nocase(const char *s, size_t n, const char *needle, size_t m) {
+    if (m == 0)
+        return 0;
+    if (m > n)
+        return NF;
+
+    // folded first and last needle bytes filter candidates
+    const __m128i first = _mm_set1_epi8((char) fold(needle[0]));
+    const __m128i last = _mm_set1_epi8((char) fold(needle[m - 1]));
+    size_t i = 0;
+
+    for (; i + m - 1 + 16 <= n; i += 16) {
+        const __m128i a = sse2_fold(_mm_loadu_si128((const __m128i*) (s + i)));
+        const __m128i b = sse2_fold(_mm_loadu_si128((const __m128i*) (s + i + m - 1)));
+        uint32_t mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last)));
+
+        for (; mask; mask &= mask - 1) {
+            const uint32_t bit = __builtin_ctz(mask);
+            if (sse2_equal_nocase(s + i + bit, needle, m))
+                return i + bit;
+        }
+    }
+
+    const size_t r = scalar_find_nocase(s + i, n - i, needle, m);
+
+    return r == NF ? NF : i + r;
+}
+
+SSE2 static size_t sse2_mismatch(const char *a, const char *b, size_t n) {
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        const uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) (a + i)), _mm_loadu_si128((const __m128i*) (b + i))));
+        if (mask != 0xffff)
+            return i + __builtin_ctz(~mask);
+    }
+
+    return i + scalar_mismatch(a + i, b + i, n - i);
+}
+
+SSE2 static size_t sse2_rmismatch(const char *a, const char *b, size_t n) {
+    size_t i = n;
+
+    for (; i >= 16; i -= 16) {
+        const uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) (a + i - 16)), _mm_loadu_si128((const __m128i*) (b + i - 16))));
+        if (mask != 0xffff)
+            return n - i + (__builtin_clz(~mask << 16));
+    }
+
+    return n - i + scalar_rmismatch(a, b, i);
+}
+
+///// ssse3 (part of the sse4.2 tier) /////
+
+#define SSSE3 __attribute__((target("ssse3")))
+
+/*
+ * Byte set membership with two pshufb lookups: the low nibble selects a
+ * row of the set (pshufb zeroes lanes with bit 7 set, so each half of
+ * the table only answers for its own bytes) and the high nibble selects
+ * the bit within that row.
+ */
+
+SSSE3 static inline __m128i ssse3_member(__m128i x, __m128i lo, __m128i hi, __m128i bits) {
+    const __m128i row = _mm_or_si128(_mm_shuffle_epi8(lo, x), _mm_shuffle_epi8(hi, _mm_xor_si128(x, _mm_set1_epi8((char) 0x80))));
+    const __m128i bit = _mm_shuffle_epi8(bits, _mm_and_si128(_mm_srli_epi16(x, 4), _mm_set1_epi8(0x0f)));
+
+    return _mm_cmpeq_epi8(_mm_and_si128(row, bit), bit);
+}
+
+SSSE3 static size_t ssse3_span(const char *s, size_t n, const string_byteset_t *set, bool accept) {
+    const __m128i lo = _mm_loadu_si128((const __m128i*) set->lo);
+    const __m128i hi = _mm_loadu_si128((const __m128i*) set->hi);
+    const __m128i bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    const uint32_t flip = accept ? 0xffff : 0;
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        const uint32_t mask = _mm_movemask_epi8(ssse3_member(_mm_loadu_si128((const __m128i*) (s + i)), lo, hi, bits)) ^ flip;
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+
+    return i + scalar_span(s + i, n - i, set, accept);
+}
+
+SSSE3 static size_t ssse3_find_word(const char *s, size_t n, size_t pos, const char *needle, size_t m, const string_byteset_t *word) {
+    if (m == 0 || m > n)
+        return NF;
+    if (pos == 0) {
+        if (word_at_start(s, n, needle, m, word))
+            return 0;
+        pos = 1;
+    }
+
+    const __m128i lo = _mm_loadu_si128((const __m128i*) word->lo);
+    const __m128i hi = _mm_loadu_si128((const __m128i*) word->hi);
+    const __m128i bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[m - 1]);
+    size_t i = pos;
+
+    // candidates must match both ends and have non-word bytes on both sides
+    for (; i + m + 16 <= n; i += 16) {
+        const __m128i ends = _mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) (s + i)), first),
+                _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) (s + i + m - 1)), last));
+        const __m128i inside = _mm_or_si128(ssse3_member(_mm_loadu_si128((const __m128i*) (s + i - 1)), lo, hi, bits),
+                ssse3_member(_mm_loadu_si128((const __m128i*) (s + i + m)), lo, hi, bits));
+        uint32_t mask = _mm_movemask_epi8(_mm_andnot_si128(inside, ends));
+
+        for (; mask; mask &= mask - 1) {
+            const uint32_t bit = __builtin_ctz(mask);
+            if (!memcmp(s + i + bit, needle, m))
+                return i + bit;
+        }
+    }
+
+    return scalar_find_word(s, n, i, needle, m, word);
+}
+
+/*
+ * 256 entry table lookup as 16 pshufb of 16 entry rows. For row h the
+ * index is (x ^ h << 4) + 0x70 saturated: lanes of row h keep their low
+ * nibble with bit 7 clear, every other lane gets bit 7 set and pshufb
+ * returns 0 for it, so the 16 partial results can be or-ed.
+ */
+
+SSSE3 static void ssse3_translate(char *dst, const char *src, size_t n, const uint8_t *table) {
+    __m128i rows[16];
+    size_t i = 0;
+
+    for (int h = 0; h < 16; h++)
+        rows[h] = _mm_loadu_si128((const __m128i*) (table + 16 * h));
+
+    for (; i + 16 <= n; i += 16) {
+        const __m128i x = _mm_loadu_si128((const __m128i*) (src + i));
+        __m128i out = _mm_setzero_si128();
+        for (int h = 0; h < 16; h++) {
+            const __m128i idx = _mm_adds_epu8(_mm_xor_si128(x, _mm_set1_epi8((char) (h << 4))), _mm_set1_epi8(0x70));
+            out = _mm_or_si128(out, _mm_shuffle_epi8(rows[h], idx));
+        }
+        _mm_storeu_si128((__m128i*) (dst + i), out);
+    }
+
+    scalar_translate(dst + i, src + i, n - i, table);
+}
+
+///// sse4.2 /////
+
+__attribute__((target("sse4.2")))
+static uint32_t sse42_crc32c(uint32_t crc, const char *s, size_t n) {
+    crc = ~crc;
+
+#if defined(__x86_64__)
+    for (; n >= 8; n -= 8, s += 8) {
+        uint64_t v;
+        memcpy(&v, s, 8);
+        crc = (uint32_t) _mm_crc32_u64(crc, v);
+    }
+#endif
+
+    for (; n >= 4; n -= 4, s += 4) {
+        uint32_t v;
+        memcpy(&v, s, 4);
+        crc = _mm_crc32_u32(crc, v);
+    }
+
+    for (; n > 0; n--)
+        crc = _mm_crc32_u8(crc, (uint8_t) *s++);
+
+    return ~crc;
+}
+
+///// avx2 /////
+
+#define AVX2 __attribute__((target("avx2")))
+
+AVX2 static inline __m256i avx2_in_range(__m256i x, uint8_t lo, uint8_t count) {
+    return _mm256_cmpgt_epi8(_mm256_set1_epi8((char) (-128 + count)), _mm256_add_epi8(x, _mm256_set1_epi8((char) (0x80 - lo))));
+}
+
+AVX2 static inline __m256i avx2_space(__m256i x) {
+    return _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(' ')), avx2_in_range(x, 9, 5));
+}
+
+AVX2 static size_t avx2_find_byte(const char *s, size_t n, uint8_t c) {
+    const __m256i v = _mm256_set1_epi8((char) c);
+    size_t i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        const uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*) (s + i)), v));
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+
+    // leave the 256 bit state before the SSE tail (avoids the AVX-SSE transition penalty)
+    _mm256_zeroupper();
+    const size_t r = sse2_find_byte(s + i, n - i, c);
+
+    return r == NF ? NF : i + r;
+}
+
+AVX2 static size_t avx2_find(const char *s, size_t n, const char *needle, size_t m) {
+    if (m < 2)
+        return m == 0 ? 0 : avx2_find_byte(s, n, needle[0]);
+    if (m > n)
+        return NF;
+
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[m - 1]);
+    size_t i = 0;
+
+    for (; i + m - 1 + 32 <= n; i += 32) {
+        const __m256i a = _mm256_loadu_si256((const __m256i*) (s + i));
+        const __m256i b = _mm256_loadu_si256((const __m256i*) (s + i + m - 1));
+        uint32_t mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last)));
+
+        while (mask) {
+            const uint32_t bit = __builtin_ctz(mask);
+            if (!memcmp(s + i + bit + 1, needle + 1, m - 2))
+                return i + bit;
+            mask &= mask - 1;
+        }
+    }
+
+    _mm256_zeroupper();
+    const size_t r = sse2_find(s + i, n - i, needle, m);
+
+    return r == NF ? NF : i + r;
+}
+
+AVX2 static inline void avx2_case(char *dst, const char *src, size_t n, uint8_t from) {
+    const __m256i flip = _mm256_set1_epi8(0x20);
+    size_t i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        const __m256i x = _mm256_loadu_si256((const __m256i*) (src + i));
+        _mm256_storeu_si256((__m256i*) (dst + i), _mm256_xor_si256(x, _mm256_and_si256(avx2_in_range(x, from, 26), flip)));
+    }
+
+    _mm256_zeroupper();
+    sse2_case(dst + i, src + i, n - i, from);
+}
+
+AVX2 static void avx2_toupper(char *dst, const char *src, size_t n) {
+    avx2_case(dst, src, n, 'a');
+}
+
+AVX2 static void avx2_tolower(char *dst, const char *src, size_t n) {
+    avx2_case(dst, src, n, 'A');
+}
+
+AVX2 static void avx2_toupper_padded(char *dst, const char *src, size_t n) {
+    avx2_case(dst, src, (n + 31) & ~(size_t) 31, 'a');
+}
+
+AVX2 static void avx2_tolower_padded(char *dst, const char *src, size_t n) {
+    avx2_case(dst, src, (n + 31) & ~(size_t) 31, 'A');
+}
+
+AVX2 static size_t avx2_skip_space(const char *s, size_t n) {
+    size_t i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        const uint32_t mask = ~(uint32_t) _mm256_movemask_epi8(avx2_space(_mm256_loadu_si256((const __m256i*) (s + i))));
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+
+    _mm256_zeroupper();
+    return i + sse2_skip_space(s + i, n - i);
+}
+
+AVX2 static size_t avx2_skip_space_padded(const char *s, size_t n) {
+    const size_t body = n & ~(size_t) 31;
+    const size_t i = avx2_skip_space(s, body);
+
+    if (i < body || body == n)
+        return i;
+
+    const uint32_t mask = ~_mm256_movemask_epi8(avx2_space(_mm256_loadu_si256((const __m256i*) (s + body)))) & ((1u << (n - body)) - 1);
+
+    return mask ? body + __builtin_ctz(mask) : n;
+}
+
+AVX2 static size_t avx2_rskip_space(const char *s, size_t n) {
+    for (; n >= 32; n -= 32) {
+        const uint32_t mask = ~(uint32_t) _mm256_movemask_epi8(avx2_space(_mm256_loadu_si256((const __m256i*) (s + n - 32))));
+        if (mask)
+            return n - 32 + (32 - __builtin_clz(mask));
+    }
+
+    _mm256_zeroupper();
+    return sse2_rskip_space(s, n);
+}
+
+AVX2 static size_t avx2_skip_digits(const char *s, size_t n) {
+    size_t i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        const uint32_t mask = ~(uint32_t) _mm256_movemask_epi8(avx2_in_range(_mm256_loadu_si256((const __m256i*) (s + i)), '0', 10));
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+
+    _mm256_zeroupper();
+    return i + sse2_skip_digits(s + i, n - i);
+}
+
+AVX2 static size_t avx2_rfind_byte(const char *s, size_t n, uint8_t c) {
+    const __m256i v = _mm256_set1_epi8((char) c);
+
+    for (; n >= 32; n -= 32) {
+        const uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*) (s + n - 32)), v));
+        if (mask)
+            return n - 32 + (31 - __builtin_clz(mask));
+    }
+
+    _mm256_zeroupper();
+    return sse2_rfind_byte(s, n, c);
+}
+
+AVX2 static size_t avx2_rfind(const char *s, size_t n, const char *needle, size_t m) {
+    if (m < 2)
+        return m == 0 ? n : avx2_rfind_byte(s, n, needle[0]);
+    if (m > n)
+        return NF;
+
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[m - 1]);
+    size_t candidates = n - m + 1;
+
+    for (; candidates >= 32; candidates -= 32) {
+        const size_t i = candidates - 32;
+        const __m256i a = _mm256_loadu_si256((const __m256i*) (s + i));
+        const __m256i b = _mm256_loadu_si256((const __m256i*) (s + i + m - 1));
+        uint32_t mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last)));
+
+        while (mask) {
+            const uint32_t bit = 31 - __builtin_clz(mask);
+            if (!memcmp(s + i + bit + 1, needle + 1, m - 2))
+                return i + bit;
+            mask &= ~((uint32_t) 1 << bit);
+        }
+    }
+
+    _mm256_zeroupper();
+    return sse2_rfind(s, candidates + m - 1, needle, m);
+}
+
+AVX2 static size_t avx2_rfind_any(const char *s, size_t n, const char *set, size_t k) {
+    if (k == 0)
+        return NF;
+    if (k > 16)
+        return scalar_rfind_any(s, n, set, k);
+
+    for (; n >= 32; n -= 32) {
+        const __m256i x = _mm256_loadu_si256((const __m256i*) (s + n - 32));
+        __m256i hit = _mm256_setzero_si256();
+        for (size_t j = 0; j < k; j++)
+            hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(x, _mm256_set1_epi8(set[j])));
+
+        const uint32_t mask = _mm256_movemask_epi8(hit);
+        if (mask)
+            return n - 32 + (31 - __builtin_clz(mask));
+    }
+
+    _mm256_zeroupper();
+    return sse2_rfind_any(s, n, set, k);
+}
+
+AVX2 static inline __m256i avx2_member(__m256i x, __m256i lo, __m256i hi, __m256i bits) {
+    const __m256i row = _mm256_or_si256(_mm256_shuffle_epi8(lo, x), _mm256_shuffle_epi8(hi, _mm256_xor_si256(x, _mm256_set1_epi8((char) 0x80))));
+    const __m256i bit = _mm256_shuffle_epi8(bits, _mm256_and_si256(_mm256_srli_epi16(x, 4), _mm256_set1_epi8(0x0f)));
+
+    return _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit);
+}
+
+AVX2 static size_t avx2_span(const char *s, size_t n, const string_byteset_t *set, bool accept) {
+    const __m256i lo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) set->lo));
+    const __m256i hi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) set->hi));
+    const __m256i bits = _mm256_broadcastsi128_si256(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128));
+    const uint32_t flip = accept ? 0xffffffff : 0;
+    size_t i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        const __m256i x = _mm256_loadu_si256((const __m256i*) (s + i));
+        const uint32_t mask = (uint32_t) _mm256_movemask_epi8(avx2_member(x, lo, hi, bits)) ^ flip;
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+
+    _mm256_zeroupper();
+    return i + ssse3_span(s + i, n - i, set, accept);
+}
+
+AVX2 static size_t avx2_find_word(const char *s, size_t n, size_t pos, const char *needle, size_t m, const string_byteset_t *word) {
+    if (m == 0 || m > n)
+        return NF;
+    if (pos == 0) {
+        if (word_at_start(s, n, needle, m, word))
+            return 0;
+        pos = 1;
+    }
+
+    const __m256i lo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) word->lo));
+    const __m256i hi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) word->hi));
+    const __m256i bits = _mm256_broadcastsi128_si256(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128));
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[m - 1]);
+    size_t i = pos;
+
+    for (; i + m + 32 <= n; i += 32) {
+        const __m256i ends = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*) (s + i)), first),
+                _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*) (s + i + m - 1)), last));
+        const __m256i inside = _mm256_or_si256(avx2_member(_mm256_loadu_si256((const __m256i*) (s + i - 1)), lo, hi, bits),
+                avx2_member(_mm256_loadu_si256((const __m256i*) (s + i + m)), lo, hi, bits));
+        uint32_t mask = _mm256_movemask_epi8(_mm256_andnot_si256(inside, ends));
+
+        for (; mask; mask &= mask - 1) {
+            const uint32_t bit = __builtin_ctz(mask);
+            if (!memcmp(s + i + bit, needle, m))
+                return i + bit;
+        }
+    }
+
+    _mm256_zeroupper();
+    return ssse3_find_word(s, n, i, needle, m, word);
+}
+
+AVX2 static size_t avx2_count_byte(const char *s, size_t n, uint8_t c) {
+    const __m256i v = _mm256_set1_epi8((char) c);
+    size_t count = 0, i = 0;
+
+    while (i + 32 <= n) {
+        __m256i acc = _mm256_setzero_si256();
+        for (int block = 0; block < 255 && i + 32 <= n; block++, i += 32)
+            acc = _mm256_sub_epi8(acc, _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*) (s + i)), v));
+
+        const __m256i sad = _mm256_sad_epu8(acc, _mm256_setzero_si256());
+        const __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(sad), _mm256_extracti128_si256(sad, 1));
+        count += (uint32_t) _mm_cvtsi128_si32(sum) + (uint32_t) _mm_cvtsi128_si32(_mm_srli_si128(sum, 8));
+    }
+
+    _mm256_zeroupper();
+    return count + sse2_count_byte(s + i, n - i, c);
+}
+
+AVX2 static size_t avx2_count_byte_padded(const char *s, size_t n, uint8_t c) {
+    const size_t body = n & ~(size_t) 31;
+    size_t count = avx2_count_byte(s, body, c);
+
+    if (body < n) {
+        const uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*) (s + body)), _mm256_set1_epi8((char) c)));
+        count += __builtin_popcount(mask & ((1u << (n - body)) - 1));
+    }
+
+    return count;
+}
+
+AVX2 static size_t avx2_index_byte(const char *s, size_t n, uint8_t c, uint32_t *out, uint32_t base) {
+    const __m256i v = _mm256_set1_epi8((char) c);
+    size_t count = 0, i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*) (s + i)), v));
+        for (; mask; mask &= mask - 1)
+            out[count++] = base + i + __builtin_ctz(mask);
+    }
+
+    _mm256_zeroupper();
+    return count + sse2_index_byte(s + i, n - i, c, out + count, base + i);
+}
+
+AVX2 static void avx2_translate(char *dst, const char *src, size_t n, const uint8_t *table) {
+    __m256i rows[16];
+    size_t i = 0;
+
+    for (int h = 0; h < 16; h++)
+        rows[h] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) (table + 16 * h)));
+
+    for (; i + 32 <= n; i += 32) {
+        const __m256i x = _mm256_loadu_si256((const __m256i*) (src + i));
+        __m256i out = _mm256_setzero_si256();
+        for (int h = 0; h < 16; h++) {
+            const __m256i idx = _mm256_adds_epu8(_mm256_xor_si256(x, _mm256_set1_epi8((char) (h << 4))), _mm256_set1_epi8(0x70));
+            out = _mm256_or_si256(out, _mm256_shuffle_epi8(rows[h], idx));
+        }
+        _mm256_storeu_si256((__m256i*) (dst + i), out);
+    }
+
+    _mm256_zeroupper();
+    ssse3_translate(dst + i, src + i, n - i, table);
+}
+
+AVX2 static inline __m256i avx2_fold(__m256i x) {
+    return _mm256_or_si256(x, _mm256_and_si256(avx2_in_range(x, 'A', 26), _mm256_set1_epi8(0x20)));
+}
+
+AVX2 static bool avx2_equal_nocase(const char *a, const char *b, size_t n) {
+    size_t i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        const __m256i x = avx2_fold(_mm256_loadu_si256((const __m256i*) (a + i)));
+        const __m256i y = avx2_fold(_mm256_loadu_si256((const __m256i*) (b + i)));
+        if ((uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)) != 0xffffffff)
+            return false;
+    }
+
+    _mm256_zeroupper();
+    return sse2_equal_nocase(a + i, b + i, n - i);
+}
+
+AVX2 static size_t avx2_find_nocase(const char *s, size_t n, const char *needle, size_t m) {
+    if (m == 0)
+        return 0;
+    if (m > n)
+        return NF;
+
+    const __m256i first = _mm256_set1_epi8((char) fold(needle[0]));
+    const __m256i last = _mm256_set1_epi8((char) fold(needle[m - 1]));
+    size_t i = 0;
+
+    for (; i + m - 1 + 32 <= n; i += 32) {
+        const __m256i a = avx2_fold(_mm256_loadu_si256((const __m256i*) (s + i)));
+        const __m256i b = avx2_fold(_mm256_loadu_si256((const __m256i*) (s + i + m - 1)));
+        uint32_t mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last)));
+
+        for (; mask; mask &= mask - 1) {
+            const uint32_t bit = __builtin_ctz(mask);
+            if (avx2_equal_nocase(s + i + bit, needle, m))
+                return i + bit;
+        }
+    }
+
+    _mm256_zeroupper();
+    const size_t r = sse2_find_nocase(s + i, n - i, needle, m);
+
+    return r == NF ? NF : i + r;
+}
+
+AVX2 static size_t avx2_mismatch(const char *a, const char *b, size_t n) {
+    size_t i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        const uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*) (a + i)), _mm256_loadu_si256((const __m256i*) (b + i))));
+        if (mask != 0xffffffff)
+            return i + __builtin_ctz(~mask);
+    }
+
+    _mm256_zeroupper();
+    return i + sse2_mismatch(a + i, b + i, n - i);
+}
+
+AVX2 static size_t avx2_rmismatch(const char *a, const char *b, size_t n) {
+    size_t i = n;
+
+    for (; i >= 32; i -= 32) {
+        const uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*) (a + i - 32)), _mm256_loadu_si256((const __m256i*) (b + i - 32))));
+        if (mask != 0xffffffff)
+            return n - i + __builtin_clz(~mask);
+    }
+
+    _mm256_zeroupper();
+    return n - i + sse2_rmismatch(a, b, i);
+}
+
+///// avx-512 /////
+
+#define AVX512 __attribute__((target("avx512f,avx512bw")))
+
+/**
+ * @fn __mmask64 avx512_tail(size_t n)
+ * @brief Mask of the first n (< 64) lanes. Masked loads never fault on disabled lanes.
+ *
+ */
+AVX512 static inline __mmask64 avx512_tail(size_t n) {
+    return n >= 64 ? ~(__mmask64) 0 : (((__mmask64) 1 << n) - 1);
+}
+
+AVX512 static inline __mmask64 avx512_in_range(__m512i x, uint8_t lo, uint8_t count) {
+    return _mm512_cmplt_epu8_mask(_mm512_sub_epi8(x, _mm512_set1_epi8((char) lo)), _mm512_set1_epi8((char) count));
+}
+
+AVX512 static inline __mmask64 avx512_space(__m512i x) {
+    return _mm512_cmpeq_epi8_mask(x, _mm512_set1_epi8(' ')) | avx512_in_range(x, 9, 5);
+}
+
+AVX512 static size_t avx512_find_byte(const char *s, size_t n, uint8_t c) {
+    const __m512i v = _mm512_set1_epi8((char) c);
+
+    for (size_t i = 0; i < n; i += 64) {
+        const __mmask64 valid = avx512_tail(n - i);
+        const __mmask64 mask = _mm512_mask_cmpeq_epi8_mask(valid, _mm512_maskz_loadu_epi8(valid, s + i), v);
+        if (mask)
+            return i + __builtin_ctzll(mask);
+    }
+
+    return NF;
+}
+
+AVX512 static size_t avx512_find(const char *s, size_t n, const char *needle, size_t m) {
+    if (m < 2)
+        return m == 0 ? 0 : avx512_find_byte(s, n, needle[0]);
+    if (m > n)
+        return NF;
+
+    const __m512i first = _mm512_set1_epi8(needle[0]);
+    const __m512i last = _mm512_set1_epi8(needle[m - 1]);
+    const size_t candidates = n - m + 1;
+
+    for (size_t i = 0; i < candidates; i += 64) {
+        const __mmask64 valid = avx512_tail(candidates - i);
+        const __m512i a = _mm512_maskz_loadu_epi8(valid, s + i);
+        const __m512i b = _mm512_maskz_loadu_epi8(valid, s + i + m - 1);
+        uint64_t mask = _mm512_mask_cmpeq_epi8_mask(_mm512_mask_cmpeq_epi8_mask(valid, a, first), b, last);
+
+        while (mask) {
+            const uint32_t bit = __builtin_ctzll(mask);
+            if (!memcmp(s + i + bit + 1, needle + 1, m - 2))
+                return i + bit;
+            mask &= mask - 1;
+        }
+    }
+
+    return NF;
+}
+
+AVX512 static inline void avx512_case(char *dst, const char *src, size_t n, uint8_t from) {
+    const __m512i flip = _mm512_set1_epi8(0x20);
+
+    for (size_t i = 0; i < n; i += 64) {
+        const __mmask64 valid = avx512_tail(n - i);
+        const __m512i x = _mm512_maskz_loadu_epi8(valid, src + i);
+        _mm512_mask_storeu_epi8(dst + i, valid, _mm512_xor_si512(x, _mm512_maskz_mov_epi8(avx512_in_range(x, from, 26), flip)));
+    }
+}
+
+AVX512 static void avx512_toupper(char *dst, const char *src, size_t n) {
+    avx512_case(dst, src, n, 'a');
+}
+
+AVX512 static void avx512_tolower(char *dst, const char *src, size_t n) {
+    avx512_case(dst, src, n, 'A');
+}
+
+AVX512 static size_t avx512_skip_space(const char *s, size_t n) {
+    for (size_t i = 0; i < n; i += 64) {
+        const __mmask64 valid = avx512_tail(n - i);
+        const uint64_t mask = valid & ~avx512_space(_mm512_maskz_loadu_epi8(valid, s + i));
+        if (mask)
+            return i + __builtin_ctzll(mask);
+    }
+
+    return n;
+}
+
+AVX512 static size_t avx512_rskip_space(const char *s, size_t n) {
+    for (; n >= 64; n -= 64) {
+        const uint64_t mask = ~avx512_space(_mm512_loadu_si512(s + n - 64));
+        if (mask)
+            return n - 64 + (64 - __builtin_clzll(mask));
+    }
+
+    const __mmask64 valid = avx512_tail(n);
+    const uint64_t mask = valid & ~avx512_space(_mm512_maskz_loadu_epi8(valid, s));
+
+    return mask ? 64 - __builtin_clzll(mask) : 0;
+}
+
+AVX512 static size_t avx512_skip_digits(const char *s, size_t n) {
+    for (size_t i = 0; i < n; i += 64) {
+        const __mmask64 valid = avx512_tail(n - i);
+        const uint64_t mask = valid & ~avx512_in_range(_mm512_maskz_loadu_epi8(valid, s + i), '0', 10);
+        if (mask)
+            return i + __builtin_ctzll(mask);
+    }
+
+    return n;
+}
+
+AVX512 static size_t avx512_rfind_byte(const char *s, size_t n, uint8_t c) {
+    const __m512i v = _mm512_set1_epi8((char) c);
+
+    for (; n >= 64; n -= 64) {
+        const uint64_t mask = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(s + n - 64), v);
+        if (mask)
+            return n - 64 + (63 - __builtin_clzll(mask));
+    }
+
+    const __mmask64 valid = avx512_tail(n);
+    const uint64_t mask = _mm512_mask_cmpeq_epi8_mask(valid, _mm512_maskz_loadu_epi8(valid, s), v);
+
+    return mask ? (size_t) (63 - __builtin_clzll(mask)) : NF;
+}
+
+AVX512 static size_t avx512_rfind(const char *s, size_t n, const char *needle, size_t m) {
+    if (m < 2)
+        return m == 0 ? n : avx512_rfind_byte(s, n, needle[0]);
+    if (m > n)
+        return NF;
+
+    const __m512i first = _mm512_set1_epi8(needle[0]);
+    const __m512i last = _mm512_set1_epi8(needle[m - 1]);
+    size_t candidates = n - m + 1;
+
+    while (candidates > 0) {
+        const size_t i = candidates >= 64 ? candidates - 64 : 0;
+        const __mmask64 valid = avx512_tail(candidates - i);
+        const __m512i a = _mm512_maskz_loadu_epi8(valid, s + i);
+        const __m512i b = _mm512_maskz_loadu_epi8(valid, s + i + m - 1);
+        uint64_t mask = _mm512_mask_cmpeq_epi8_mask(_mm512_mask_cmpeq_epi8_mask(valid, a, first), b, last);
+
+        while (mask) {
+            const uint32_t bit = 63 - __builtin_clzll(mask);
+            if (!memcmp(s + i + bit + 1, needle + 1, m - 2))
+                return i + bit;
+            mask &= ~((uint64_t) 1 << bit);
+        }
+
+        candidates = i;
+    }
+
+    return NF;
+}
+
+AVX512 static size_t avx512_rfind_any(const char *s, size_t n, const char *set, size_t k) {
+    if (k == 0)
+        return NF;
+    if (k > 16)
+        return scalar_rfind_any(s, n, set, k);
+
+    while (n > 0) {
+        const size_t i = n >= 64 ? n - 64 : 0;
+        const __mmask64 valid = avx512_tail(n - i);
+        const __m512i x = _mm512_maskz_loadu_epi8(valid, s + i);
+        uint64_t mask = 0;
+        for (size_t j = 0; j < k; j++)
+            mask |= _mm512_mask_cmpeq_epi8_mask(valid, x, _mm512_set1_epi8(set[j]));
+
+        if (mask)
+            return i + (63 - __builtin_clzll(mask));
+
+        n = i;
+    }
+
+    return NF;
+}
+
+AVX512 static inline __mmask64 avx512_member(__m512i x, __m512i lo, __m512i hi, __m512i bits) {
+    const __m512i row = _mm512_or_si512(_mm512_shuffle_epi8(lo, x), _mm512_shuffle_epi8(hi, _mm512_xor_si512(x, _mm512_set1_epi8((char) 0x80))));
+    const __m512i bit = _mm512_shuffle_epi8(bits, _mm512_and_si512(_mm512_srli_epi16(x, 4), _mm512_set1_epi8(0x0f)));
+
+    return _mm512_test_epi8_mask(row, bit);
+}
+
+AVX512 static size_t avx512_span(const char *s, size_t n, const string_byteset_t *set, bool accept) {
+    const __m512i lo = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*) set->lo));
+    const __m512i hi = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*) set->hi));
+    const __m512i bits = _mm512_broadcast_i32x4(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128));
+
+    for (size_t i = 0; i < n; i += 64) {
+        const __mmask64 valid = avx512_tail(n - i);
+        const __mmask64 member = avx512_member(_mm512_maskz_loadu_epi8(valid, s + i), lo, hi, bits);
+        const __mmask64 mask = (accept ? ~member : member) & valid;
+        if (mask)
+            return i + __builtin_ctzll(mask);
+    }
+
+    return n;
+}
+
+AVX512 static size_t avx512_find_word(const char *s, size_t n, size_t pos, const char *needle, size_t m, const string_byteset_t *word) {
+    if (m == 0 || m > n)
+        return NF;
+    if (pos == 0) {
+        if (word_at_start(s, n, needle, m, word))
+            return 0;
+        pos = 1;
+    }
+
+    const __m512i lo = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*) word->lo));
+    const __m512i hi = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*) word->hi));
+    const __m512i bits = _mm512_broadcast_i32x4(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128));
+    const __m512i first = _mm512_set1_epi8(needle[0]);
+    const __m512i last = _mm512_set1_epi8(needle[m - 1]);
+    const size_t candidates = n - m + 1;
+
+    for (size_t i = pos; i < candidates; i += 64) {
+        const __mmask64 valid = avx512_tail(candidates - i);
+        // the candidate ending the string has no following byte
+        const __mmask64 follows = avx512_tail(candidates - 1 - i);
+        __mmask64 mask = _mm512_mask_cmpeq_epi8_mask(valid, _mm512_maskz_loadu_epi8(valid, s + i), first);
+        mask = _mm512_mask_cmpeq_epi8_mask(mask, _mm512_maskz_loadu_epi8(valid, s + i + m - 1), last);
+        mask &= ~avx512_member(_mm512_maskz_loadu_epi8(valid, s + i - 1), lo, hi, bits);
+        mask &= ~(avx512_member(_mm512_maskz_loadu_epi8(follows, s + i + m), lo, hi, bits) & follows);
+
+        for (; mask; mask &= mask - 1) {
+            const uint32_t bit = __builtin_ctzll(mask);
+            if (!memcmp(s + i + bit, needle, m))
+                return i + bit;
+        }
+    }
+
+    return NF;
+}
+
+AVX512 static size_t avx512_count_byte(const char *s, size_t n, uint8_t c) {
+    const __m512i v = _mm512_set1_epi8((char) c);
+    size_t count = 0;
+
+    for (size_t i = 0; i < n; i += 64) {
+        const __mmask64 valid = avx512_tail(n - i);
+        count += __builtin_popcountll(_mm512_mask_cmpeq_epi8_mask(valid, _mm512_maskz_loadu_epi8(valid, s + i), v));
+    }
+
+    return count;
+}
+
+AVX512 static size_t avx512_index_byte(const char *s, size_t n, uint8_t c, uint32_t *out, uint32_t base) {
+    const __m512i v = _mm512_set1_epi8((char) c);
+    size_t count = 0;
+
+    for (size_t i = 0; i < n; i += 64) {
+        const __mmask64 valid = avx512_tail(n - i);
+        uint64_t mask = _mm512_mask_cmpeq_epi8_mask(valid, _mm512_maskz_loadu_epi8(valid, s + i), v);
+        for (; mask; mask &= mask - 1)
+            out[count++] = base + i + __builtin_ctzll(mask);
+    }
+
+    return count;
+}
+
+AVX512 static void avx512_translate(char *dst, const char *src, size_t n, const uint8_t *table) {
+    __m512i rows[16];
+
+    for (int h = 0; h < 16; h++)
+        rows[h] = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*) (table + 16 * h)));
+
+    for (size_t i = 0; i < n; i += 64) {
+        const __mmask64 valid = avx512_tail(n - i);
+        const __m512i x = _mm512_maskz_loadu_epi8(valid, src + i);
+        __m512i out = _mm512_setzero_si512();
+        for (int h = 0; h < 16; h++) {
+            const __m512i idx = _mm512_adds_epu8(_mm512_xor_si512(x, _mm512_set1_epi8((char) (h << 4))), _mm512_set1_epi8(0x70));
+            out = _mm512_or_si512(out, _mm512_shuffle_epi8(rows[h], idx));
+        }
+        _mm512_mask_storeu_epi8(dst + i, valid, out);
+    }
+}
+
+AVX512 static inline __m512i avx512_fold(__m512i x) {
+    // upper case letters have bit 5 clear, adding sets it
+    return _mm512_mask_add_epi8(x, avx512_in_range(x, 'A', 26), x, _mm512_set1_epi8(0x20));
+}
+
+AVX512 static bool avx512_equal_nocase(const char *a, const char *b, size_t n) {
+    for (size_t i = 0; i < n; i += 64) {
+        const __mmask64 valid = avx512_tail(n - i);
+        const __m512i x = avx512_fold(_mm512_maskz_loadu_epi8(valid, a + i));
+        const __m512i y = avx512_fold(_mm512_maskz_loadu_epi8(valid, b + i));
+        if (_mm512_cmpneq_epi8_mask(x, y))
+            return false;
+    }
+
+    return true;
+}
+
+AVX512 static size_t avx512_find_nocase(const char *s, size_t n, const char *needle, size_t m) {
+    if (m == 0)
+        return 0;
+    if (m > n)
+        return NF;
+
+    const __m512i first = _mm512_set1_epi8((char) fold(needle[0]));
+    const __m512i last = _mm512_set1_epi8((char) fold(needle[m - 1]));
+    const size_t candidates = n - m + 1;
+
+    for (size_t i = 0; i < candidates; i += 64) {
+        const __mmask64 valid = avx512_tail(candidates - i);
+        const __m512i a = avx512_fold(_mm512_maskz_loadu_epi8(valid, s + i));
+        const __m512i b = avx512_fold(_mm512_maskz_loadu_epi8(valid, s + i + m - 1));
+        uint64_t mask = _mm512_mask_cmpeq_epi8_mask(_mm512_mask_cmpeq_epi8_mask(valid, a, first), b, last);
+
+        for (; mask; mask &= mask - 1) {
+            const uint32_t bit = __builtin_ctzll(mask);
+            if (avx512_equal_nocase(s + i + bit, needle, m))
+                return i + bit;
+        }
+    }
+
+    return NF;
+}
+
+AVX512 static size_t avx512_mismatch(const char *a, const char *b, size_t n) {
+    for (size_t i = 0; i < n; i += 64) {
+        const __mmask64 valid = avx512_tail(n - i);
+        const uint64_t mask = _mm512_mask_cmpneq_epi8_mask(valid, _mm512_maskz_loadu_epi8(valid, a + i), _mm512_maskz_loadu_epi8(valid, b + i));
+        if (mask)
+            return i + __builtin_ctzll(mask);
+    }
+
+    return n;
+}
+
+AVX512 static size_t avx512_rmismatch(const char *a, const char *b, size_t n) {
+    size_t i = n;
+
+    while (i > 0) {
+        const size_t from = i >= 64 ? i - 64 : 0;
+        const __mmask64 valid = avx512_tail(i - from);
+        const uint64_t mask = _mm512_mask_cmpneq_epi8_mask(valid, _mm512_maskz_loadu_epi8(valid, a + from), _mm512_maskz_loadu_epi8(valid, b + from));
+        if (mask)
+            return n - (from + 64 - __builtin_clzll(mask));
+        i = from;
+    }
+
+    return n;
+}
+
+#endif /* SIMD_X86 */
+
+///// dispatch /////
+
+/**
+ * @var kernels
+ * @brief Kernel tables by tier
+ *
+ */
+static const string_simd_kernels_t kernels[] = {
+    [SIMD_SCALAR] = {
+        .tier = SIMD_SCALAR,
+        .find_byte = scalar_find_byte,
+        .find = scalar_find,
+        .rfind_byte = scalar_rfind_byte,
+        .rfind = scalar_rfind,
+        .rfind_any = scalar_rfind_any,
+        .span = scalar_span,
+        .count_byte = scalar_count_byte,
+        .index_byte = scalar_index_byte,
+        .translate = scalar_translate,
+        .find_nocase = scalar_find_nocase,
+        .equal_nocase = scalar_equal_nocase,
+        .find_word = scalar_find_word,
+        .mismatch = scalar_mismatch,
+        .rmismatch = scalar_rmismatch,
+        .count_byte_padded = scalar_count_byte,
+        .skip_space_padded = scalar_skip_space,
+        .to_upper_padded = scalar_toupper,
+        .to_lower_padded = scalar_tolower,
+        .to_upper = scalar_toupper,
+        .to_lower = scalar_tolower,
+        .skip_space = scalar_skip_space,
+        .rskip_space = scalar_rskip_space,
+        .skip_digits = scalar_skip_digits,
+        .crc32c = scalar_crc32c,
+    },
+#ifdef SIMD_X86
+    [SIMD_SSE2] = {
+        .tier = SIMD_SSE2,
+        .find_byte = sse2_find_byte,
+        .find = sse2_find,
+        .rfind_byte = sse2_rfind_byte,
+        .rfind = sse2_rfind,
+        .rfind_any = sse2_rfind_any,
+        .span = scalar_span,
+        .count_byte = sse2_count_byte,
+        .index_byte = sse2_index_byte,
+        .translate = scalar_translate,
+        .find_nocase = sse2_find_nocase,
+        .equal_nocase = sse2_equal_nocase,
+        .find_word = scalar_find_word,
+        .mismatch = sse2_mismatch,
+        .rmismatch = sse2_rmismatch,
+        .count_byte_padded = sse2_count_byte_padded,
+        .skip_space_padded = sse2_skip_space_padded,
+        .to_upper_padded = sse2_toupper_padded,
+        .to_lower_padded = sse2_tolower_padded,
+        .to_upper = sse2_toupper,
+        .to_lower = sse2_tolower,
+        .skip_space = sse2_skip_space,
+        .rskip_space = sse2_rskip_space,
+        .skip_digits = sse2_skip_digits,
+        .crc32c = scalar_crc32c,
+    },
+    [SIMD_SSE42] = {
+        .tier = SIMD_SSE42,
+        .find_byte = sse2_find_byte,
+        .find = sse2_find,
+        .rfind_byte = sse2_rfind_byte,
+        .rfind = sse2_rfind,
+        .rfind_any = sse2_rfind_any,
+        .span = ssse3_span,
+        .count_byte = sse2_count_byte,
+        .index_byte = sse2_index_byte,
+        .translate = ssse3_translate,
+        .find_nocase = sse2_find_nocase,
+        .equal_nocase = sse2_equal_nocase,
+        .find_word = ssse3_find_word,
+        .mismatch = sse2_mismatch,
+        .rmismatch = sse2_rmismatch,
+        .count_byte_padded = sse2_count_byte_padded,
+        .skip_space_padded = sse2_skip_space_padded,
+        .to_upper_padded = sse2_toupper_padded,
+        .to_lower_padded = sse2_tolower_padded,
+        .to_upper = sse2_toupper,
+        .to_lower = sse2_tolower,
+        .skip_space = sse2_skip_space,
+        .rskip_space = sse2_rskip_space,
+        .skip_digits = sse2_skip_digits,
+        .crc32c = sse42_crc32c,
+    },
+    [SIMD_AVX2] = {
+        .tier = SIMD_AVX2,
+        .find_byte = avx2_find_byte,
+        .find = avx2_find,
+        .rfind_byte = avx2_rfind_byte,
+        .rfind = avx2_rfind,
+        .rfind_any = avx2_rfind_any,
+        .span = avx2_span,
+        .count_byte = avx2_count_byte,
+        .index_byte = avx2_index_byte,
+        .translate = avx2_translate,
+        .find_nocase = avx2_find_nocase,
+        .equal_nocase = avx2_equal_nocase,
+        .find_word = avx2_find_word,
+        .mismatch = avx2_mismatch,
+        .rmismatch = avx2_rmismatch,
+        .count_byte_padded = avx2_count_byte_padded,
+        .skip_space_padded = avx2_skip_space_padded,
+        .to_upper_padded = avx2_toupper_padded,
+        .to_lower_padded = avx2_tolower_padded,
+        .to_upper = avx2_toupper,
+        .to_lower = avx2_tolower,
+        .skip_space = avx2_skip_space,
+        .rskip_space = avx2_rskip_space,
+        .skip_digits = avx2_skip_digits,
+        .crc32c = sse42_crc32c,
+    },
+    [SIMD_AVX512] = {
+        .tier = SIMD_AVX512,
+        .find_byte = avx512_find_byte,
+        .find = avx512_find,
+        .rfind_byte = avx512_rfind_byte,
+        .rfind = avx512_rfind,
+        .rfind_any = avx512_rfind_any,
+        .span = avx512_span,
+        .count_byte = avx512_count_byte,
+        .index_byte = avx512_index_byte,
+        .translate = avx512_translate,
+        .find_nocase = avx512_find_nocase,
+        .equal_nocase = avx512_equal_nocase,
+        .find_word = avx512_find_word,
+        .mismatch = avx512_mismatch,
+        .rmismatch = avx512_rmismatch,
+        .count_byte_padded = avx512_count_byte,
+        .skip_space_padded = avx512_skip_space,
+        .to_upper_padded = avx512_toupper,
+        .to_lower_padded = avx512_tolower,
+        .to_upper = avx512_toupper,
+        .to_lower = avx512_tolower,
+        .skip_space = avx512_skip_space,
+        .rskip_space = avx512_rskip_space,
+        .skip_digits = avx512_skip_digits,
+        .crc32c = sse42_crc32c,
+    },
+#endif
+};
+
+const string_simd_kernels_t *string_simd = &kernels[SIMD_SCALAR];
+
+/**
+ * @fn uint8_t string_simd_detected(void)
+ * @brief Best tier supported by cpu and operating system
+ *
+ * @return enum STRING_SIMD_TIER
+ */
+uint8_t string_simd_detected(void) {
+#ifdef SIMD_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512f"))
+        return SIMD_AVX512;
+    if (__builtin_cpu_supports("avx2"))
+        return SIMD_AVX2;
+    if (__builtin_cpu_supports("sse4.2"))
+        return SIMD_SSE42;
+    if (__builtin_cpu_supports("sse2"))
+        return SIMD_SSE2;
+#endif
+
+    return SIMD_SCALAR;
+}
+
+/**
+ * @fn uint8_t string_simd_tier(void)
+ * @brief Active tier
+ *
+ * @return enum STRING_SIMD_TIER
+ */
+uint8_t string_simd_tier(void) {
+    return string_simd->tier;
+}
+
+/**
+ * @fn bool string_simd_force(uint8_t tier)
+ * @brief Select tier (for benchmarking). Not thread safe: call before using strings concurrently.
+ *
+ * @param tier enum STRING_SIMD_TIER
+ * @return Boolean (false: tier not supported)
+ */
+bool string_simd_force(uint8_t tier) {
+    if (tier > string_simd_detected())
+        return false;
+
+    string_simd = &kernels[tier];
+
+    return true;
+}
+
+#if defined(__GNUC__)
+/**
+ * @fn void simd_init(void)
+ * @brief Detect cpu once at startup. STRINGS_SIMD environment variable caps the tier.
+ *
+ */
+__attribute__((constructor))
+static void simd_init(void) {
+    static const char *names[] = { "scalar", "sse2", "sse4.2", "avx2", "avx512" };
+    uint8_t tier = string_simd_detected();
+    const char *env = getenv(STRING_SIMD_ENV);
+
+    if (env != NULL) {
+        for (uint8_t n = 0; n < sizeof(names) / sizeof(names[0]); n++) {
+            if (!strcmp(env, names[n]) && n < tier)
+                tier = n;
+        }
+    }
+
+    string_simd = &kernels[tier];
+}
+#endif
@@ -0,0 +1,112 @@
+/**
+ * @file strings_simd.h
+ * @brief runtime cpu dispatch of simd kernels
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef STRINGS_SIMD_H_
+#define STRINGS_SIMD_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @def STRING_SIMD_ENV
+ * @brief Environment variable forcing a tier (scalar, sse2, sse4.2, avx2, avx512)
+ *
+ */
+#define STRING_SIMD_ENV "STRINGS_SIMD"
+
+/**
+ * @def STRING_SIMD_NOT_FOUND
+ * @brief Kernel search result when there is no match
+ *
+ */
+#define STRING_SIMD_NOT_FOUND SIZE_MAX
+
+/**
+ * @enum STRING_SIMD_TIER
+ * @brief Instruction set tiers
+ *
+ */
+enum STRING_SIMD_TIER {
+    SIMD_SCALAR, /**< portable C >**/
+    SIMD_SSE2,   /**< 16 byte vectors >**/
+    SIMD_SSE42,  /**< SSE2 plus hardware crc32c >**/
+    SIMD_AVX2,   /**< 32 byte vectors >**/
+    SIMD_AVX512  /**< 64 byte vectors (AVX-512BW) >**/
+};
+
+struct string_byteset_s;
+
+/**
+ * @struct string_simd_kernels_s
+ * @brief Kernels of one tier. Byte classes are ASCII (C locale).
+ *
+ */
+struct string_simd_kernels_s {
+       uint8_t tier;                                                               /**< enum STRING_SIMD_TIER >**/
+        size_t (*find_byte)(const char *s, size_t n, uint8_t c);                   /**< first c or STRING_SIMD_NOT_FOUND >**/
+        size_t (*find)(const char *s, size_t n, const char *needle, size_t m);     /**< first needle or STRING_SIMD_NOT_FOUND >**/
+        size_t (*rfind_byte)(const char *s, size_t n, uint8_t c);                  /**< last c or STRING_SIMD_NOT_FOUND >**/
+        size_t (*rfind)(const char *s, size_t n, const char *needle, size_t m);    /**< last needle or STRING_SIMD_NOT_FOUND >**/
+        size_t (*find_nocase)(const char *s, size_t n, const char *needle, size_t m); /**< first needle ignoring ASCII case or STRING_SIMD_NOT_FOUND >**/
+          bool (*equal_nocase)(const char *a, const char *b, size_t n);            /**< equal ignoring ASCII case >**/
+        size_t (*find_word)(const char *s, size_t n, size_t pos, const char *needle, size_t m, const struct string_byteset_s *word); /**< first needle at or after pos bounded by bytes not in word >**/
+        size_t (*mismatch)(const char *a, const char *b, size_t n);                /**< common prefix length >**/
+        size_t (*rmismatch)(const char *a, const char *b, size_t n);               /**< common suffix length >**/
+        size_t (*rfind_any)(const char *s, size_t n, const char *set, size_t k);   /**< last byte of set or STRING_SIMD_NOT_FOUND >**/
+        size_t (*span)(const char *s, size_t n, const struct string_byteset_s *set, bool accept); /**< leading bytes whose membership is accept >**/
+        size_t (*count_byte)(const char *s, size_t n, uint8_t c);                  /**< occurrences of c >**/
+        size_t (*index_byte)(const char *s, size_t n, uint8_t c, uint32_t *out, uint32_t base); /**< store base + position of every c, return count >**/
+          void (*translate)(char *dst, const char *src, size_t n, const uint8_t *table); /**< dst[i] = table[src[i]] (256 entries, dst may be src) >**/
+        size_t (*count_byte_padded)(const char *s, size_t n, uint8_t c);           /**< count_byte, s readable STRING_PAD bytes past n (String data) >**/
+        size_t (*skip_space_padded)(const char *s, size_t n);                      /**< skip_space, s readable STRING_PAD bytes past n (String data) >**/
+          void (*to_upper_padded)(char *dst, const char *src, size_t n);            /**< to_upper, src readable and dst writable STRING_PAD bytes past n >**/
+          void (*to_lower_padded)(char *dst, const char *src, size_t n);            /**< to_lower, src readable and dst writable STRING_PAD bytes past n >**/
+          void (*to_upper)(char *dst, const char *src, size_t n);                   /**< ASCII upper case (dst may be src) >**/
+          void (*to_lower)(char *dst, const char *src, size_t n);                   /**< ASCII lower case (dst may be src) >**/
+        size_t (*skip_space)(const char *s, size_t n);                             /**< leading white space length >**/
+        size_t (*rskip_space)(const char *s, size_t n);                            /**< length without trailing white space >**/
+        size_t (*skip_digits)(const char *s, size_t n);                            /**< leading decimal digits length >**/
+      uint32_t (*crc32c)(uint32_t crc, const char *s, size_t n);                   /**< crc32c update >**/
+};
+typedef struct string_simd_kernels_s string_simd_kernels_t; /**< kernel table type >**/
+
+/**
+ * @var string_simd
+ * @brief Active kernel table (scalar until cpu detection runs at startup)
+ *
+ */
+extern const string_simd_kernels_t *string_simd;
+
+uint8_t string_simd_tier(void);
+uint8_t string_simd_detected(void);
+   bool string_simd_force(uint8_t tier);
+
+#endif /* STRINGS_SIMD_H_ */
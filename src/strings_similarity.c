@@ -0,0 +1,433 @@
+/**
+ * @file strings_similarity.c
+ * @brief similarity hashing (minhash, simhash, lsh) over strings
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "strings.h"
+#include "strings_internal.h"
+#include "strings_similarity.h"
+
+/**
+ * @def LSH_NONE
+ * @brief end of LSH bucket chain
+ *
+ */
+#define LSH_NONE UINT32_MAX
+
+/**
+ * @fn bool string_shingle_iter(string_shingle_iter_t *it, const String buf, uint8_t mode, uint32_t n, const char *sep)
+ * @brief Start iterating shingles of buf. A string shorter than one shingle yields itself once.
+ *
+ * @param it Shingle iterator
+ * @param buf Buffered string
+ * @param mode enum STRING_SHINGLE_MODE
+ * @param n Bytes or words per shingle (words: up to STRING_SHINGLE_MAX)
+ * @param sep Word separator (SHINGLE_WORDS only)
+ * @return Boolean (false: bad arguments)
+ */
+bool string_shingle_iter(string_shingle_iter_t *it, const String buf, uint8_t mode, uint32_t n, const char *sep) {
+    if (it == NULL || buf == NULL || n == 0)
+        return false;
+
+    if (mode == SHINGLE_WORDS && (n > STRING_SHINGLE_MAX || sep == NULL || *sep == '\0'))
+        return false;
+
+    it->buf = string_view(buf);
+    it->mode = mode;
+    it->n = n;
+    it->pos = 0;
+    it->nwords = 0;
+    it->emitted = false;
+
+    if (mode == SHINGLE_WORDS)
+        string_split_iter(&it->split, buf, sep);
+
+    return true;
+}
+
+/**
+ * @fn bool string_shingle_next(string_shingle_iter_t *it, string_view_t *shingle)
+ * @brief Next shingle. Word shingles span from the first word to the last one, separators included.
+ *
+ * @param it Shingle iterator
+ * @param shingle String view
+ * @return Boolean (false: no more shingles)
+ */
+bool string_shingle_next(string_shingle_iter_t *it, string_view_t *shingle) {
+    if (it == NULL || shingle == NULL)
+        return false;
+
+    if (it->mode == SHINGLE_BYTES) {
+        if (it->buf.length < it->n) {
+            if (it->emitted || it->buf.length == 0)
+                return false;
+
+            *shingle = it->buf;
+            it->emitted = true;
+            return true;
+        }
+
+        if (it->pos > it->buf.length - it->n)
+            return false;
+
+        shingle->data = it->buf.data + it->pos++;
+        shingle->length = it->n;
+        it->emitted = true;
+        return true;
+    }
+
+    string_view_t word;
+    while (string_split_next(&it->split, &word)) {
+        if (word.length == 0)
+            continue;
+
+        it->words[it->nwords % it->n] = word;
+        ++it->nwords;
+
+        if (it->nwords >= it->n) {
+            const string_view_t first = it->words[it->nwords % it->n];
+            shingle->data = first.data;
+            shingle->length = word.data + word.length - first.data;
+            it->emitted = true;
+            return true;
+        }
+    }
+
+    if (it->emitted || it->nwords == 0)
+        return false;
+
+    // fewer words than a shingle: the whole text
+    shingle->data = it->words[0].data;
+    shingle->length = it->words[it->nwords - 1].data + it->words[it->nwords - 1].length - it->words[0].data;
+    it->emitted = true;
+
+    return true;
+}
+
+/**
+ * @fn bool string_minhash(const String buf, uint8_t mode, uint32_t n, const char *sep, uint8_t key[16], uint64_t *signature, uint32_t k)
+ * @brief MinHash signature of the shingle set of buf.
+ *        Each shingle is hashed once (128 bit siphash); the k permutations are derived from both halves.
+ *
+ * @param buf Buffered string
+ * @param mode enum STRING_SHINGLE_MODE
+ * @param n Shingle size
+ * @param sep Word separator
+ * @param key Siphash key
+ * @param signature Array of k values
+ * @param k Signature length
+ * @return Boolean (false: bad arguments)
+ */
+bool string_minhash(const String buf, uint8_t mode, uint32_t n, const char *sep, uint8_t key[16], uint64_t *signature, uint32_t k) {
+    string_shingle_iter_t it;
+    string_view_t shingle;
+
+    if (key == NULL || signature == NULL || k == 0 || !string_shingle_iter(&it, buf, mode, n, sep))
+        return false;
+
+    for (uint32_t i = 0; i < k; i++)
+        signature[i] = UINT64_MAX;
+
+    while (string_shingle_next(&it, &shingle)) {
+        uint64_t h1, h2;
+        string_hash128_view(shingle, key, &h1, &h2);
+        h2 |= 1;
+
+        // branch-free min over all permutations (vectorizable)
+        for (uint32_t i = 0; i < k; i++) {
+            const uint64_t v = string_mix64(h1 + i * h2);
+            signature[i] = (v < signature[i]) ? v : signature[i];
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @fn double string_minhash_similarity(const uint64_t *sig1, const uint64_t *sig2, uint32_t k)
+ * @brief Estimated Jaccard similarity of two signatures
+ *
+ * @param sig1 Signature
+ * @param sig2 Signature
+ * @param k Signature length
+ * @return Similarity (0..1)
+ */
+double string_minhash_similarity(const uint64_t *sig1, const uint64_t *sig2, uint32_t k) {
+    if (sig1 == NULL || sig2 == NULL || k == 0)
+        return 0;
+
+    uint32_t equal = 0;
+    for (uint32_t i = 0; i < k; i++)
+        equal += sig1[i] == sig2[i];
+
+    return (double) equal / k;
+}
+
+/**
+ * @fn uint64_t string_simhash(const String buf, uint8_t mode, uint32_t n, const char *sep, uint8_t key[16])
+ * @brief 64 bit SimHash fingerprint of the shingles of buf
+ *
+ * @param buf Buffered string
+ * @param mode enum STRING_SHINGLE_MODE
+ * @param n Shingle size
+ * @param sep Word separator
+ * @param key Siphash key
+ * @return Fingerprint (0 on bad arguments)
+ */
+uint64_t string_simhash(const String buf, uint8_t mode, uint32_t n, const char *sep, uint8_t key[16]) {
+    string_shingle_iter_t it;
+    string_view_t shingle;
+    int32_t weights[64] = { 0 };
+
+    if (key == NULL || !string_shingle_iter(&it, buf, mode, n, sep))
+        return 0;
+
+    while (string_shingle_next(&it, &shingle)) {
+        const uint64_t h = string_hash64_view(shingle, key);
+
+        for (int b = 0; b < 64; b++)
+            weights[b] += (int32_t) ((h >> b) & 1) * 2 - 1;
+    }
+
+    uint64_t fingerprint = 0;
+    for (int b = 0; b < 64; b++)
+        fingerprint |= (uint64_t) (weights[b] > 0) << b;
+
+    return fingerprint;
+}
+
+/**
+ * @fn uint32_t string_simhash_distance(uint64_t a, uint64_t b)
+ * @brief Hamming distance of two fingerprints
+ *
+ * @param a Fingerprint
+ * @param b Fingerprint
+ * @return Differing bits
+ */
+uint32_t string_simhash_distance(uint64_t a, uint64_t b) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(a ^ b);
+#else
+    uint64_t x = a ^ b;
+    uint32_t count = 0;
+    for (; x; x &= x - 1)
+        ++count;
+
+    return count;
+#endif
+}
+
+///// lsh /////
+
+/**
+ * @fn uint64_t lsh_band_key(const string_lsh_t *lsh, const uint64_t *signature, uint32_t band)
+ * @brief Hash of one band of a signature
+ *
+ */
+static uint64_t lsh_band_key(const string_lsh_t *lsh, const uint64_t *signature, uint32_t band) {
+    uint64_t key = string_mix64(band + 1);
+    const uint64_t *v = signature + (size_t) band * lsh->rows;
+
+    for (uint32_t r = 0; r < lsh->rows; r++)
+        key = string_mix64(key ^ v[r]);
+
+    return key;
+}
+
+/**
+ * @fn bool lsh_rehash(string_lsh_t *lsh, uint32_t buckets)
+ * @brief Rebuild bucket chains
+ *
+ */
+static bool lsh_rehash(string_lsh_t *lsh, uint32_t buckets) {
+    uint32_t *heads = malloc(buckets * sizeof(uint32_t));
+    if (heads == NULL)
+        return false;
+
+    memset(heads, 0xff, buckets * sizeof(uint32_t));
+    for (uint32_t e = 0; e < lsh->len; e++) {
+        const uint32_t b = lsh->entries[e].key & (buckets - 1);
+        lsh->entries[e].next = heads[b];
+        heads[b] = e;
+    }
+
+    free(lsh->heads);
+    lsh->heads = heads;
+    lsh->mask = buckets - 1;
+
+    return true;
+}
+
+/**
+ * @fn string_lsh_t* string_lsh_new(uint32_t bands, uint32_t rows)
+ * @brief Allocate a LSH index for signatures of at least bands * rows values
+ *
+ * @param bands Bands
+ * @param rows Values per band
+ * @return LSH index|NULL
+ */
+string_lsh_t* string_lsh_new(uint32_t bands, uint32_t rows) {
+    if (bands == 0 || rows == 0)
+        return NULL;
+
+    string_lsh_t *lsh = calloc(1, sizeof(string_lsh_t));
+    if (lsh == NULL)
+        return NULL;
+
+    lsh->bands = bands;
+    lsh->rows = rows;
+
+    if (!lsh_rehash(lsh, 1024)) {
+        free(lsh);
+        return NULL;
+    }
+
+    return lsh;
+}
+
+/**
+ * @fn void string_lsh_free(string_lsh_t *lsh)
+ * @brief Free LSH index
+ *
+ * @param lsh LSH index
+ */
+void string_lsh_free(string_lsh_t *lsh) {
+    if (lsh == NULL)
+        return;
+
+    free(lsh->entries);
+    free(lsh->heads);
+    free(lsh);
+}
+
+/**
+ * @fn bool string_lsh_add(string_lsh_t *lsh, const uint64_t *signature, uint32_t id)
+ * @brief Index a document signature
+ *
+ * @param lsh LSH index
+ * @param signature MinHash signature
+ * @param id Document id
+ * @return Boolean (false: allocation error)
+ */
+bool string_lsh_add(string_lsh_t *lsh, const uint64_t *signature, uint32_t id) {
+    if (lsh == NULL || signature == NULL)
+        return false;
+
+    if (lsh->len + lsh->bands > lsh->cap) {
+        if (lsh->len > UINT32_MAX / 2 - lsh->bands)
+            return false;
+
+        const uint32_t cap = (lsh->cap ? lsh->cap * 2 : 1024) + lsh->bands;
+        string_lsh_entry_t *entries = realloc(lsh->entries, cap * sizeof(string_lsh_entry_t));
+        if (entries == NULL)
+            return false;
+
+        lsh->entries = entries;
+        lsh->cap = cap;
+    }
+
+    for (uint32_t b = 0; b < lsh->bands; b++) {
+        string_lsh_entry_t *e = &lsh->entries[lsh->len];
+        e->key = lsh_band_key(lsh, signature, b);
+        e->id = id;
+        e->next = lsh->heads[e->key & lsh->mask];
+        lsh->heads[e->key & lsh->mask] = lsh->len++;
+    }
+
+    if (lsh->len > lsh->mask + 1)
+        lsh_rehash(lsh, (lsh->mask + 1) * 2);
+
+    return true;
+}
+
+/**
+ * @fn int lsh_id_cmp(const void *a, const void *b)
+ * @brief Order ids
+ *
+ */
+static int lsh_id_cmp(const void *a, const void *b) {
+    const uint32_t ia = *(const uint32_t*) a, ib = *(const uint32_t*) b;
+
+    return (ia > ib) - (ia < ib);
+}
+
+/**
+ * @fn uint32_t lsh_unique(uint32_t *ids, uint32_t len)
+ * @brief Sort ids and drop duplicates
+ *
+ */
+static uint32_t lsh_unique(uint32_t *ids, uint32_t len) {
+    qsort(ids, len, sizeof(uint32_t), lsh_id_cmp);
+
+    uint32_t u = 0;
+    for (uint32_t n = 0; n < len; n++)
+        if (u == 0 || ids[u - 1] != ids[n])
+            ids[u++] = ids[n];
+
+    return u;
+}
+
+/**
+ * @fn uint32_t string_lsh_query(const string_lsh_t *lsh, const uint64_t *signature, uint32_t *ids, uint32_t max)
+ * @brief Candidate documents sharing at least one band with signature
+ *
+ * @param lsh LSH index
+ * @param signature MinHash signature
+ * @param ids Array of max ids (sorted, unique)
+ * @param max Array size
+ * @return Candidates written
+ */
+uint32_t string_lsh_query(const string_lsh_t *lsh, const uint64_t *signature, uint32_t *ids, uint32_t max) {
+    if (lsh == NULL || signature == NULL || ids == NULL)
+        return 0;
+
+    uint32_t len = 0;
+    for (uint32_t b = 0; b < lsh->bands; b++) {
+        const uint64_t key = lsh_band_key(lsh, signature, b);
+
+        for (uint32_t e = lsh->heads[key & lsh->mask]; e != LSH_NONE; e = lsh->entries[e].next) {
+            if (lsh->entries[e].key != key)
+                continue;
+
+            if (len == max) {
+                // compact duplicates before giving up
+                len = lsh_unique(ids, len);
+                if (len == max)
+                    return len;
+            }
+
+            ids[len++] = lsh->entries[e].id;
+        }
+    }
+
+    return lsh_unique(ids, len);
+}
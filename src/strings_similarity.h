@@ -0,0 +1,120 @@
+/**
+ * @file strings_similarity.h
+ * @brief similarity hashing (minhash, simhash, lsh) over strings
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef STRINGS_SIMILARITY_H_
+#define STRINGS_SIMILARITY_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "strings.h"
+
+/*
+ * Shingling, minhash and simhash keep all state in caller supplied
+ * structures, so documents can be processed in parallel.
+ */
+
+/**
+ * @def STRING_SHINGLE_MAX
+ * @brief Maximum shingle size in words
+ *
+ */
+#define STRING_SHINGLE_MAX 16
+
+/**
+ * @enum STRING_SHINGLE_MODE
+ * @brief Shingle unit
+ *
+ */
+enum STRING_SHINGLE_MODE {
+    SHINGLE_BYTES, /**< byte n-grams >**/
+    SHINGLE_WORDS  /**< word n-grams >**/
+};
+
+/**
+ * @struct string_shingle_iter_s
+ * @brief Shingle iterator. Shingles are views into the source string.
+ *
+ */
+struct string_shingle_iter_s {
+          string_view_t buf;                       /**< source >**/
+    string_split_iter_t split;                     /**< word splitter >**/
+                uint8_t mode;                      /**< enum STRING_SHINGLE_MODE >**/
+               uint32_t n;                         /**< shingle size >**/
+               uint32_t pos;                       /**< next byte shingle start >**/
+          string_view_t words[STRING_SHINGLE_MAX]; /**< last n words (ring) >**/
+               uint32_t nwords;                    /**< words seen >**/
+                   bool emitted;                   /**< a shingle was returned >**/
+};
+typedef struct string_shingle_iter_s string_shingle_iter_t; /**< shingle iterator type >**/
+
+/**
+ * @struct string_lsh_entry_s
+ * @brief LSH band entry
+ *
+ */
+struct string_lsh_entry_s {
+    uint64_t key;  /**< band and band hash >**/
+    uint32_t id;   /**< document id >**/
+    uint32_t next; /**< next entry in bucket >**/
+};
+typedef struct string_lsh_entry_s string_lsh_entry_t; /**< LSH entry type >**/
+
+/**
+ * @struct string_lsh_s
+ * @brief Banded LSH index over minhash signatures
+ *
+ */
+struct string_lsh_s {
+              uint32_t bands;    /**< bands >**/
+              uint32_t rows;     /**< signature values per band >**/
+    string_lsh_entry_t *entries; /**< entries >**/
+              uint32_t len;      /**< used entries >**/
+              uint32_t cap;      /**< entries capacity >**/
+              uint32_t *heads;   /**< bucket heads >**/
+              uint32_t mask;     /**< buckets - 1 >**/
+};
+typedef struct string_lsh_s string_lsh_t; /**< LSH index type >**/
+
+    bool string_shingle_iter(string_shingle_iter_t *it, const String buf, uint8_t mode, uint32_t n, const char *sep);
+    bool string_shingle_next(string_shingle_iter_t *it, string_view_t *shingle);
+
+    bool string_minhash(const String buf, uint8_t mode, uint32_t n, const char *sep, uint8_t key[16], uint64_t *signature, uint32_t k);
+  double string_minhash_similarity(const uint64_t *sig1, const uint64_t *sig2, uint32_t k);
+uint64_t string_simhash(const String buf, uint8_t mode, uint32_t n, const char *sep, uint8_t key[16]);
+uint32_t string_simhash_distance(uint64_t a, uint64_t b);
+
+string_lsh_t* string_lsh_new(uint32_t bands, uint32_t rows);
+         void string_lsh_free(string_lsh_t *lsh);
+         bool string_lsh_add(string_lsh_t *lsh, const uint64_t *signature, uint32_t id);
+     uint32_t string_lsh_query(const string_lsh_t *lsh, const uint64_t *signature, uint32_t *ids, uint32_t max);
+
+#endif /* STRINGS_SIMILARITY_H_ */
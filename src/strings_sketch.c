@@ -0,0 +1,795 @@
+/**
+ * @file strings_sketch.c
+ * @brief cardinality and frequency sketches over strings
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "strings.h"
+#include "strings_sketch.h"
+
+/**
+ * @def TOPK_NONE
+ * @brief empty slot of top-k index
+ *
+ */
+#define TOPK_NONE UINT32_MAX
+
+/**
+ * @fn uint32_t sat_add32(uint32_t a, uint32_t b)
+ * @brief Saturating add
+ *
+ */
+static inline uint32_t sat_add32(uint32_t a, uint32_t b) {
+    return (a > UINT32_MAX - b) ? UINT32_MAX : a + b;
+}
+
+///// hyperloglog /////
+
+/**
+ * @fn uint8_t hll_rank(uint64_t w)
+ * @brief Position of the first set bit (1 based)
+ *
+ */
+static inline uint8_t hll_rank(uint64_t w) {
+#if defined(__GNUC__)
+    return __builtin_clzll(w) + 1;
+#else
+    uint8_t r = 1;
+    while (!(w & ((uint64_t) 1 << 63))) {
+        w <<= 1;
+        ++r;
+    }
+
+    return r;
+#endif
+}
+
+/**
+ * @fn bool hll_densify(string_hll_t *hll)
+ * @brief Convert sparse list to dense registers
+ *
+ */
+static bool hll_densify(string_hll_t *hll) {
+    uint8_t *registers = calloc((size_t) 1 << hll->p, 1);
+    if (registers == NULL)
+        return false;
+
+    for (uint32_t n = 0; n < hll->list_len; n++)
+        registers[hll->list[n] >> 8] = hll->list[n] & 0xff;
+
+    free(hll->list);
+    hll->list = NULL;
+    hll->list_len = hll->list_cap = 0;
+    hll->registers = registers;
+    hll->sparse = false;
+
+    return true;
+}
+
+/**
+ * @fn void hll_set(string_hll_t *hll, uint32_t index, uint8_t rank)
+ * @brief Raise register to rank
+ *
+ */
+static void hll_set(string_hll_t *hll, uint32_t index, uint8_t rank) {
+    if (!hll->sparse) {
+        if (hll->registers[index] < rank)
+            hll->registers[index] = rank;
+        return;
+    }
+
+    uint32_t lo = 0, hi = hll->list_len;
+    while (lo < hi) {
+        const uint32_t mid = (lo + hi) / 2;
+        if ((hll->list[mid] >> 8) < index)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo < hll->list_len && (hll->list[lo] >> 8) == index) {
+        if ((hll->list[lo] & 0xff) < rank)
+            hll->list[lo] = (index << 8) | rank;
+        return;
+    }
+
+    // sparse stops paying off at one quarter of the registers (4 bytes each)
+    if (hll->list_len + 1 > ((uint32_t) 1 << hll->p) / 4) {
+        if (hll_densify(hll))
+            hll_set(hll, index, rank);
+        return;
+    }
+
+    if (hll->list_len == hll->list_cap) {
+        const uint32_t cap = hll->list_cap ? hll->list_cap * 2 : 16;
+        uint32_t *list = realloc(hll->list, cap * sizeof(uint32_t));
+        if (list == NULL)
+            return;
+
+        hll->list = list;
+        hll->list_cap = cap;
+    }
+
+    memmove(hll->list + lo + 1, hll->list + lo, (hll->list_len - lo) * sizeof(uint32_t));
+    hll->list[lo] = (index << 8) | rank;
+    ++hll->list_len;
+}
+
+/**
+ * @fn string_hll_t* string_hll_new(uint8_t p, uint8_t key[16])
+ * @brief Allocate a HyperLogLog (starts sparse). Standard error is 1.04 / sqrt(2^p).
+ *
+ * @param p Precision (4..18)
+ * @param key Siphash key
+ * @return HyperLogLog|NULL
+ */
+string_hll_t* string_hll_new(uint8_t p, uint8_t key[16]) {
+    if (key == NULL || p < 4 || p > 18)
+        return NULL;
+
+    string_hll_t *hll = malloc(sizeof(string_hll_t));
+    if (hll == NULL)
+        return NULL;
+
+    hll->p = p;
+    hll->sparse = true;
+    hll->list = NULL;
+    hll->list_len = hll->list_cap = 0;
+    hll->registers = NULL;
+    memcpy(hll->key, key, 16);
+
+    return hll;
+}
+
+/**
+ * @fn void string_hll_free(string_hll_t *hll)
+ * @brief Free HyperLogLog
+ *
+ * @param hll HyperLogLog
+ */
+void string_hll_free(string_hll_t *hll) {
+    if (hll == NULL)
+        return;
+
+    free(hll->list);
+    free(hll->registers);
+    free(hll);
+}
+
+/**
+ * @fn void string_hll_add_view(string_hll_t *hll, string_view_t view)
+ * @brief Add string view to HyperLogLog
+ *
+ * @param hll HyperLogLog
+ * @param view String view
+ */
+void string_hll_add_view(string_hll_t *hll, string_view_t view) {
+    if (hll == NULL || view.data == NULL)
+        return;
+
+    const uint64_t h = string_hash64_view(view, hll->key);
+    const uint32_t index = h >> (64 - hll->p);
+    const uint64_t w = (h << hll->p) | ((uint64_t) 1 << (hll->p - 1));
+
+    hll_set(hll, index, hll_rank(w));
+}
+
+/**
+ * @fn void string_hll_add(string_hll_t *hll, const String buf)
+ * @brief Add string to HyperLogLog
+ *
+ * @param hll HyperLogLog
+ * @param buf Buffered string
+ */
+void string_hll_add(string_hll_t *hll, const String buf) {
+    string_hll_add_view(hll, string_view(buf));
+}
+
+/**
+ * @fn bool string_hll_merge(string_hll_t *dst, const string_hll_t *src)
+ * @brief Merge src into dst (union)
+ *
+ * @param dst HyperLogLog
+ * @param src HyperLogLog
+ * @return Boolean (false: different precision or key)
+ */
+bool string_hll_merge(string_hll_t *dst, const string_hll_t *src) {
+    if (dst == NULL || src == NULL || dst->p != src->p || memcmp(dst->key, src->key, 16))
+        return false;
+
+    if (src->sparse) {
+        for (uint32_t n = 0; n < src->list_len; n++)
+            hll_set(dst, src->list[n] >> 8, src->list[n] & 0xff);
+
+        return true;
+    }
+
+    if (dst->sparse && !hll_densify(dst))
+        return false;
+
+    for (uint32_t n = 0; n < ((uint32_t) 1 << dst->p); n++) {
+        if (dst->registers[n] < src->registers[n])
+            dst->registers[n] = src->registers[n];
+    }
+
+    return true;
+}
+
+/**
+ * @fn double string_hll_count(const string_hll_t *hll)
+ * @brief Estimated number of distinct strings
+ *
+ * @param hll HyperLogLog
+ * @return Estimation
+ */
+double string_hll_count(const string_hll_t *hll) {
+    if (hll == NULL)
+        return 0;
+
+    const uint32_t m = (uint32_t) 1 << hll->p;
+    double sum = 0;
+    uint32_t zeros = 0;
+
+    if (hll->sparse) {
+        zeros = m - hll->list_len;
+        sum = zeros;
+        for (uint32_t n = 0; n < hll->list_len; n++)
+            sum += ldexp(1.0, -(int) (hll->list[n] & 0xff));
+    } else {
+        for (uint32_t n = 0; n < m; n++) {
+            sum += ldexp(1.0, -(int) hll->registers[n]);
+            zeros += hll->registers[n] == 0;
+        }
+    }
+
+    double alpha;
+    switch (m) {
+        case 16:
+            alpha = 0.673;
+            break;
+        case 32:
+            alpha = 0.697;
+            break;
+        case 64:
+            alpha = 0.709;
+            break;
+        default:
+            alpha = 0.7213 / (1.0 + 1.079 / m);
+    }
+
+    double estimate = alpha * m * m / sum;
+
+    // small range correction (linear counting)
+    if (estimate <= 2.5 * m && zeros != 0)
+        estimate = m * log((double) m / zeros);
+
+    return estimate;
+}
+
+///// count-min /////
+
+/**
+ * @fn string_cms_t* string_cms_new(uint32_t width, uint32_t depth, uint8_t key[16])
+ * @brief Allocate a Count-Min sketch.
+ *        Error is at most e / width * total with probability 1 - e^-depth.
+ *
+ * @param width Counters per row
+ * @param depth Rows
+ * @param key Siphash key
+ * @return Count-Min sketch|NULL
+ */
+string_cms_t* string_cms_new(uint32_t width, uint32_t depth, uint8_t key[16]) {
+    if (key == NULL || width == 0 || depth == 0 || (uint64_t) width * depth > SIZE_MAX / sizeof(uint32_t))
+        return NULL;
+
+    string_cms_t *cms = malloc(sizeof(string_cms_t));
+    if (cms == NULL)
+        return NULL;
+
+    cms->counters = calloc((size_t) width * depth, sizeof(uint32_t));
+    if (cms->counters == NULL) {
+        free(cms);
+        return NULL;
+    }
+
+    cms->width = width;
+    cms->depth = depth;
+    memcpy(cms->key, key, 16);
+
+    return cms;
+}
+
+/**
+ * @fn void string_cms_free(string_cms_t *cms)
+ * @brief Free Count-Min sketch
+ *
+ * @param cms Count-Min sketch
+ */
+void string_cms_free(string_cms_t *cms) {
+    if (cms == NULL)
+        return;
+
+    free(cms->counters);
+    free(cms);
+}
+
+/**
+ * @fn void string_cms_add_view(string_cms_t *cms, string_view_t view, uint32_t count)
+ * @brief Add occurrences of string view
+ *
+ * @param cms Count-Min sketch
+ * @param view String view
+ * @param count Occurrences
+ */
+void string_cms_add_view(string_cms_t *cms, string_view_t view, uint32_t count) {
+    if (cms == NULL || view.data == NULL)
+        return;
+
+    uint64_t h1, h2;
+    string_hash128_view(view, cms->key, &h1, &h2);
+
+    uint32_t *row = cms->counters;
+    for (uint32_t d = 0; d < cms->depth; d++, row += cms->width) {
+        const uint32_t n = (h1 + d * h2) % cms->width;
+        row[n] = sat_add32(row[n], count);
+    }
+}
+
+/**
+ * @fn void string_cms_add(string_cms_t *cms, const String buf, uint32_t count)
+ * @brief Add occurrences of string
+ *
+ * @param cms Count-Min sketch
+ * @param buf Buffered string
+ * @param count Occurrences
+ */
+void string_cms_add(string_cms_t *cms, const String buf, uint32_t count) {
+    string_cms_add_view(cms, string_view(buf), count);
+}
+
+/**
+ * @fn uint32_t string_cms_estimate_view(const string_cms_t *cms, string_view_t view)
+ * @brief Estimated occurrences of string view (never underestimated)
+ *
+ * @param cms Count-Min sketch
+ * @param view String view
+ * @return Estimation
+ */
+uint32_t string_cms_estimate_view(const string_cms_t *cms, string_view_t view) {
+    if (cms == NULL || view.data == NULL)
+        return 0;
+
+    uint64_t h1, h2;
+    string_hash128_view(view, cms->key, &h1, &h2);
+
+    uint32_t min = UINT32_MAX;
+    const uint32_t *row = cms->counters;
+    for (uint32_t d = 0; d < cms->depth; d++, row += cms->width) {
+        const uint32_t n = (h1 + d * h2) % cms->width;
+        if (row[n] < min)
+            min = row[n];
+    }
+
+    return min;
+}
+
+/**
+ * @fn uint32_t string_cms_estimate(const string_cms_t *cms, const String buf)
+ * @brief Estimated occurrences of string (never underestimated)
+ *
+ * @param cms Count-Min sketch
+ * @param buf Buffered string
+ * @return Estimation
+ */
+uint32_t string_cms_estimate(const string_cms_t *cms, const String buf) {
+    return string_cms_estimate_view(cms, string_view(buf));
+}
+
+/**
+ * @fn bool string_cms_merge(string_cms_t *dst, const string_cms_t *src)
+ * @brief Add src counters into dst
+ *
+ * @param dst Count-Min sketch
+ * @param src Count-Min sketch
+ * @return Boolean (false: different dimensions or key)
+ */
+bool string_cms_merge(string_cms_t *dst, const string_cms_t *src) {
+    if (dst == NULL || src == NULL || dst->width != src->width || dst->depth != src->depth || memcmp(dst->key, src->key, 16))
+        return false;
+
+    for (size_t n = 0; n < (size_t) dst->width * dst->depth; n++)
+        dst->counters[n] = sat_add32(dst->counters[n], src->counters[n]);
+
+    return true;
+}
+
+///// top-k (space-saving) /////
+
+/**
+ * @fn uint32_t topk_find(const string_topk_t *tk, uint64_t hash, string_view_t view)
+ * @brief Find entry of item
+ *
+ * @return Entry index|TOPK_NONE
+ */
+static uint32_t topk_find(const string_topk_t *tk, uint64_t hash, string_view_t view) {
+    for (uint32_t slot = hash & tk->mask;; slot = (slot + 1) & tk->mask) {
+        const uint32_t e = tk->index[slot];
+        if (e == TOPK_NONE)
+            return TOPK_NONE;
+
+        const string_topk_entry_t *entry = &tk->entries[e];
+        if (entry->hash == hash && entry->key->length == view.length && !memcmp(entry->key->data, view.data, view.length))
+            return e;
+    }
+}
+
+/**
+ * @fn void topk_index_insert(string_topk_t *tk, uint32_t e)
+ * @brief Insert entry in hash index
+ *
+ */
+static void topk_index_insert(string_topk_t *tk, uint32_t e) {
+    uint32_t slot = tk->entries[e].hash & tk->mask;
+    while (tk->index[slot] != TOPK_NONE)
+        slot = (slot + 1) & tk->mask;
+
+    tk->index[slot] = e;
+}
+
+/**
+ * @fn void topk_index_remove(string_topk_t *tk, uint32_t e)
+ * @brief Remove entry from hash index (backward shift deletion)
+ *
+ */
+static void topk_index_remove(string_topk_t *tk, uint32_t e) {
+    uint32_t slot = tk->entries[e].hash & tk->mask;
+    while (tk->index[slot] != e)
+        slot = (slot + 1) & tk->mask;
+
+    uint32_t next = slot;
+    for (;;) {
+        next = (next + 1) & tk->mask;
+        if (tk->index[next] == TOPK_NONE)
+            break;
+
+        const uint32_t home = tk->entries[tk->index[next]].hash & tk->mask;
+        // move back unless home lies cyclically in (slot, next]
+        if ((next > slot && (home <= slot || home > next)) || (next < slot && home <= slot && home > next)) {
+            tk->index[slot] = tk->index[next];
+            slot = next;
+        }
+    }
+
+    tk->index[slot] = TOPK_NONE;
+}
+
+/**
+ * @fn void topk_sift_down(string_topk_t *tk, uint32_t h)
+ * @brief Restore min-heap order after a count increase
+ *
+ */
+static void topk_sift_down(string_topk_t *tk, uint32_t h) {
+    for (;;) {
+        uint32_t min = h;
+        const uint32_t l = 2 * h + 1, r = 2 * h + 2;
+
+        if (l < tk->len && tk->entries[tk->heap[l]].count < tk->entries[tk->heap[min]].count)
+            min = l;
+        if (r < tk->len && tk->entries[tk->heap[r]].count < tk->entries[tk->heap[min]].count)
+            min = r;
+        if (min == h)
+            return;
+
+        const uint32_t tmp = tk->heap[h];
+        tk->heap[h] = tk->heap[min];
+        tk->heap[min] = tmp;
+        tk->pos[tk->heap[h]] = h;
+        tk->pos[tk->heap[min]] = min;
+        h = min;
+    }
+}
+
+/**
+ * @fn void topk_sift_up(string_topk_t *tk, uint32_t h)
+ * @brief Restore min-heap order after appending
+ *
+ */
+static void topk_sift_up(string_topk_t *tk, uint32_t h) {
+    while (h > 0) {
+        const uint32_t parent = (h - 1) / 2;
+        if (tk->entries[tk->heap[parent]].count <= tk->entries[tk->heap[h]].count)
+            return;
+
+        const uint32_t tmp = tk->heap[h];
+        tk->heap[h] = tk->heap[parent];
+        tk->heap[parent] = tmp;
+        tk->pos[tk->heap[h]] = h;
+        tk->pos[tk->heap[parent]] = parent;
+        h = parent;
+    }
+}
+
+/**
+ * @fn bool topk_set_key(String *key, string_view_t view)
+ * @brief Copy view into entry key reusing its capacity
+ *
+ */
+static bool topk_set_key(String *key, string_view_t view) {
+    if (*key == NULL) {
+        *key = string_new_view(view);
+        return *key != NULL;
+    }
+
+    if ((*key)->capacity < view.length && !string_resize(key, view.length))
+        return false;
+
+    memcpy((*key)->data, view.data, view.length);
+    (*key)->data[view.length] = '\0';
+    (*key)->length = view.length;
+
+    return true;
+}
+
+/**
+ * @fn bool topk_insert(string_topk_t *tk, string_view_t view, uint64_t hash, uint64_t count, uint64_t error)
+ * @brief Add counts of an item, evicting the minimum when full
+ *
+ */
+static bool topk_insert(string_topk_t *tk, string_view_t view, uint64_t hash, uint64_t count, uint64_t error) {
+    uint32_t e = topk_find(tk, hash, view);
+
+    if (e != TOPK_NONE) {
+        tk->entries[e].count += count;
+        tk->entries[e].error += error;
+        topk_sift_down(tk, tk->pos[e]);
+        return true;
+    }
+
+    if (tk->len < tk->k) {
+        e = tk->len;
+        tk->entries[e].key = NULL;
+        if (!topk_set_key(&tk->entries[e].key, view))
+            return false;
+
+        tk->entries[e].hash = hash;
+        tk->entries[e].count = count;
+        tk->entries[e].error = error;
+        tk->heap[e] = e;
+        tk->pos[e] = e;
+        ++tk->len;
+        topk_index_insert(tk, e);
+        topk_sift_up(tk, e);
+        return true;
+    }
+
+    // replace the minimum, inheriting its count as error
+    e = tk->heap[0];
+
+    // grow first: on failure the entry stays indexed under its old key
+    if (tk->entries[e].key->capacity < view.length && !string_resize(&tk->entries[e].key, view.length))
+        return false;
+
+    topk_index_remove(tk, e);
+    topk_set_key(&tk->entries[e].key, view); // fits, cannot fail
+
+    tk->entries[e].hash = hash;
+    tk->entries[e].error = tk->entries[e].count + error;
+    tk->entries[e].count += count;
+    topk_index_insert(tk, e);
+    topk_sift_down(tk, 0);
+
+    return true;
+}
+
+/**
+ * @fn string_topk_t* string_topk_new(uint32_t k, uint8_t key[16])
+ * @brief Allocate a Space-Saving summary monitoring `k` items
+ *
+ * @param k Monitored items
+ * @param key Siphash key
+ * @return Top-k summary|NULL
+ */
+string_topk_t* string_topk_new(uint32_t k, uint8_t key[16]) {
+    if (key == NULL || k == 0 || k > UINT32_MAX / 4)
+        return NULL;
+
+    string_topk_t *tk = calloc(1, sizeof(string_topk_t));
+    if (tk == NULL)
+        return NULL;
+
+    uint32_t size = 1;
+    while (size < 2 * k)
+        size <<= 1;
+
+    tk->k = k;
+    tk->mask = size - 1;
+    tk->entries = malloc(k * sizeof(string_topk_entry_t));
+    tk->heap = malloc(k * sizeof(uint32_t));
+    tk->pos = malloc(k * sizeof(uint32_t));
+    tk->index = malloc(size * sizeof(uint32_t));
+    memcpy(tk->key, key, 16);
+
+    if (tk->entries == NULL || tk->heap == NULL || tk->pos == NULL || tk->index == NULL) {
+        string_topk_free(tk);
+        return NULL;
+    }
+
+    memset(tk->index, 0xff, size * sizeof(uint32_t));
+
+    return tk;
+}
+
+/**
+ * @fn void string_topk_free(string_topk_t *tk)
+ * @brief Free top-k summary
+ *
+ * @param tk Top-k summary
+ */
+void string_topk_free(string_topk_t *tk) {
+    if (tk == NULL)
+        return;
+
+    for (uint32_t n = 0; n < tk->len; n++)
+        free(tk->entries[n].key);
+
+    free(tk->entries);
+    free(tk->heap);
+    free(tk->pos);
+    free(tk->index);
+    free(tk);
+}
+
+/**
+ * @fn bool string_topk_add_view(string_topk_t *tk, string_view_t view, uint32_t count)
+ * @brief Add occurrences of string view
+ *
+ * @param tk Top-k summary
+ * @param view String view
+ * @param count Occurrences
+ * @return Boolean (false: allocation error)
+ */
+bool string_topk_add_view(string_topk_t *tk, string_view_t view, uint32_t count) {
+    if (tk == NULL || view.data == NULL)
+        return false;
+
+    return topk_insert(tk, view, string_hash64_view(view, tk->key), count, 0);
+}
+
+/**
+ * @fn bool string_topk_add(string_topk_t *tk, const String buf, uint32_t count)
+ * @brief Add occurrences of string
+ *
+ * @param tk Top-k summary
+ * @param buf Buffered string
+ * @param count Occurrences
+ * @return Boolean (false: allocation error)
+ */
+bool string_topk_add(string_topk_t *tk, const String buf, uint32_t count) {
+    return string_topk_add_view(tk, string_view(buf), count);
+}
+
+/**
+ * @fn int topk_cmp(const void *a, const void *b)
+ * @brief Order entries by descending count
+ *
+ */
+static int topk_cmp(const void *a, const void *b) {
+    const string_topk_entry_t *ea = a, *eb = b;
+
+    return (ea->count < eb->count) - (ea->count > eb->count);
+}
+
+/**
+ * @fn bool string_topk_merge(string_topk_t *dst, const string_topk_t *src)
+ * @brief Merge src into dst. Items missing in one summary are charged its minimum count as error.
+ *
+ * @param dst Top-k summary
+ * @param src Top-k summary
+ * @return Boolean (false: different key or allocation error)
+ */
+bool string_topk_merge(string_topk_t *dst, const string_topk_t *src) {
+    if (dst == NULL || src == NULL || memcmp(dst->key, src->key, 16))
+        return false;
+
+    const uint64_t min_dst = (dst->len == dst->k) ? dst->entries[dst->heap[0]].count : 0;
+    const uint64_t min_src = (src->len == src->k) ? src->entries[src->heap[0]].count : 0;
+
+    string_topk_entry_t *all = malloc(((size_t) dst->len + src->len) * sizeof(string_topk_entry_t));
+    if (all == NULL)
+        return false;
+
+    uint32_t len = 0;
+    for (uint32_t n = 0; n < src->len; n++) {
+        const string_topk_entry_t *s = &src->entries[n];
+        if (topk_find(dst, s->hash, string_view(s->key)) != TOPK_NONE)
+            continue;
+
+        all[len].key = string_new_view(string_view(s->key));
+        if (all[len].key == NULL) {
+            while (len > 0)
+                free(all[--len].key);
+            free(all);
+            return false;
+        }
+
+        all[len].hash = s->hash;
+        all[len].count = s->count + min_dst;
+        all[len].error = s->error + min_dst;
+        ++len;
+    }
+
+    // dst entries move into the merged list (keys change owner)
+    for (uint32_t n = 0; n < dst->len; n++) {
+        all[len] = dst->entries[n];
+        const uint32_t e = topk_find(src, all[len].hash, string_view(all[len].key));
+        all[len].count += (e != TOPK_NONE) ? src->entries[e].count : min_src;
+        all[len].error += (e != TOPK_NONE) ? src->entries[e].error : min_src;
+        ++len;
+    }
+
+    qsort(all, len, sizeof(string_topk_entry_t), topk_cmp);
+
+    dst->len = (len < dst->k) ? len : dst->k;
+    for (uint32_t n = dst->len; n < len; n++)
+        free(all[n].key);
+
+    memset(dst->index, 0xff, ((size_t) dst->mask + 1) * sizeof(uint32_t));
+    for (uint32_t n = 0; n < dst->len; n++) {
+        // descending order reversed is a valid min-heap
+        dst->entries[n] = all[n];
+        dst->heap[dst->len - 1 - n] = n;
+        dst->pos[n] = dst->len - 1 - n;
+        topk_index_insert(dst, n);
+    }
+
+    free(all);
+
+    return true;
+}
+
+/**
+ * @fn uint32_t string_topk_list(const string_topk_t *tk, string_topk_entry_t *out)
+ * @brief Copy counters ordered by descending count. Keys are borrowed from the summary.
+ *
+ * @param tk Top-k summary
+ * @param out Array of at least k entries
+ * @return Entries written
+ */
+uint32_t string_topk_list(const string_topk_t *tk, string_topk_entry_t *out) {
+    if (tk == NULL || out == NULL)
+        return 0;
+
+    memcpy(out, tk->entries, tk->len * sizeof(string_topk_entry_t));
+    qsort(out, tk->len, sizeof(string_topk_entry_t), topk_cmp);
+
+    return tk->len;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file strings_sketch.h
+ * @brief cardinality and frequency sketches over strings
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef STRINGS_SKETCH_H_
+#define STRINGS_SKETCH_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "strings.h"
+
+/*
+ * Sketches keep no global state: use one instance per thread and
+ * combine them at the end with the *_merge functions (same parameters
+ * and key required).
+ */
+
+/**
+ * @struct string_hll_s
+ * @brief HyperLogLog distinct counter
+ *
+ */
+struct string_hll_s {
+     uint8_t p;           /**< precision (4..18), 2^p registers >**/
+        bool sparse;      /**< sparse representation in use >**/
+    uint32_t *list;       /**< sparse list of (index << 8 | rank) sorted by index >**/
+    uint32_t list_len;    /**< sparse list length >**/
+    uint32_t list_cap;    /**< sparse list capacity >**/
+     uint8_t *registers;  /**< dense registers (NULL while sparse) >**/
+     uint8_t key[16];     /**< siphash key >**/
+};
+typedef struct string_hll_s string_hll_t; /**< HyperLogLog type >**/
+
+/**
+ * @struct string_cms_s
+ * @brief Count-Min sketch
+ *
+ */
+struct string_cms_s {
+    uint32_t width;     /**< counters per row >**/
+    uint32_t depth;     /**< rows >**/
+    uint32_t *counters; /**< depth * width saturating counters >**/
+     uint8_t key[16];   /**< siphash key >**/
+};
+typedef struct string_cms_s string_cms_t; /**< Count-Min sketch type >**/
+
+/**
+ * @struct string_topk_entry_s
+ * @brief Space-Saving counter
+ *
+ */
+struct string_topk_entry_s {
+      String key;   /**< item >**/
+    uint64_t hash;  /**< item hash >**/
+    uint64_t count; /**< estimated count (upper bound) >**/
+    uint64_t error; /**< maximum overestimation >**/
+};
+typedef struct string_topk_entry_s string_topk_entry_t; /**< Space-Saving counter type >**/
+
+/**
+ * @struct string_topk_s
+ * @brief Space-Saving top-k summary
+ *
+ */
+struct string_topk_s {
+                uint32_t k;       /**< monitored items >**/
+                uint32_t len;     /**< used entries >**/
+    string_topk_entry_t *entries; /**< counters >**/
+                uint32_t *heap;   /**< entry indexes, min-heap by count >**/
+                uint32_t *pos;    /**< heap position of each entry >**/
+                uint32_t *index;  /**< open addressing hash index of entries >**/
+                uint32_t mask;    /**< index size - 1 >**/
+                 uint8_t key[16]; /**< siphash key >**/
+};
+typedef struct string_topk_s string_topk_t; /**< Space-Saving top-k type >**/
+
+string_hll_t* string_hll_new(uint8_t p, uint8_t key[16]);
+         void string_hll_free(string_hll_t *hll);
+         void string_hll_add(string_hll_t *hll, const String buf);
+         void string_hll_add_view(string_hll_t *hll, string_view_t view);
+         bool string_hll_merge(string_hll_t *dst, const string_hll_t *src);
+       double string_hll_count(const string_hll_t *hll);
+
+string_cms_t* string_cms_new(uint32_t width, uint32_t depth, uint8_t key[16]);
+         void string_cms_free(string_cms_t *cms);
+         void string_cms_add(string_cms_t *cms, const String buf, uint32_t count);
+         void string_cms_add_view(string_cms_t *cms, string_view_t view, uint32_t count);
+     uint32_t string_cms_estimate(const string_cms_t *cms, const String buf);
+     uint32_t string_cms_estimate_view(const string_cms_t *cms, string_view_t view);
+         bool string_cms_merge(string_cms_t *dst, const string_cms_t *src);
+
+string_topk_t* string_topk_new(uint32_t k, uint8_t key[16]);
+          void string_topk_free(string_topk_t *tk);
+          bool string_topk_add(string_topk_t *tk, const String buf, uint32_t count);
+          bool string_topk_add_view(string_topk_t *tk, string_view_t view, uint32_t count);
+          bool string_topk_merge(string_topk_t *dst, const string_topk_t *src);
+      uint32_t string_topk_list(const string_topk_t *tk, string_topk_entry_t *out);
+
+#endif /* STRINGS_SKETCH_H_ */
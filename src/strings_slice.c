@@ -0,0 +1,312 @@
+/**
+ * @file strings_slice.c
+ * @brief owning substrings sharing a refcounted parent buffer
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "strings.h"
+#include "strings_slice.h"
+
+/**
+ * @fn void shared_unref(string_shared_t *sh)
+ * @brief Drop one reference, free parent on last
+ *
+ */
+static void shared_unref(string_shared_t *sh) {
+    if (--sh->refs > 0)
+        return;
+
+    free(sh->buf);
+    free(sh);
+}
+
+/**
+ * @fn string_slice_t* slice_make(string_shared_t *sh, uint32_t offset, uint32_t length)
+ * @brief New slice referencing sh
+ *
+ */
+static string_slice_t* slice_make(string_shared_t *sh, uint32_t offset, uint32_t length) {
+    string_slice_t *slice = malloc(sizeof(string_slice_t));
+    if (slice == NULL)
+        return NULL;
+
+    slice->parent = sh;
+    slice->offset = offset;
+    slice->length = length;
+    ++sh->refs;
+    sh->live += length;
+
+    return slice;
+}
+
+/**
+ * @fn string_shared_t* string_shared_new(String buf)
+ * @brief Shared parent taking ownership of buf
+ *
+ * @param buf Buffered string (freed with the last reference)
+ * @return Shared parent (one reference held by the caller)
+ */
+string_shared_t* string_shared_new(String buf) {
+    if (buf == NULL)
+        return NULL;
+
+    string_shared_t *sh = malloc(sizeof(string_shared_t));
+    if (sh == NULL)
+        return NULL;
+
+    sh->buf = buf;
+    sh->refs = 1;
+    sh->live = 0;
+
+    return sh;
+}
+
+/**
+ * @fn void string_shared_release(string_shared_t *sh)
+ * @brief Drop the caller reference. Parent lives while slices reference it.
+ *
+ * @param sh Shared parent
+ */
+void string_shared_release(string_shared_t *sh) {
+    if (sh == NULL)
+        return;
+
+    shared_unref(sh);
+}
+
+/**
+ * @fn string_slice_t* string_slice_left(string_shared_t *sh, uint32_t pos)
+ * @brief Slice left from position (as string_left)
+ *
+ * @param sh Shared parent
+ * @param pos Position
+ * @return Slice
+ */
+string_slice_t* string_slice_left(string_shared_t *sh, uint32_t pos) {
+    if (sh == NULL || pos >= sh->buf->length)
+        return NULL;
+
+    return slice_make(sh, 0, pos + 1);
+}
+
+/**
+ * @fn string_slice_t* string_slice_mid(string_shared_t *sh, uint32_t left, uint32_t right)
+ * @brief Slice from position left to position right (as string_mid)
+ *
+ * @param sh Shared parent
+ * @param left Position (start in 1)
+ * @param right Position
+ * @return Slice
+ */
+string_slice_t* string_slice_mid(string_shared_t *sh, uint32_t left, uint32_t right) {
+    if (sh == NULL || left == 0 || right > sh->buf->length || left > right)
+        return NULL;
+
+    return slice_make(sh, left - 1, right - left + 1);
+}
+
+/**
+ * @fn uint32_t string_slice_split_array(string_shared_t *sh, const char *search, string_slice_t ***array)
+ * @brief Split parent in an array of slices (tokens as string_split_next)
+ *
+ * @param sh Shared parent
+ * @param search Separator
+ * @param array Array of slices (free each with string_slice_free, then the array)
+ * @return Number of slices (0 on error)
+ */
+uint32_t string_slice_split_array(string_shared_t *sh, const char *search, string_slice_t ***array) {
+    if (sh == NULL || search == NULL || array == NULL)
+        return 0;
+
+    string_split_iter_t it;
+    string_view_t token;
+    uint32_t n = 0, cap = 0;
+    string_slice_t **arr = NULL;
+
+    string_split_iter(&it, sh->buf, search);
+    while (string_split_next(&it, &token)) {
+        if (n == cap) {
+            cap = cap ? cap * 2 : 8;
+            string_slice_t **tmp = realloc(arr, cap * sizeof(string_slice_t*));
+            if (tmp == NULL)
+                goto fail;
+            arr = tmp;
+        }
+
+        if ((arr[n] = slice_make(sh, token.data - sh->buf->data, token.length)) == NULL)
+            goto fail;
+        ++n;
+    }
+
+    *array = arr;
+    return n;
+
+fail:
+    while (n > 0)
+        string_slice_free(arr[--n]);
+    free(arr);
+    return 0;
+}
+
+/**
+ * @fn string_slice_t* string_slice_sub(const string_slice_t *slice, uint32_t offset, uint32_t length)
+ * @brief Slice of a slice, sharing the same parent
+ *
+ * @param slice Slice
+ * @param offset Start in slice
+ * @param length Length
+ * @return Slice
+ */
+string_slice_t* string_slice_sub(const string_slice_t *slice, uint32_t offset, uint32_t length) {
+    if (slice == NULL || offset > slice->length || length > slice->length - offset)
+        return NULL;
+
+    return slice_make(slice->parent, slice->offset + offset, length);
+}
+
+/**
+ * @fn string_slice_t* string_slice_dup(const string_slice_t *slice)
+ * @brief New reference to the same range
+ *
+ * @param slice Slice
+ * @return Slice
+ */
+string_slice_t* string_slice_dup(const string_slice_t *slice) {
+    if (slice == NULL)
+        return NULL;
+
+    return slice_make(slice->parent, slice->offset, slice->length);
+}
+
+/**
+ * @fn void string_slice_free(string_slice_t *slice)
+ * @brief Free slice, releasing its parent reference
+ *
+ * @param slice Slice
+ */
+void string_slice_free(string_slice_t *slice) {
+    if (slice == NULL)
+        return;
+
+    slice->parent->live -= slice->length;
+    shared_unref(slice->parent);
+    free(slice);
+}
+
+/**
+ * @fn string_view_t string_slice_view(const string_slice_t *slice)
+ * @brief View over slice (not null terminated)
+ *
+ * @param slice Slice
+ * @return String view (data NULL if slice is NULL)
+ */
+string_view_t string_slice_view(const string_slice_t *slice) {
+    string_view_t view = { NULL, 0 };
+
+    if (slice != NULL) {
+        view.data = slice->parent->buf->data + slice->offset;
+        view.length = slice->length;
+    }
+
+    return view;
+}
+
+/**
+ * @fn String string_slice_to_string(const string_slice_t *slice)
+ * @brief Copy slice to a new String
+ *
+ * @param slice Slice
+ * @return Buffered string
+ */
+String string_slice_to_string(const string_slice_t *slice) {
+    if (slice == NULL)
+        return NULL;
+
+    return string_new_view(string_slice_view(slice));
+}
+
+/**
+ * @fn uint8_t string_slice_garbage(const string_slice_t *slice)
+ * @brief Percentage of the parent not referenced by any slice
+ *
+ * @param slice Slice
+ * @return Percentage (0..100)
+ */
+uint8_t string_slice_garbage(const string_slice_t *slice) {
+    if (slice == NULL || slice->parent->buf->length == 0)
+        return 0;
+
+    const uint64_t total = slice->parent->buf->length;
+    const uint64_t live = slice->parent->live;
+
+    // overlapping slices count more than once
+    if (live >= total)
+        return 0;
+
+    return (uint8_t) ((total - live) * 100 / total);
+}
+
+/**
+ * @fn bool string_slice_compact(string_slice_t *slice, uint8_t max_garbage)
+ * @brief Detach slice into its own exact-fit parent when the shared parent is mostly garbage
+ *
+ * @param slice Slice
+ * @param max_garbage Garbage percentage tolerated before detaching (0: always detach)
+ * @return Boolean (false on allocation error, slice unchanged)
+ */
+bool string_slice_compact(string_slice_t *slice, uint8_t max_garbage) {
+    if (slice == NULL)
+        return false;
+
+    string_shared_t *old = slice->parent;
+    if (old->refs == 1 && slice->offset == 0 && slice->length == old->buf->length)
+        return true;
+    if (max_garbage > 0 && string_slice_garbage(slice) <= max_garbage)
+        return true;
+
+    String buf = string_new_view(string_slice_view(slice));
+    if (buf == NULL)
+        return false;
+
+    string_shared_t *sh = string_shared_new(buf);
+    if (sh == NULL) {
+        free(buf);
+        return false;
+    }
+
+    sh->live = slice->length;
+    old->live -= slice->length;
+    shared_unref(old);
+    slice->parent = sh;
+    slice->offset = 0;
+
+    return true;
+}
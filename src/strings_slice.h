@@ -0,0 +1,78 @@
+/**
+ * @file strings_slice.h
+ * @brief owning substrings sharing a refcounted parent buffer
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef STRINGS_SLICE_H_
+#define STRINGS_SLICE_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "strings.h"
+
+/**
+ * @struct string_shared_s
+ * @brief Refcounted parent storage (not thread safe)
+ *
+ */
+struct string_shared_s {
+      String buf;  /**< parent string (owned) >**/
+    uint32_t refs; /**< references (creator handle and slices) >**/
+    uint64_t live; /**< bytes referenced by slices >**/
+};
+typedef struct string_shared_s string_shared_t; /**< shared parent type >**/
+
+/**
+ * @struct string_slice_s
+ * @brief Owning substring: range of a shared parent, keeps the parent alive
+ *
+ */
+struct string_slice_s {
+    string_shared_t *parent; /**< parent storage >**/
+           uint32_t offset;  /**< start in parent >**/
+           uint32_t length;  /**< length >**/
+};
+typedef struct string_slice_s string_slice_t; /**< slice type >**/
+
+string_shared_t* string_shared_new(String buf);
+            void string_shared_release(string_shared_t *sh);
+
+ string_slice_t* string_slice_left(string_shared_t *sh, uint32_t pos);
+ string_slice_t* string_slice_mid(string_shared_t *sh, uint32_t left, uint32_t right);
+        uint32_t string_slice_split_array(string_shared_t *sh, const char *search, string_slice_t ***array);
+ string_slice_t* string_slice_sub(const string_slice_t *slice, uint32_t offset, uint32_t length);
+ string_slice_t* string_slice_dup(const string_slice_t *slice);
+            void string_slice_free(string_slice_t *slice);
+   string_view_t string_slice_view(const string_slice_t *slice);
+          String string_slice_to_string(const string_slice_t *slice);
+         uint8_t string_slice_garbage(const string_slice_t *slice);
+            bool string_slice_compact(string_slice_t *slice, uint8_t max_garbage);
+
+#endif /* STRINGS_SLICE_H_ */
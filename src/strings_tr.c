@@ -0,0 +1,294 @@
+/**
+ * @file strings_tr.c
+ * @brief tr style byte translation, deletion and squeezing
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "strings.h"
+#include "strings_simd.h"
+#include "strings_tr.h"
+
+/**
+ * @fn int hex_digit(char c)
+ * @brief Hexadecimal digit value or -1
+ *
+ */
+static inline int hex_digit(char c) {
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+
+    return -1;
+}
+
+/**
+ * @fn bool spec_byte(const char **spec, uint8_t *c)
+ * @brief Read one byte of a set spec (\\n \\t \\r \\\\ \\- \\xHH escapes)
+ *
+ */
+static bool spec_byte(const char **spec, uint8_t *c) {
+    const char *p = *spec;
+
+    if (*p != '\\') {
+        *c = (uint8_t) *p;
+        *spec = p + 1;
+        return true;
+    }
+
+    switch (p[1]) {
+        case 'n':
+            *c = '\n';
+            break;
+        case 't':
+            *c = '\t';
+            break;
+        case 'r':
+            *c = '\r';
+            break;
+        case '\\':
+        case '-':
+            *c = (uint8_t) p[1];
+            break;
+        case 'x': {
+            const int hi = hex_digit(p[2]);
+            const int lo = (hi < 0) ? -1 : hex_digit(p[3]);
+            if (lo < 0)
+                return false;
+            *c = (uint8_t) (hi << 4 | lo);
+            *spec = p + 4;
+            return true;
+        }
+        default:
+            return false;
+    }
+
+    *spec = p + 2;
+
+    return true;
+}
+
+/**
+ * @fn int spec_expand(const char *spec, uint8_t out[256])
+ * @brief Expand a set spec with ranges (a-z) into bytes. Returns count or -1 on error.
+ *
+ */
+static int spec_expand(const char *spec, uint8_t out[256]) {
+    int n = 0;
+
+    if (spec == NULL)
+        return 0;
+
+    while (*spec != '\0') {
+        uint8_t first, last;
+        if (!spec_byte(&spec, &first))
+            return -1;
+
+        last = first;
+        if (spec[0] == '-' && spec[1] != '\0') {
+            ++spec;
+            if (!spec_byte(&spec, &last) || last < first)
+                return -1;
+        }
+
+        for (unsigned c = first; c <= last; c++) {
+            if (n == 256)
+                return -1;
+            out[n++] = (uint8_t) c;
+        }
+    }
+
+    return n;
+}
+
+/**
+ * @fn bool spec_set(string_byteset_t *set, const char *spec, bool *any)
+ * @brief Compile a set spec into a byte set, any tells if it is not empty. Returns false on error.
+ *
+ */
+static bool spec_set(string_byteset_t *set, const char *spec, bool *any) {
+    uint8_t bytes[256];
+    const int n = spec_expand(spec, bytes);
+
+    string_byteset(set, NULL);
+    if (n < 0)
+        return false;
+
+    for (int i = 0; i < n; i++)
+        (bytes[i] & 0x80 ? set->hi : set->lo)[bytes[i] & 0x0f] |= 1 << ((bytes[i] >> 4) & 7);
+    *any = n > 0;
+
+    return true;
+}
+
+/**
+ * @fn size_t tr_delete(char *dst, const char *src, size_t n, const string_byteset_t *set)
+ * @brief Copy src without bytes of set (dst may be src)
+ *
+ */
+static size_t tr_delete(char *dst, const char *src, size_t n, const string_byteset_t *set) {
+    size_t r = 0, w = 0;
+
+    while (r < n) {
+        const size_t keep = string_simd->span(src + r, n - r, set, false);
+        memmove(dst + w, src + r, keep);
+        w += keep;
+        r += keep;
+        r += string_simd->span(src + r, n - r, set, true);
+    }
+
+    return w;
+}
+
+/**
+ * @fn size_t tr_squeeze(char *s, size_t n, const string_byteset_t *set)
+ * @brief Collapse runs of the same byte of set, in place
+ *
+ */
+static size_t tr_squeeze(char *s, size_t n, const string_byteset_t *set) {
+    size_t r = 0, w = 0;
+
+    while (r < n) {
+        const size_t keep = string_simd->span(s + r, n - r, set, false);
+        memmove(s + w, s + r, keep);
+        w += keep;
+        r += keep;
+        if (r == n)
+            break;
+
+        const char c = s[r];
+        s[w++] = c;
+        while (++r < n && s[r] == c)
+            ;
+    }
+
+    return w;
+}
+
+/**
+ * @fn size_t tr_apply(char *dst, const char *src, size_t n, const string_tr_t *tr)
+ * @brief Apply delete, translate and squeeze (dst may be src)
+ *
+ */
+static size_t tr_apply(char *dst, const char *src, size_t n, const string_tr_t *tr) {
+    if (tr->deletes)
+        n = tr_delete(dst, src, n, &tr->del);
+    else if (dst != src)
+        memcpy(dst, src, n);
+
+    if (tr->translate)
+        string_simd->translate(dst, dst, n, tr->map);
+
+    if (tr->squeezes)
+        n = tr_squeeze(dst, n, &tr->squeeze);
+
+    return n;
+}
+
+/**
+ * @fn bool string_tr_compile(string_tr_t *tr, const char *from, const char *to, const char *del, const char *squeeze)
+ * @brief Compile a translation. Sets accept ranges (a-z) and \\n \\t \\r \\\\ \\- \\xHH escapes.
+ *        If to is shorter than from its last byte is repeated.
+ *
+ * @param tr Translation
+ * @param from Bytes to translate (NULL: none)
+ * @param to Replacement bytes (NULL: none)
+ * @param del Bytes to delete (NULL: none)
+ * @param squeeze Bytes whose repeats collapse (NULL: none)
+ * @return Boolean (false: malformed set)
+ */
+bool string_tr_compile(string_tr_t *tr, const char *from, const char *to, const char *del, const char *squeeze) {
+    uint8_t src[256], dst[256];
+
+    if (tr == NULL)
+        return false;
+
+    const int nfrom = spec_expand(from, src);
+    const int nto = spec_expand(to, dst);
+    if (nfrom < 0 || nto < 0 || (nfrom > 0 && nto == 0))
+        return false;
+
+    for (int c = 0; c < 256; c++)
+        tr->map[c] = (uint8_t) c;
+
+    tr->translate = false;
+    for (int i = 0; i < nfrom; i++) {
+        tr->map[src[i]] = dst[i < nto ? i : nto - 1];
+        tr->translate |= tr->map[src[i]] != src[i];
+    }
+
+    return spec_set(&tr->del, del, &tr->deletes) && spec_set(&tr->squeeze, squeeze, &tr->squeezes);
+}
+
+/**
+ * @fn String string_tr(const String buf, const string_tr_t *tr)
+ * @brief Translate into a new String of exact length
+ *
+ * @param buf Buffered string
+ * @param tr Translation
+ * @return Buffered string
+ */
+String string_tr(const String buf, const string_tr_t *tr) {
+    if (buf == NULL || tr == NULL)
+        return NULL;
+
+    String result = string_new_uninit(buf->length);
+    if (result == NULL)
+        return NULL;
+
+    result->length = tr_apply(result->data, buf->data, buf->length, tr);
+    result->data[result->length] = '\0';
+
+    if (result->length < buf->length)
+        string_resize(&result, result->length);
+
+    return result;
+}
+
+/**
+ * @fn uint32_t string_tr_inplace(String buf, const string_tr_t *tr)
+ * @brief Translate in place
+ *
+ * @param buf Buffered string
+ * @param tr Translation
+ * @return New length
+ */
+uint32_t string_tr_inplace(String buf, const string_tr_t *tr) {
+    if (buf == NULL || tr == NULL)
+        return STR_ERROR;
+
+    buf->length = tr_apply(buf->data, buf->data, buf->length, tr);
+    buf->data[buf->length] = '\0';
+
+    return buf->length;
+}
@@ -0,0 +1,58 @@
+/**
+ * @file strings_tr.h
+ * @brief tr style byte translation, deletion and squeezing
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/stringslib
+ * @note This is based on https://github.com/alcover/buf and others. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef STRINGS_TR_H_
+#define STRINGS_TR_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "strings.h"
+
+/**
+ * @struct string_tr_s
+ * @brief Compiled translation. Bytes are deleted, then translated, then repeats of squeeze bytes collapse.
+ *
+ */
+struct string_tr_s {
+             uint8_t map[256]; /**< translation table >**/
+    string_byteset_t del;      /**< deleted bytes (before translation) >**/
+    string_byteset_t squeeze;  /**< bytes whose runs collapse to one (after translation) >**/
+                bool translate; /**< map is not identity >**/
+                bool deletes;   /**< del is not empty >**/
+                bool squeezes;  /**< squeeze is not empty >**/
+};
+typedef struct string_tr_s string_tr_t; /**< translation type >**/
+
+    bool string_tr_compile(string_tr_t *tr, const char *from, const char *to, const char *del, const char *squeeze);
+  String string_tr(const String buf, const string_tr_t *tr);
+uint32_t string_tr_inplace(String buf, const string_tr_t *tr);
+
+#endif /* STRINGS_TR_H_ */
@@ -32,8 +32,33 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sched.h>
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33)) && !defined(__SANITIZE_ADDRESS__)
+#include <malloc.h>
+#define STRINGS_TEST_MALLINFO 1
+#endif
 
 #include "strings.h"
+#include "siphash.h"
+#include "halfsiphash.h"
+#include "strings_filter.h"
+#include "strings_sketch.h"
+#include "strings_similarity.h"
+#include "strings_rolling.h"
+#include "strings_shard.h"
+#include "strings_simd.h"
+#include "strings_tr.h"
+#include "strings_diff.h"
+#include "strings_edit.h"
+#include "strings_pipe.h"
+#include "strings_compact.h"
+#include "strings_slice.h"
+#include "strings_shm.h"
+#include "strings_intern.h"
+#include "strings_mphf.h"
 
 int main(void) {
     const char *foo = "foo";
@@ -134,6 +159,42 @@ int main(void) {
     assert(string_equals_c(a, "pruebita"));
     free(a);
 
+    buf = string_new_uninit(cap);
+    check(buf, cap, "");
+    string_append(buf, foo);
+    char *spare = string_spare(buf, &res);
+    assert(spare == buf->data + strlen(foo) && res == cap - strlen(foo));
+    memcpy(spare, bar, strlen(bar));
+    assert(string_commit(buf, strlen(bar)));
+    check(buf, cap, "foobar");
+    assert(!string_commit(buf, cap));
+    assert(string_reserve(&buf, 4));
+    assert(buf->capacity == cap);
+    assert(string_reserve(&buf, 40));
+    assert(buf->capacity >= 46 && buf->length == 6);
+    spare = string_spare(buf, &res);
+    assert(res >= 40);
+    memset(spare, 'x', 40);
+    assert(string_commit(buf, 40));
+    assert(buf->length == 46 && strlen(buf->data) == 46 && buf->data[45] == 'x');
+    assert(!string_reserve(&buf, UINT32_MAX));
+    free(buf);
+
+    // large Strings: glibc maps them and grows them with mremap (one mapped chunk throughout, no copy)
+#if STRINGS_TEST_MALLINFO
+    struct mallinfo2 before = mallinfo2();
+#endif
+    buf = string_new_uninit(40 << 20);
+    memset(string_spare(buf, NULL), 'L', 40 << 20);
+    string_commit(buf, 40 << 20);
+    for (uint32_t n = 1; n <= 4; n++)
+        assert(string_resize(&buf, (40 + 16 * n) << 20));
+    assert(buf->capacity >= (104 << 20) && buf->data[0] == 'L' && buf->data[(40 << 20) - 1] == 'L' && buf->data[40 << 20] == 0);
+#if STRINGS_TEST_MALLINFO
+    assert(mallinfo2().hblks == before.hblks + 1 && mallinfo2().hblkhd >= before.hblkhd + (104 << 20));
+#endif
+    free(buf);
+
     printf("string_core tests OK\n");
 
     a = string_new_c("es un test");
@@ -400,11 +461,1282 @@ int main(void) {
     for (int n = 0; n < hash.outlen; n++)
         string_append(b, "%02x", hash.out[n]);
     assert(string_equals_c(b, "eac1d8508e6a7f5a"));
+    free(b);
+
+    // word helpers are the SIP64 / SIP128 output bytes
+    uint64_t w1, w2;
+    hash = string_hash(a, SIP64, key);
+    memcpy(&w1, hash.out, 8);
+    assert(string_hash64_view(string_view(a), key) == w1);
+    hash = string_hash(a, SIP128, key);
+    string_hash128_view(string_view(a), key, &w1, &w2);
+    assert(memcmp(&w1, hash.out, 8) == 0 && memcmp(&w2, hash.out + 8, 8) == 0);
+    assert(string_hash64_view((string_view_t) { NULL, 0 }, key) == string_hash64_view(string_view_c(""), key));
+    free(a);
+
+    // incremental hash: matches the reference SipHash / HalfSipHash however the input is split
+    {
+        char msg[200];
+        uint8_t ref[16], rkey[16];
+        for (int n = 0; n < (int) sizeof(msg); n++)
+            msg[n] = (char) rand();
+        for (int len = 0; len <= (int) sizeof(msg); len++) {
+            for (int n = 0; n < 16; n++)
+                rkey[n] = (uint8_t) rand();
+            for (uint8_t v = SIP64; v <= HSIP64; v++) {
+                const int outlen = v == SIP128 ? 16 : v == HSIP32 ? 4 : 8;
+                if (v < HSIP32)
+                    siphash(msg, len, rkey, ref, outlen);
+                else
+                    halfsiphash(msg, len, rkey, ref, outlen);
+                hash = string_hash_view((string_view_t) { msg, len }, v, rkey);
+                assert(hash.outlen == (size_t) outlen && memcmp(hash.out, ref, outlen) == 0);
+
+                string_hash_state_t st;
+                assert(string_hash_init(&st, v, rkey));
+                for (int pos = 0; pos < len;) {
+                    int step = 1 + rand() % 11;
+                    step = step < len - pos ? step : len - pos;
+                    string_hash_update(&st, msg + pos, step);
+                    pos += step;
+                }
+                hash = string_hash_final(&st);
+                assert(hash.outlen == (size_t) outlen && memcmp(hash.out, ref, outlen) == 0);
+            }
+        }
+        string_hash_state_t st;
+        assert(string_hash_init(&st, CRC32C, NULL));
+        string_hash_update(&st, msg, 7);
+        string_hash_update(&st, msg + 7, 93);
+        hash = string_hash_final(&st);
+        string_hash_t whole = string_hash_view((string_view_t) { msg, 100 }, CRC32C, NULL);
+        assert(hash.outlen == 4 && memcmp(hash.out, whole.out, 4) == 0);
+        assert(!string_hash_init(&st, CRC32C + 1, key) && string_hash_final(&st).outlen == 0);
+        assert(!string_hash_init(&st, SIP64, NULL));
+    }
+
+    // _into variants
+    a = string_new_c("  Hello, World  ");
+    b = string_new_c("World");
+    c = string_new_c("There");
+    cpy = NULL;
+    assert(string_trim_into(&cpy, a) && string_equals_c(cpy, "Hello, World"));
+    String prev = cpy;
+    assert(string_left_into(&cpy, a, 6) && string_equals_c(cpy, "  Hello"));
+    assert(cpy == prev);
+    assert(string_right_into(&cpy, a, 9) && string_equals_c(cpy, "World  "));
+    assert(string_mid_into(&cpy, a, 3, 7) && string_equals_c(cpy, "Hello"));
+    assert(string_toupper_into(&cpy, cpy) && string_equals_c(cpy, "HELLO"));
+    assert(string_tolower_into(&cpy, a) && string_equals_c(cpy, "  hello, world  "));
+    assert(cpy != prev && cpy->capacity >= 16);
+    prev = cpy;
+    assert(string_ltrim_into(&cpy, a) && string_equals_c(cpy, "Hello, World  "));
+    assert(string_rtrim_into(&cpy, cpy) && string_equals_c(cpy, "Hello, World"));
+    assert(string_replace_into(&cpy, cpy, b, c, 0) && string_equals_c(cpy, "Hello, There"));
+    assert(!string_replace_into(&cpy, cpy, b, c, 0) && string_equals_c(cpy, "Hello, There"));
+    assert(string_delete_into(&cpy, cpy, 5, 6) && string_equals_c(cpy, "HelloThere"));
+    assert(string_insert_into(&cpy, cpy, b, 5) && string_equals_c(cpy, "HelloWorldThere"));
+    assert(cpy == prev);
+    assert(string_insert_into(&cpy, cpy, cpy, 0) && string_equals_c(cpy, "HelloWorldThereHelloWorldThere"));
+    assert(string_concat_into(&cpy, b, c) && string_equals_c(cpy, "WorldThere"));
+    assert(string_concat_into(&cpy, b, cpy) && string_equals_c(cpy, "WorldWorldThere"));
+    assert(string_concat_into(&cpy, cpy, cpy) && string_equals_c(cpy, "WorldWorldThereWorldWorldThere"));
+    assert(!string_mid_into(&cpy, a, 0, 3) && !string_left_into(&cpy, a, 16));
+    prev = cpy;
+    for (int n = 0; n < 100; n++) {
+        assert(string_trim_into(&cpy, a));
+        assert(string_replace_into(&cpy, cpy, b, c, 0));
+    }
+    assert(cpy == prev && string_equals_c(cpy, "Hello, There"));
+    free(cpy);
     free(a);
     free(b);
+    free(c);
 
     printf("string_functions tests OK\n");
 
+    string_bloom_t *bloom = string_bloom_new(10000, 0.01, key);
+    for (uint32_t n = 0; n < 10000; n++) {
+        a = string_new(16);
+        string_append(a, "key%u", n);
+        string_bloom_add(bloom, a);
+        free(a);
+    }
+    b = string_bloom_serialize(bloom);
+    string_bloom_free(bloom);
+    bloom = string_bloom_deserialize(b);
+    assert(bloom != NULL);
+    free(b);
+    res = 0;
+    for (uint32_t n = 0; n < 100000; n++) {
+        a = string_new(16);
+        string_append(a, "key%u", n);
+        if (n < 10000)
+            assert(string_bloom_contains(bloom, a));
+        else if (string_bloom_contains(bloom, a))
+            ++res;
+        free(a);
+    }
+    // false positive rate near 1%
+    assert(res < 90000 / 50);
+    string_bloom_free(bloom);
+
+    string_cuckoo_t *cuckoo = string_cuckoo_new(10000, key);
+    for (uint32_t n = 0; n < 10000; n++) {
+        a = string_new(16);
+        string_append(a, "key%u", n);
+        assert(string_cuckoo_add(cuckoo, a));
+        free(a);
+    }
+    for (uint32_t n = 0; n < 10000; n += 2) {
+        a = string_new(16);
+        string_append(a, "key%u", n);
+        assert(string_cuckoo_remove(cuckoo, a));
+        free(a);
+    }
+    b = string_cuckoo_serialize(cuckoo);
+    string_cuckoo_free(cuckoo);
+    cuckoo = string_cuckoo_deserialize(b);
+    assert(cuckoo != NULL && cuckoo->count == 5000);
+    free(b);
+    res = 0;
+    for (uint32_t n = 0; n < 100000; n++) {
+        a = string_new(16);
+        string_append(a, "key%u", n);
+        if (n < 10000 && (n & 1))
+            assert(string_cuckoo_contains(cuckoo, a));
+        else if (string_cuckoo_contains(cuckoo, a))
+            ++res;
+        free(a);
+    }
+    // false positive rate near 0.1%
+    assert(res < 95000 / 200);
+    string_cuckoo_free(cuckoo);
+
+    printf("string_filter tests OK\n");
+
+    string_hll_t *hll1 = string_hll_new(14, key);
+    string_hll_t *hll2 = string_hll_new(14, key);
+    for (uint32_t n = 0; n < 100; n++) {
+        a = string_new(16);
+        string_append(a, "agent%u", n);
+        string_hll_add(hll1, a);
+        string_hll_add_view(hll1, string_view(a));
+        free(a);
+    }
+    assert(hll1->sparse);
+    assert(fabs(string_hll_count(hll1) - 100) < 3);
+    for (uint32_t n = 0; n < 100000; n++) {
+        a = string_new(16);
+        string_append(a, "agent%u", n);
+        string_hll_add(n & 1 ? hll1 : hll2, a);
+        free(a);
+    }
+    assert(!hll1->sparse);
+    assert(string_hll_merge(hll1, hll2));
+    assert(fabs(string_hll_count(hll1) - 100000) < 100000 * 0.03);
+    string_hll_free(hll1);
+    string_hll_free(hll2);
+
+    string_cms_t *cms1 = string_cms_new(2048, 4, key);
+    string_cms_t *cms2 = string_cms_new(2048, 4, key);
+    string_topk_t *topk1 = string_topk_new(10, key);
+    string_topk_t *topk2 = string_topk_new(10, key);
+    for (uint32_t n = 1; n <= 20000; n++) {
+        // frequencies: url2 > url1 > url0 > rest
+        a = string_new(16);
+        string_append(a, "url%u", (n % 7 == 0) ? 0 : (n % 5 == 0) ? 1 : (n % 3 == 0) ? 2 : n);
+        string_cms_add(n & 1 ? cms1 : cms2, a, 1);
+        string_topk_add(n & 1 ? topk1 : topk2, a, 1);
+        free(a);
+    }
+    assert(string_cms_merge(cms1, cms2));
+    assert(string_cms_estimate_view(cms1, string_view_c("url0")) >= 20000 / 7);
+    assert(string_cms_estimate_view(cms1, string_view_c("url0")) < 20000 / 7 + 100);
+    assert(string_topk_merge(topk1, topk2));
+    string_topk_entry_t top[10];
+    res = string_topk_list(topk1, top);
+    assert(res == 10);
+    assert(string_equals_c(top[0].key, "url2"));
+    assert(string_equals_c(top[1].key, "url1"));
+    assert(string_equals_c(top[2].key, "url0"));
+    assert(top[2].count - top[2].error <= 20000 / 7 + 1 && top[2].count >= 20000 / 7);
+    string_cms_free(cms1);
+    string_cms_free(cms2);
+    string_topk_free(topk1);
+    string_topk_free(topk2);
+
+    printf("string_sketch tests OK\n");
+
+    string_split_iter_t split;
+    string_view_t token;
+    a = string_new_c("a,,bc,");
+    string_split_iter(&split, a, ",");
+    assert(string_split_next(&split, &token) && token.length == 1 && token.data[0] == 'a');
+    assert(string_split_next(&split, &token) && token.length == 0);
+    assert(string_split_next(&split, &token) && token.length == 2 && !memcmp(token.data, "bc", 2));
+    assert(string_split_next(&split, &token) && token.length == 0);
+    assert(!string_split_next(&split, &token));
+    free(a);
+
+    string_shingle_iter_t shingles;
+    a = string_new_c("the  quick brown fox");
+    assert(string_shingle_iter(&shingles, a, SHINGLE_WORDS, 2, " "));
+    assert(string_shingle_next(&shingles, &token) && token.length == 10 && !memcmp(token.data, "the  quick", 10));
+    assert(string_shingle_next(&shingles, &token) && token.length == 11 && !memcmp(token.data, "quick brown", 11));
+    assert(string_shingle_next(&shingles, &token) && token.length == 9 && !memcmp(token.data, "brown fox", 9));
+    assert(!string_shingle_next(&shingles, &token));
+    assert(string_shingle_iter(&shingles, a, SHINGLE_BYTES, 4, NULL));
+    res = 0;
+    while (string_shingle_next(&shingles, &token))
+        ++res;
+    assert(res == a->length - 3);
+    free(a);
+
+    uint64_t sig1[128], sig2[128], sig3[128];
+    uint32_t ids[8];
+    a = string_new_c("lorem ipsum dolor sit amet consectetur adipiscing elit sed do eiusmod tempor incididunt ut labore et dolore magna aliqua");
+    b = string_new_c("lorem ipsum dolor sit amet consectetur adipiscing elit sed do eiusmod tempor incididunt ut labore et dolore magna aliquam");
+    c = string_new_c("a completely different document about hashing strings into signatures for near duplicate detection");
+    assert(string_minhash(a, SHINGLE_WORDS, 3, " ", key, sig1, 128));
+    assert(string_minhash(b, SHINGLE_WORDS, 3, " ", key, sig2, 128));
+    assert(string_minhash(c, SHINGLE_WORDS, 3, " ", key, sig3, 128));
+    // jaccard(a, b) = 16 / 18
+    assert(fabs(string_minhash_similarity(sig1, sig2, 128) - 16.0 / 18) < 0.12);
+    assert(string_minhash_similarity(sig1, sig3, 128) < 0.1);
+    assert(string_simhash_distance(string_simhash(a, SHINGLE_BYTES, 4, NULL, key), string_simhash(b, SHINGLE_BYTES, 4, NULL, key)) < 10);
+    assert(string_simhash_distance(string_simhash(a, SHINGLE_BYTES, 4, NULL, key), string_simhash(c, SHINGLE_BYTES, 4, NULL, key)) > 10);
+    string_lsh_t *lsh = string_lsh_new(32, 4);
+    assert(string_lsh_add(lsh, sig1, 1));
+    assert(string_lsh_add(lsh, sig3, 3));
+    res = string_lsh_query(lsh, sig2, ids, 8);
+    assert(res == 1 && ids[0] == 1);
+    string_lsh_free(lsh);
+    free(a);
+    free(b);
+    free(c);
+
+    printf("string_similarity tests OK\n");
+
+    string_rolling_t roll;
+    a = string_new_c("abcdefgh cdef abcdefgh");
+    for (uint8_t type = ROLLING_RABIN_KARP; type <= ROLLING_BUZHASH; type++) {
+        string_rolling_t fresh;
+        assert(string_rolling_init(&roll, type, 4));
+        assert(string_rolling_init(&fresh, type, 4));
+        string_rolling_start(&roll, a->data);
+        for (uint32_t n = 4; n < a->length; n++) {
+            uint64_t h = string_rolling_roll(&roll, a->data[n - 4], a->data[n]);
+            assert(h == string_rolling_start(&fresh, a->data + n - 3));
+        }
+    }
+    free(a);
+
+    String patterns[3];
+    string_rk_match_t *matches;
+    uint32_t pattern;
+    a = string_new_c("the cat sat on the mat with a bat");
+    patterns[0] = string_new_c("cat");
+    patterns[1] = string_new_c("mat");
+    patterns[2] = string_new_c("the");
+    string_rk_t *rk = string_rk_new(patterns, 3);
+    assert(string_rk_find(rk, a, 0, &pattern) == 0 && pattern == 2);
+    assert(string_rk_find(rk, a, 1, &pattern) == 4 && pattern == 0);
+    assert(string_rk_find(rk, a, 20, &pattern) == STR_ERROR);
+    res = string_rk_find_all(rk, a, &matches);
+    assert(res == 4);
+    assert(matches[2].pos == 15 && matches[2].pattern == 2);
+    assert(matches[3].pos == 19 && matches[3].pattern == 1);
+    free(matches);
+    string_rk_free(rk);
+    free(a);
+    a = string_new_c("The CAT sat on the Mat");
+    rk = string_rk_new_nocase(patterns, 3);
+    assert(string_rk_find(rk, a, 0, &pattern) == 0 && pattern == 2);
+    assert(string_rk_find(rk, a, 1, &pattern) == 4 && pattern == 0);
+    res = string_rk_find_all(rk, a, &matches);
+    assert(res == 4 && matches[3].pos == 19 && matches[3].pattern == 1);
+    free(matches);
+    string_rk_free(rk);
+    rk = string_rk_new(patterns, 3);
+    assert(string_rk_find(rk, a, 0, &pattern) == 15 && pattern == 2);
+    string_rk_free(rk);
+    for (int n = 0; n < 3; n++)
+        free(patterns[n]);
+    free(a);
+
+    string_view_t chunk;
+    string_stream_match_t *smatches;
+    a = string_new(4096);
+    for (uint32_t n = 0; n < a->capacity; n++)
+        a->data[n] = "abc"[rand() % 3];
+    a->length = a->capacity;
+    patterns[0] = string_new_c("abcab");
+    patterns[1] = string_new_c("cccaa");
+    patterns[2] = string_new_c("babab");
+    rk = string_rk_new(patterns, 3);
+    res = string_rk_find_all(rk, a, &matches);
+    string_stream_t *st1 = string_stream_new_rk(rk);
+    string_stream_t *st2 = string_stream_new(patterns[0]);
+    uint32_t found1 = 0, found2 = 0, single = 0;
+    for (uint32_t n = 0; n < res; n++)
+        single += matches[n].pattern == 0;
+    for (uint32_t from = 0; from < a->length;) {
+        chunk.data = a->data + from;
+        chunk.length = 1 + rand() % 9;
+        if (from + chunk.length > a->length)
+            chunk.length = a->length - from;
+        uint32_t count = string_stream_feed(st1, chunk, &smatches);
+        for (uint32_t n = 0; n < count; n++, found1++)
+            assert(smatches[n].pos == matches[found1].pos && smatches[n].pattern == matches[found1].pattern);
+        free(smatches);
+        count = string_stream_feed(st2, chunk, &smatches);
+        for (uint32_t n = 0; n < count; n++, found2++)
+            assert(!memcmp(a->data + smatches[n].pos, "abcab", 5) && smatches[n].pattern == 0);
+        free(smatches);
+        from += chunk.length;
+    }
+    assert(found1 == res && found2 == single && res > 0);
+    string_stream_reset(st2);
+    chunk = string_view_c("xxab");
+    assert(string_stream_feed(st2, chunk, &smatches) == 0);
+    chunk = string_view_c("cabx");
+    assert(string_stream_feed(st2, chunk, &smatches) == 1 && smatches[0].pos == 2);
+    free(smatches);
+    string_stream_free(st1);
+    string_stream_free(st2);
+    string_rk_free(rk);
+    free(matches);
+    for (int n = 0; n < 3; n++)
+        free(patterns[n]);
+    free(a);
+
+    string_cdc_t cdc;
+    a = string_new(1 << 20);
+    for (uint32_t n = 0; n < a->capacity; n++)
+        a->data[n] = (char) (n * 2654435761u >> 13);
+    a->length = a->capacity;
+    assert(string_cdc_init(&cdc, a, 2048, 8192, 65536));
+    res = 0;
+    uint32_t total = 0;
+    while (string_cdc_next(&cdc, &chunk)) {
+        assert(chunk.data == a->data + total);
+        assert(chunk.length <= 65536 && (chunk.length >= 2048 || total + chunk.length == a->length));
+        total += chunk.length;
+        ++res;
+    }
+    assert(total == a->length);
+    assert(res > 1048576 / 65536 && res < 1048576 / 2048);
+    free(a);
+
+    printf("string_rolling tests OK\n");
+
+    String keys[1000], nodes[5];
+    uint32_t shards1[1000], shards2[1000];
+    for (uint32_t n = 0; n < 1000; n++) {
+        keys[n] = string_new(16);
+        string_append(keys[n], "user:%u", n);
+    }
+    for (uint32_t n = 0; n < 5; n++) {
+        nodes[n] = string_new(16);
+        string_append(nodes[n], "backend-%u", n);
+    }
+    assert(string_shard_jump_batch(keys, 1000, 10, key, shards1));
+    assert(string_shard_jump_batch(keys, 1000, 11, key, shards2));
+    res = 0;
+    for (uint32_t n = 0; n < 1000; n++) {
+        assert(shards1[n] == string_shard_jump(keys[n], 10, key));
+        if (shards1[n] != shards2[n]) {
+            assert(shards2[n] == 10);
+            ++res;
+        }
+    }
+    assert(res > 1000 / 11 / 2 && res < 1000 / 11 * 2);
+
+    string_shard_ring_t *ring1 = string_shard_ring_new(nodes, 5, 100, key);
+    string_shard_ring_t *ring2 = string_shard_ring_new(nodes, 4, 100, key);
+    assert(string_shard_ring_batch(ring1, keys, 1000, shards1));
+    assert(string_shard_ring_batch(ring2, keys, 1000, shards2));
+    for (uint32_t n = 0; n < 1000; n++) {
+        assert(shards1[n] == string_shard_ring(ring1, keys[n]));
+        assert(shards1[n] == 4 || shards1[n] == shards2[n]);
+    }
+    assert(string_shard_rendezvous_batch(ring1, keys, 1000, shards1));
+    assert(string_shard_rendezvous_batch(ring2, keys, 1000, shards2));
+    res = 0;
+    for (uint32_t n = 0; n < 1000; n++) {
+        assert(shards1[n] == string_shard_rendezvous(ring1, keys[n]));
+        assert(shards1[n] == 4 || shards1[n] == shards2[n]);
+        res += shards1[n] == 4;
+    }
+    assert(res > 100 && res < 300);
+    string_shard_ring_free(ring1);
+    string_shard_ring_free(ring2);
+    for (uint32_t n = 0; n < 1000; n++)
+        free(keys[n]);
+    for (uint32_t n = 0; n < 5; n++)
+        free(nodes[n]);
+
+    printf("string_shard tests OK\n");
+
+    const uint8_t active = string_simd_tier();
+    const char *alphabet = "ab AZ\t\n09z_\x80\xe1";
+    char text[300], out1[300], out2[300];
+    assert(!string_simd_force(SIMD_AVX512 + 1));
+    for (uint8_t tier = SIMD_SCALAR; tier <= string_simd_detected(); tier++) {
+        assert(string_simd_force(tier));
+        const string_simd_kernels_t *simd = string_simd;
+        assert(string_simd_force(SIMD_SCALAR));
+        const string_simd_kernels_t *ref = string_simd;
+        srand(tier);
+        for (int round = 0; round < 2000; round++) {
+            const size_t len = rand() % sizeof(text);
+            for (size_t n = 0; n < len; n++)
+                text[n] = alphabet[rand() % 14];
+            const size_t at = len ? rand() % len : 0;
+            const size_t m = 1 + rand() % 5;
+            assert(simd->find_byte(text, len, '_') == ref->find_byte(text, len, '_'));
+            if (at + m <= len)
+                assert(simd->find(text, len, text + at, m) == ref->find(text, len, text + at, m));
+            assert(simd->find(text, len, "a_Z\n", 4) == ref->find(text, len, "a_Z\n", 4));
+            simd->to_upper(out1, text, len);
+            ref->to_upper(out2, text, len);
+            assert(!memcmp(out1, out2, len));
+            simd->to_lower(out1, text, len);
+            ref->to_lower(out2, text, len);
+            assert(!memcmp(out1, out2, len));
+            memset(text, ' ', at);
+            assert(simd->skip_space(text, len) == ref->skip_space(text, len));
+            assert(simd->rskip_space(text + at, len - at) == ref->rskip_space(text + at, len - at));
+            memset(text, '7', at);
+            assert(simd->skip_digits(text, len) == ref->skip_digits(text, len));
+            assert(simd->crc32c(0, text, len) == ref->crc32c(0, text, len));
+        }
+        assert(simd->crc32c(0, "123456789", 9) == 0xE3069283);
+    }
+    assert(string_simd_force(active));
+
+    string_byteset_t delims, letters, high;
+    string_byteset(&delims, ",;_\n\xe9");
+    string_byteset(&letters, "aAzZ");
+    string_byteset(&high, "\x80\x81\xc3\xe9\xff");
+    for (uint8_t tier = SIMD_SCALAR; tier <= string_simd_detected(); tier++) {
+        assert(string_simd_force(tier));
+        const string_simd_kernels_t *simd = string_simd;
+        assert(string_simd_force(SIMD_SCALAR));
+        const string_simd_kernels_t *ref = string_simd;
+        srand(tier);
+        for (int round = 0; round < 2000; round++) {
+            const size_t len = rand() % sizeof(text);
+            for (size_t n = 0; n < len; n++)
+                text[n] = alphabet[rand() % 14];
+            const size_t at = len ? rand() % len : 0;
+            const size_t m = 1 + rand() % 5;
+            assert(simd->rfind_byte(text, len, '_') == ref->rfind_byte(text, len, '_'));
+            if (at + m <= len)
+                assert(simd->rfind(text, len, text + at, m) == ref->rfind(text, len, text + at, m));
+            assert(simd->rfind(text, len, "a_Z\n", 4) == ref->rfind(text, len, "a_Z\n", 4));
+            assert(simd->rfind_any(text, len, "_\n", 2) == ref->rfind_any(text, len, "_\n", 2));
+            assert(simd->span(text, len, &delims, false) == ref->span(text, len, &delims, false));
+            if (at + m <= len) {
+                memcpy(out1, text + at, m);
+                ref->to_upper(out1, out1, m);
+                assert(simd->find_nocase(text, len, out1, m) == ref->find_nocase(text, len, out1, m));
+                assert(simd->find_nocase(text, len, out1, m) <= at);
+                assert(simd->equal_nocase(text + at, out1, m));
+            }
+            assert(simd->find_nocase(text, len, "A_z", 3) == ref->find_nocase(text, len, "A_z", 3));
+            if (at + m <= len) {
+                const size_t from = rand() % (at + 1);
+                assert(simd->find_word(text, len, from, text + at, m, &letters) == ref->find_word(text, len, from, text + at, m, &letters));
+            }
+            assert(simd->find_word(text, len, 0, "a", 1, &letters) == ref->find_word(text, len, 0, "a", 1, &letters));
+            memcpy(out1, text, len);
+            if (len > 0)
+                out1[rand() % len] ^= 1 << (rand() % 8);
+            assert(simd->mismatch(text, out1, len) == ref->mismatch(text, out1, len));
+            assert(simd->rmismatch(text, out1, len) == ref->rmismatch(text, out1, len));
+            memset(text, 'a', at);
+            assert(simd->span(text, len, &letters, true) == ref->span(text, len, &letters, true));
+            for (size_t n = 0; n < len; n++)
+                text[n] = (char) rand();
+            assert(simd->span(text, len, &delims, false) == ref->span(text, len, &delims, false));
+            assert(simd->span(text, len, &high, true) == ref->span(text, len, &high, true));
+            assert(simd->count_byte(text, len, 0xe9) == ref->count_byte(text, len, 0xe9));
+            uint32_t pos1[sizeof(text)], pos2[sizeof(text)];
+            const size_t hits = ref->index_byte(text, len, text[at], pos2, 7);
+            assert(simd->index_byte(text, len, text[at], pos1, 7) == hits);
+            assert(!memcmp(pos1, pos2, hits * sizeof(uint32_t)));
+        }
+    }
+    assert(string_simd_force(active));
+
+    // padded kernels over String data: full vector tails read and write into STRING_PAD
+    buf = string_new(sizeof(text));
+    cpy = string_new(sizeof(text));
+    assert((uintptr_t) buf->data % STRING_ALIGN == 0 && (uintptr_t) cpy->data % STRING_ALIGN == 0);
+    for (uint8_t tier = SIMD_SCALAR; tier <= string_simd_detected(); tier++) {
+        assert(string_simd_force(tier));
+        const string_simd_kernels_t *simd = string_simd;
+        assert(string_simd_force(SIMD_SCALAR));
+        const string_simd_kernels_t *ref = string_simd;
+        srand(tier);
+        for (int round = 0; round < 2000; round++) {
+            const size_t len = rand() % (sizeof(text) + 1);
+            for (size_t n = 0; n < sizeof(text); n++)
+                buf->data[n] = alphabet[rand() % 14];
+            const size_t at = len ? rand() % len : 0;
+            assert(simd->count_byte_padded(buf->data, len, 'a') == ref->count_byte(buf->data, len, 'a'));
+            simd->to_upper_padded(cpy->data, buf->data, len);
+            ref->to_upper(out2, buf->data, len);
+            assert(!memcmp(cpy->data, out2, len));
+            memcpy(out1, buf->data, len);
+            simd->to_lower_padded(buf->data, buf->data, len);
+            ref->to_lower(out2, out1, len);
+            assert(!memcmp(buf->data, out2, len));
+            memset(buf->data, ' ', at);
+            assert(simd->skip_space_padded(buf->data, len) == ref->skip_space(buf->data, len));
+        }
+    }
+    assert(string_simd_force(active));
+    free(cpy);
+    free(buf);
+
+    string_view_t left, right;
+    a = string_new_c("/usr/lib/libstrings.so.1");
+    assert(string_rfind_c(a, "/", a->length) == 8);
+    assert(string_rfind_c(a, "/", 7) == 4);
+    assert(string_rfind_c(a, "lib", a->length) == 9);
+    assert(string_rfind_c(a, "lib", 8) == 5);
+    assert(string_rfind_c(a, "x", a->length) == STR_ERROR);
+    assert(string_rfind_any(a, "./", a->length) == 22);
+    assert(string_rsplit_any_view(a, "/\\", &left, &right));
+    assert(left.length == 8 && right.length == 15 && !memcmp(right.data, "libstrings.so.1", 15));
+    assert(string_rsplit_view(a, ".so", &left, &right));
+    assert(left.length == 19 && right.length == 2 && !memcmp(right.data, ".1", 2));
+    assert(!string_rsplit_view(a, ".dll", &left, &right));
+    b = string_new_c("lib");
+    assert(string_rfind(a, b, a->length) == 9);
+    free(b);
+    free(a);
+
+    for (int c = 0; c < 256; c++)
+        assert(string_byteset_has(&high, c) == (c == 0x80 || c == 0x81 || c == 0xc3 || c == 0xe9 || c == 0xff));
+    a = string_new_c("key=value; other ,last");
+    assert(string_find_any(a, ";,", 0) == 9);
+    assert(string_find_any(a, ";,", 10) == 17);
+    assert(string_find_any(a, "#", 0) == STR_ERROR);
+    string_byteset(&delims, "; ,");
+    assert(string_span(a, &delims, 9) == 2);
+    assert(string_cspan(a, &delims, 0) == 9);
+    const char *tokens[] = { "key=value", "", "other", "", "last" };
+    int count = 0;
+    string_split_set_iter(&split, a, &delims);
+    while (string_split_next(&split, &token)) {
+        assert(token.length == strlen(tokens[count]) && !memcmp(token.data, tokens[count], token.length));
+        count++;
+    }
+    assert(count == 5);
+    free(a);
+
+    a = string_new_c("Error: disk error; ERROR again, errors");
+    b = string_new_c("error");
+    assert(string_find_nocase(a, b, 0) == 0);
+    assert(string_find_nocase(a, b, 1) == 12);
+    assert(string_find_nocase_c(a, "AGAIN", 0) == 25);
+    assert(string_find_nocase_c(a, "warning", 0) == STR_ERROR);
+    uint32_t *positions;
+    assert(string_find_all_nocase(a, b, &positions) == 4);
+    assert(positions[0] == 0 && positions[1] == 12 && positions[2] == 19 && positions[3] == 32);
+    free(positions);
+    String rep = string_new_c("warn");
+    buf = string_replace_nocase(a, b, rep, 1);
+    assert(string_equals_c(buf, "Error: disk warn; ERROR again, errors"));
+    free(buf);
+    buf = string_replace_all_nocase(a, b, rep);
+    assert(string_equals_c(buf, "warn: disk warn; warn again, warns") && buf->capacity == buf->length);
+    free(buf);
+    free(rep);
+    free(b);
+    free(a);
+
+    a = string_new_c("un until un_do un.un (un)");
+    b = string_new_c("un");
+    assert(string_find_word(a, b, NULL, 0) == 0);
+    assert(string_find_word(a, b, NULL, 1) == 15);
+    assert(string_find_word(a, b, NULL, 16) == 18);
+    assert(string_count_word(a, b, NULL) == 4);
+    string_byteset(&letters, "abcdefghijklmnopqrstuvwxyz");
+    assert(string_count_word(a, b, &letters) == 5);
+    rep = string_new_c("UN");
+    buf = string_replace_word(a, b, rep, NULL);
+    assert(string_equals_c(buf, "UN until un_do UN.UN (UN)") && buf->capacity == buf->length);
+    free(buf);
+    free(rep);
+    free(b);
+    b = string_new_c("until");
+    assert(string_find_word(a, b, NULL, 0) == 3);
+    free(b);
+    free(a);
+
+    a = string_new_c("first\n\nthird line\nlast");
+    assert(string_count_byte(a, '\n') == 3);
+    assert(string_count_byte(a, 'x') == 0);
+    string_line_index_t *lines = string_line_index_new(a);
+    assert(lines->lines == 4);
+    assert(string_line_offset(lines, 2) == 7 && string_line_offset(lines, 4) == STR_ERROR);
+    assert(string_line_at(lines, 0) == 0 && string_line_at(lines, 5) == 0 && string_line_at(lines, 6) == 1);
+    assert(string_line_at(lines, 7) == 2 && string_line_at(lines, a->length) == 3);
+    assert(string_line_view(a, lines, 1, &token) && token.length == 0);
+    assert(string_line_view(a, lines, 2, &token) && token.length == 10 && !memcmp(token.data, "third line", 10));
+    assert(string_line_view(a, lines, 3, &token) && token.length == 4 && !memcmp(token.data, "last", 4));
+    string_line_index_free(lines);
+    free(a);
+
+    b = string_new(1 << 20);
+    memset(b->data, 'x', 1 << 20);
+    b->length = 1 << 20;
+    for (uint32_t n = 99; n < b->length; n += 100)
+        b->data[n] = '\n';
+    assert(string_count_byte(b, '\n') == (1 << 20) / 100);
+    lines = string_line_index_new(b);
+    assert(string_line_at(lines, 512345) == 5123 && string_line_offset(lines, 5123) == 512300);
+    string_line_index_free(lines);
+    free(b);
+
+    a = string_new_c("   \t  \n ");
+    assert(string_isblank(a));
+    buf = string_trim(a);
+    assert(buf->length == 0);
+    free(buf);
+    buf = string_rtrim(a);
+    assert(buf->length == 0);
+    free(buf);
+    free(a);
+
+    printf("string_simd tests OK\n");
+
+    string_tr_t tr;
+    assert(string_tr_compile(&tr, "a-z", "A-Z", NULL, NULL));
+    a = string_new_c("Hello, World 42");
+    buf = string_tr(a, &tr);
+    assert(string_equals_c(buf, "HELLO, WORLD 42") && buf->capacity == a->length);
+    free(buf);
+    assert(string_tr_compile(&tr, ",;\\t", "_", NULL, "_ "));
+    free(a);
+    a = string_new_c("a,,b;\tc   d");
+    buf = string_tr(a, &tr);
+    assert(string_equals_c(buf, "a_b_c d") && buf->capacity == buf->length);
+    free(buf);
+    assert(string_tr_compile(&tr, NULL, NULL, "\\x00-\\x1f\\x7f", NULL));
+    free(a);
+    a = string_new_c("line\r\n\x01tab\tend\x7f");
+    assert(string_tr_inplace(a, &tr) == 10 && string_equals_c(a, "linetabend"));
+    assert(string_tr_compile(&tr, "\\x80-\\xff", "?", NULL, "?"));
+    free(a);
+    a = string_new_c("caf\xc3\xa9 ok");
+    assert(string_tr_inplace(a, &tr) == 7 && string_equals_c(a, "caf? ok"));
+    free(a);
+    assert(!string_tr_compile(&tr, "z-a", "x", NULL, NULL));
+    assert(!string_tr_compile(&tr, "abc", "", NULL, NULL));
+    assert(!string_tr_compile(&tr, "\\q", "x", NULL, NULL));
+
+    assert(string_tr_compile(&tr, "\\x00-\\xff", "\\xff-\\xff", NULL, NULL));
+    for (int c = 0; c < 256; c++)
+        tr.map[c] = (uint8_t) (c * 7 + 3);
+    for (uint8_t tier = SIMD_SCALAR; tier <= string_simd_detected(); tier++) {
+        assert(string_simd_force(tier));
+        const string_simd_kernels_t *simd = string_simd;
+        assert(string_simd_force(SIMD_SCALAR));
+        const string_simd_kernels_t *ref = string_simd;
+        for (int round = 0; round < 500; round++) {
+            const size_t len = rand() % sizeof(text);
+            for (size_t n = 0; n < len; n++)
+                text[n] = (char) rand();
+            simd->translate(out1, text, len, tr.map);
+            ref->translate(out2, text, len, tr.map);
+            assert(!memcmp(out1, out2, len));
+        }
+    }
+    assert(string_simd_force(active));
+
+    printf("string_tr tests OK\n");
+
+    string_diff_op_t *ops;
+    a = string_new_c("host=a\nport=80\nuser=root\nmode=fast\n");
+    b = string_new_c("host=a\nport=8080\nuser=root\nlog=on\nmode=fast\n");
+    res = string_diff(a, b, DIFF_LINES, &ops);
+    assert(res == 6);
+    assert(ops[0].op == DIFF_EQUAL && ops[0].text.length == 7);
+    assert(ops[1].op == DIFF_DELETE && ops[1].text.length == 8 && !memcmp(ops[1].text.data, "port=80\n", 8));
+    assert(ops[2].op == DIFF_INSERT && ops[2].text.length == 10 && !memcmp(ops[2].text.data, "port=8080\n", 10));
+    assert(ops[3].op == DIFF_EQUAL && ops[3].text.length == 10);
+    assert(ops[4].op == DIFF_INSERT && !memcmp(ops[4].text.data, "log=on\n", 7));
+    assert(ops[5].op == DIFF_EQUAL && ops[5].text.data == a->data + 25);
+    buf = string_patch(a, ops, res);
+    assert(string_equals(buf, b) && buf->capacity == b->length);
+    free(buf);
+    free(ops);
+    res = string_diff(a, b, DIFF_BYTES, &ops);
+    assert(res == 5 && ops[1].op == DIFF_INSERT && ops[1].text.length == 2);
+    assert(ops[3].op == DIFF_INSERT && ops[3].text.length == 7);
+    buf = string_patch(b, ops, res);
+    assert(buf == NULL);
+    free(ops);
+    free(a);
+    free(b);
+
+    for (int round = 0; round < 300; round++) {
+        const uint32_t la = rand() % 40, lb = rand() % 40;
+        const uint8_t mode = round & 1;
+        a = string_new(la);
+        b = string_new(lb);
+        for (uint32_t n = 0; n < la; n++)
+            a->data[n] = mode == DIFF_BYTES ? "abc"[rand() % 3] : "ab\n"[rand() % 3];
+        for (uint32_t n = 0; n < lb; n++)
+            b->data[n] = mode == DIFF_BYTES ? "abc"[rand() % 3] : "ab\n"[rand() % 3];
+        a->length = la;
+        b->length = lb;
+        res = string_diff(a, b, mode, &ops);
+        assert(res != STR_ERROR);
+        buf = string_patch(a, ops, res);
+        assert(string_equals(buf, b));
+        free(buf);
+        if (mode == DIFF_BYTES) {
+            // edit cost must equal la + lb - 2 * lcs
+            uint32_t cost = 0, lcs[41][41];
+            for (uint32_t n = 0; n < res; n++)
+                cost += ops[n].op == DIFF_EQUAL ? 0 : ops[n].text.length;
+            for (uint32_t x = 0; x <= la; x++)
+                for (uint32_t y = 0; y <= lb; y++)
+                    lcs[x][y] = (x == 0 || y == 0) ? 0 : a->data[x - 1] == b->data[y - 1] ? lcs[x - 1][y - 1] + 1
+                              : lcs[x - 1][y] > lcs[x][y - 1] ? lcs[x - 1][y] : lcs[x][y - 1];
+            assert(cost == la + lb - 2 * lcs[la][lb]);
+        }
+        free(ops);
+        free(a);
+        free(b);
+    }
+
+    printf("string_diff tests OK\n");
+
+    string_edits_t *edits = string_edits_new();
+    a = string_new_c("name: Bob, card: 4111111111111111, city: Paris");
+    b = string_new_c("<b>");
+    c = string_new_c("</b>");
+    assert(string_edits_add_view(edits, 17, 16, string_view_c("****")));
+    assert(string_edits_add(edits, 9, 0, c));
+    assert(string_edits_add(edits, 6, 0, b));
+    assert(string_edits_add(edits, 41, 5, NULL));
+    buf = string_edits_apply(a, edits);
+    assert(string_equals_c(buf, "name: <b>Bob</b>, card: ****, city: ") && buf->capacity == buf->length);
+    free(buf);
+    assert(string_edits_add(edits, 20, 1, NULL));
+    assert(string_edits_apply(a, edits) == NULL);
+    string_edits_clear(edits);
+    assert(string_edits_add(edits, 0, 0, b));
+    assert(string_edits_add(edits, 0, 0, c));
+    assert(string_edits_add(edits, 0, 4, NULL));
+    buf = string_edits_apply(a, edits);
+    assert(!memcmp(buf->data, "<b></b>: Bob", 12));
+    free(buf);
+    assert(string_edits_add(edits, a->length, 1, NULL));
+    assert(string_edits_apply(a, edits) == NULL);
+    string_edits_free(edits);
+    free(c);
+    free(b);
+    free(a);
+
+    printf("string_edit tests OK\n");
+
+    // pipe
+    {
+        uint8_t pkey[16] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+        string_tr_t ptr;
+        string_pipe_t *pipe = string_pipe_new();
+
+        a = string_new_c("  \tHello   World\n  ");
+        assert(string_pipe_trim(pipe) && string_pipe_lower(pipe));
+        assert(string_tr_compile(&ptr, "o", "0", "l", NULL) && string_pipe_tr(pipe, &ptr));
+        assert(pipe->count == 3);
+        b = string_pipe_run(pipe, a);
+        assert(string_equals_c(b, "he0   w0rd") && b->capacity == b->length);
+        for (uint8_t v = SIP64; v <= CRC32C; v++) {
+            hash = string_pipe_hash(pipe, a, v, pkey);
+            string_hash_t ref = string_hash(b, v, pkey);
+            assert(hash.outlen == ref.outlen && !memcmp(hash.out, ref.out, ref.outlen));
+        }
+        free(b);
+
+        assert(string_pipe_squeeze(pipe, " ") && string_pipe_upper(pipe) && string_pipe_escape(pipe));
+        assert(pipe->count == 6);
+        b = string_pipe_run(pipe, a);
+        assert(string_equals_c(b, "HE0 W0RD"));
+        free(b);
+        free(a);
+        string_pipe_free(pipe);
+
+        // trailing trim after other stages, escape
+        pipe = string_pipe_new();
+        assert(string_pipe_escape(pipe) && string_pipe_ltrim(pipe) && string_pipe_rtrim(pipe));
+        a = string_new_c("x \"q\"\t\\\x01\xff  ");
+        b = string_pipe_run(pipe, a);
+        assert(string_equals_c(b, "x \\\"q\\\"\\t\\\\\\x01\\xff"));
+        free(b);
+        free(a);
+        string_pipe_free(pipe);
+
+        // long input crossing staging chunks, all hash versions against the materialized output
+        pipe = string_pipe_new();
+        assert(string_pipe_upper(pipe) && string_pipe_squeeze(pipe, "A-Z"));
+        a = string_new(10007);
+        for (uint32_t n = 0; n < 10007; n++)
+            a->data[n] = "aab c\n"[n % 6];
+        a->length = 10007;
+        b = string_pipe_run(pipe, a);
+        c = string_toupper(a);
+        string_tr_compile(&ptr, NULL, NULL, NULL, "A-Z");
+        String ref = string_tr(c, &ptr);
+        assert(string_equals(b, ref));
+        for (uint8_t v = SIP64; v <= CRC32C; v++) {
+            hash = string_pipe_hash(pipe, a, v, pkey);
+            string_hash_t h2 = string_hash(ref, v, pkey);
+            assert(hash.outlen == h2.outlen && !memcmp(hash.out, h2.out, h2.outlen));
+        }
+        assert(string_pipe_hash(pipe, a, CRC32C + 1, pkey).outlen == 0);
+        free(ref);
+        free(c);
+        free(b);
+
+        // right trim in mid chain over random inputs (nothing held yet when a chunk ends in non-space)
+        string_pipe_free(pipe);
+        pipe = string_pipe_new();
+        assert(string_pipe_upper(pipe) && string_pipe_rtrim(pipe) && string_pipe_squeeze(pipe, "X"));
+        srand(7);
+        for (uint32_t r = 0; r < 50; r++) {
+            String in = string_new(9000);
+            in->length = rand() % 9000;
+            for (uint32_t n = 0; n < in->length; n++)
+                in->data[n] = " \txy"[rand() % 4];
+            in->data[in->length] = '\0';
+            b = string_pipe_run(pipe, in);
+            c = string_rtrim(in);
+            string_toupper_into(&c, c);
+            string_tr_compile(&ptr, NULL, NULL, NULL, "X");
+            string_tr_inplace(c, &ptr);
+            assert(string_equals(b, c));
+            free(c);
+            free(b);
+            free(in);
+        }
+
+        // white space held by a right trim across chunks
+        string_pipe_free(pipe);
+        pipe = string_pipe_new();
+        assert(string_pipe_upper(pipe) && string_pipe_rtrim(pipe) && string_pipe_squeeze(pipe, " "));
+        for (uint32_t n = 0; n < 10007; n++)
+            a->data[n] = (n % 5000 < 4990) ? ' ' : 'x';
+        b = string_pipe_run(pipe, a);
+        c = string_rtrim(a);
+        string_toupper_into(&c, c);
+        string_tr_compile(&ptr, NULL, NULL, NULL, " ");
+        string_tr_inplace(c, &ptr);
+        assert(string_equals(b, c) && b->length == 22);
+        free(c);
+        free(b);
+
+        // identity and single fused map (kernel path)
+        string_pipe_free(pipe);
+        pipe = string_pipe_new();
+        b = string_pipe_run(pipe, a);
+        assert(string_equals(b, a));
+        free(b);
+        assert(string_pipe_lower(pipe) && string_pipe_upper(pipe) && pipe->count == 1);
+        b = string_pipe_run(pipe, a);
+        c = string_toupper(a);
+        assert(string_equals(b, c));
+        free(c);
+        free(b);
+        free(a);
+        string_pipe_free(pipe);
+    }
+    printf("string_pipe tests OK\n");
+
+    {
+        // header class follows capacity
+        string_compact_t s = string_compact_new(string_view_c("hello"));
+        assert(s != NULL && string_compact_type(s) == COMPACT_5);
+        assert(string_compact_length(s) == 5 && string_compact_capacity(s) == 5 && strcmp(s, "hello") == 0);
+        assert(string_compact_size(s) == 7);
+        string_compact_free(s);
+
+        String a = string_new(70000);
+        memset(a->data, 'q', 70000);
+        a->length = 70000;
+        const uint32_t bounds[] = { 0, 31, 32, 255, 256, 65535, 65536, 70000 };
+        const uint8_t types[] = { COMPACT_5, COMPACT_5, COMPACT_8, COMPACT_8, COMPACT_16, COMPACT_16, COMPACT_32, COMPACT_32 };
+        for (uint32_t n = 0; n < 8; n++) {
+            s = string_compact_new((string_view_t) { a->data, bounds[n] });
+            assert(string_compact_type(s) == types[n] && string_compact_length(s) == bounds[n] && s[bounds[n]] == '\0');
+            string_compact_free(s);
+        }
+
+        // append grows and widens the header
+        s = string_compact_new(string_view_c(""));
+        for (uint32_t n = 0; n < 70000; n += 7)
+            assert(string_compact_append(&s, (string_view_t) { a->data + n, 7 }));
+        assert(string_compact_type(s) == COMPACT_32 && string_compact_length(s) == 70000);
+        assert(string_compact_capacity(s) >= 70000 && strlen(s) == 70000);
+
+        // round trip
+        String b = string_compact_to_string(s);
+        assert(string_equals(a, b));
+        string_compact_t t = string_compact_from(b);
+        assert(string_compact_type(t) == COMPACT_32 && string_compact_capacity(t) == 70000);
+        string_view_t v = string_compact_view(t);
+        assert(v.length == 70000 && memcmp(v.data, a->data, 70000) == 0);
+        assert(string_compact_append(&t, string_view_c("")) && string_compact_length(t) == 70000);
+        string_compact_free(t);
+        string_compact_free(s);
+        free(b);
+        free(a);
+
+        assert(string_compact_new((string_view_t) { NULL, 0 }) == NULL);
+        assert(string_compact_length(NULL) == 0 && string_compact_view(NULL).data == NULL);
+        assert(string_compact_type(NULL) == COMPACT_5);
+        string_compact_free(NULL);
+    }
+    printf("string_compact tests OK\n");
+
+    {
+        string_shared_t *sh = string_shared_new(string_new_c("key1=alpha;key2=beta;;key3=gamma"));
+        assert(sh != NULL && sh->refs == 1);
+
+        // left / mid follow string_left / string_mid positions
+        string_slice_t *l = string_slice_left(sh, 3);
+        string_slice_t *m = string_slice_mid(sh, 6, 10);
+        string_view_t v = string_slice_view(l);
+        assert(v.length == 4 && memcmp(v.data, "key1", 4) == 0);
+        String a = string_slice_to_string(m);
+        String b = string_new_c("key1=alpha;key2=beta;;key3=gamma");
+        String c = string_mid(b, 6, 10);
+        assert(string_equals(a, c) && strcmp(a->data, "alpha") == 0);
+        assert(string_slice_left(sh, 32) == NULL && string_slice_mid(sh, 0, 3) == NULL && string_slice_mid(sh, 5, 4) == NULL);
+        free(c);
+        free(b);
+        free(a);
+
+        // split, tokens as string_split_next
+        string_slice_t **arr = NULL;
+        uint32_t n = string_slice_split_array(sh, ";", &arr);
+        assert(n == 4 && sh->refs == 7);
+        assert(arr[2]->length == 0 && arr[3]->offset == 22);
+        v = string_slice_view(arr[1]);
+        assert(v.length == 9 && memcmp(v.data, "key2=beta", 9) == 0);
+
+        // slices outlive the creator reference
+        string_shared_release(sh);
+        string_slice_t *sub = string_slice_sub(arr[3], 5, 5);
+        string_slice_t *d = string_slice_dup(sub);
+        v = string_slice_view(d);
+        assert(v.length == 5 && memcmp(v.data, "gamma", 5) == 0 && d->parent == l->parent);
+        assert(string_slice_sub(arr[3], 5, 6) == NULL);
+        for (uint32_t i = 0; i < n; i++)
+            string_slice_free(arr[i]);
+        free(arr);
+        string_slice_free(l);
+        string_slice_free(m);
+        string_slice_free(sub);
+
+        // only "gamma" left: parent is mostly garbage
+        assert(d->parent->refs == 1 && string_slice_garbage(d) == 84);
+        assert(string_slice_compact(d, 90) && d->offset == 27);
+        assert(string_slice_compact(d, 50) && d->offset == 0 && d->parent->buf->length == 5);
+        assert(string_slice_garbage(d) == 0 && string_slice_compact(d, 0) && d->parent->refs == 1);
+        a = string_slice_to_string(d);
+        assert(strcmp(a->data, "gamma") == 0);
+        free(a);
+        string_slice_free(d);
+
+        assert(string_shared_new(NULL) == NULL && string_slice_view(NULL).data == NULL);
+        string_slice_free(NULL);
+        string_shared_release(NULL);
+    }
+    printf("string_slice tests OK\n");
+
+    {
+        string_shm_t *shm = string_shm_create(NULL, 1 << 20, 6);
+        assert(shm != NULL);
+
+        // segment Strings work with the read-only API
+        String a = string_shm_new(shm, string_view_c("shared hello"));
+        String b = string_new_c("shared hello");
+        assert(a != NULL && string_equals(a, b) && ((uintptr_t) a->data % STRING_ALIGN) == 0);
+        assert(string_count_byte(a, 'h') == 2);
+        string_shm_handle_t h = string_shm_handle(shm, a);
+        assert(h != STRING_SHM_NULL && string_shm_string(shm, h) == a);
+        assert(string_shm_handle(shm, b) == STRING_SHM_NULL && !string_shm_push(shm, b));
+        free(b);
+
+        // freed blocks are reused by class
+        string_shm_free(shm, a);
+        b = string_shm_new(shm, string_view_c("reused"));
+        assert(b == a);
+        string_shm_free(shm, b);
+        assert(string_shm_new_uninit(shm, 1 << 20) == NULL);
+
+        // ring: 8 slots, fifo, full and empty
+        for (uint32_t n = 0; n < 8; n++) {
+            char tmp[16];
+            snprintf(tmp, sizeof(tmp), "msg%u", n);
+            assert(string_shm_push(shm, string_shm_new(shm, string_view_c(tmp))));
+        }
+        a = string_shm_new(shm, string_view_c("overflow"));
+        assert(!string_shm_push(shm, a));
+        b = string_shm_pop(shm);
+        assert(strcmp(b->data, "msg0") == 0);
+        string_shm_free(shm, b);
+        assert(string_shm_push(shm, a));
+        for (uint32_t n = 1; n < 9; n++) {
+            char tmp[16];
+            snprintf(tmp, sizeof(tmp), "msg%u", n);
+            b = string_shm_pop(shm);
+            assert(b != NULL && strcmp(b->data, n < 8 ? tmp : "overflow") == 0);
+            string_shm_free(shm, b);
+        }
+        assert(string_shm_pop(shm) == NULL);
+
+        // hand-off to consumer processes
+        const uint32_t total = 20000, consumers = 3;
+        pid_t pid[3];
+        for (uint32_t c = 0; c < consumers; c++) {
+            if ((pid[c] = fork()) == 0) {
+                uint64_t sum = 0;
+                uint32_t got = 0;
+                for (;;) {
+                    String s = string_shm_pop(shm);
+                    if (s == NULL) {
+                        sched_yield();
+                        continue;
+                    }
+                    if (s->length == 0) {
+                        string_shm_free(shm, s);
+                        break;
+                    }
+                    sum += strtoul(s->data, NULL, 10);
+                    ++got;
+                    string_shm_free(shm, s);
+                }
+                // report through the segment itself
+                char tmp[48];
+                snprintf(tmp, sizeof(tmp), "%u %lu", got, (unsigned long) sum);
+                String r = string_shm_new(shm, string_view_c(tmp));
+                while (r != NULL && !string_shm_push(shm, r))
+                    sched_yield();
+                _exit(r == NULL);
+            }
+            assert(pid[c] > 0);
+        }
+
+        for (uint32_t n = 1; n <= total + consumers; n++) {
+            char tmp[16];
+            snprintf(tmp, sizeof(tmp), "%u", n <= total ? n : 0);
+            String s = NULL;
+            while ((s = string_shm_new(shm, (string_view_t) { tmp, n <= total ? strlen(tmp) : 0 })) == NULL)
+                sched_yield();
+            while (!string_shm_push(shm, s))
+                sched_yield();
+        }
+
+        int status;
+        for (uint32_t c = 0; c < consumers; c++) {
+            assert(waitpid(pid[c], &status, 0) == pid[c] && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        }
+        uint64_t sum = 0;
+        uint32_t got = 0;
+        while ((a = string_shm_pop(shm)) != NULL) {
+            unsigned g;
+            unsigned long s;
+            assert(sscanf(a->data, "%u %lu", &g, &s) == 2);
+            got += g;
+            sum += s;
+            string_shm_free(shm, a);
+        }
+        assert(got == total && sum == (uint64_t) total * (total + 1) / 2);
+
+        // attach by descriptor
+        string_shm_t *other = string_shm_attach(dup(shm->fd));
+        assert(other != NULL && other->base != shm->base);
+        a = string_shm_new(other, string_view_c("cross mapping"));
+        assert(string_shm_push(other, a));
+        b = string_shm_pop(shm);
+        assert(b != NULL && strcmp(b->data, "cross mapping") == 0 && string_shm_handle(shm, b) == string_shm_handle(other, a));
+        string_shm_free(shm, b);
+        string_shm_close(other);
+        string_shm_close(shm);
+        assert(string_shm_create(NULL, 1 << 20, 0) == NULL && string_shm_attach(-1) == NULL);
+
+        // named segment
+        char name[32];
+        snprintf(name, sizeof(name), "/strings_test_%d", (int) getpid());
+        shm = string_shm_create(name, 1 << 16, 4);
+        if (shm != NULL) {
+            assert(string_shm_create(name, 1 << 16, 4) == NULL);
+            other = string_shm_open(name);
+            assert(other != NULL && string_shm_push(shm, string_shm_new(shm, string_view_c("named"))));
+            a = string_shm_pop(other);
+            assert(a != NULL && strcmp(a->data, "named") == 0);
+            string_shm_close(other);
+            string_shm_close(shm);
+            assert(string_shm_unlink(name) && string_shm_open(name) == NULL);
+        }
+    }
+    printf("string_shm tests OK\n");
+
+    {
+        uint8_t key[16] = { 7, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+        string_intern_t *t = string_intern_new(4, key);
+        char tmp[32];
+
+        // ids are stable, duplicates map to the first entry
+        for (uint32_t n = 0; n < 1000; n++) {
+            snprintf(tmp, sizeof(tmp), "key-%u", n);
+            assert(string_intern_add(t, string_view_c(tmp)) == n);
+        }
+        assert(string_intern_add(t, string_view_c("key-17")) == 17 && t->count == 1000);
+        assert(string_intern_add(t, string_view_c("")) == 1000);
+        String a = string_intern_get(t, 42);
+        assert(strcmp(a->data, "key-42") == 0 && string_intern_get(t, 1001) == NULL);
+        string_hash_t h = string_hash(a, SIP64, key);
+        uint64_t h64;
+        memcpy(&h64, h.out, 8);
+        assert(string_intern_hash(t, 42) == h64);
+        assert(string_intern_find(t, string_view_c("key-1000")) == STR_ERROR);
+
+        // snapshot, reload and extend
+        char path[64];
+        snprintf(path, sizeof(path), "/tmp/strings_intern_%d.bin", (int) getpid());
+        assert(string_intern_save(t, path));
+        string_intern_t *u = string_intern_load(path);
+        assert(u != NULL && u->count == 1001 && u->base == 1001 && !u->own_index);
+        for (uint32_t n = 0; n < 1000; n++) {
+            snprintf(tmp, sizeof(tmp), "key-%u", n);
+            assert(string_intern_find(u, string_view_c(tmp)) == n);
+            assert(string_intern_hash(u, n) == string_intern_hash(t, n));
+        }
+        a = string_intern_get(u, 42);
+        assert(string_equals(a, string_intern_get(t, 42)) && a->data[a->length] == '\0');
+        assert(((uintptr_t) a->data % STRING_ALIGN) == 0 && string_count_byte(a, '4') == 1);
+        assert(string_intern_find(u, string_view_c("")) == 1000);
+
+        // new entries go to the heap, index grows from the cached hashes
+        for (uint32_t n = 1000; n < 3000; n++) {
+            snprintf(tmp, sizeof(tmp), "key-%u", n);
+            assert(string_intern_add(u, string_view_c(tmp)) == n + 1);
+        }
+        assert(u->own_index && string_intern_add(u, string_view_c("key-5")) == 5);
+        for (uint32_t n = 0; n < 3000; n++) {
+            snprintf(tmp, sizeof(tmp), "key-%u", n);
+            a = string_intern_get(u, string_intern_find(u, string_view_c(tmp)));
+            assert(a != NULL && strcmp(a->data, tmp) == 0);
+        }
+
+        // snapshot of a mixed (mapped and heap) table
+        assert(string_intern_save(u, path));
+        string_intern_free(u);
+        u = string_intern_load(path);
+        assert(u != NULL && u->count == 3001);
+        assert(string_intern_find(u, string_view_c("key-2999")) == 3000);
+        assert(strcmp(string_intern_get(u, 1001)->data, "key-1000") == 0);
+        string_intern_free(u);
+
+        // damaged file
+        FILE *f = fopen(path, "r+b");
+        fputc('X', f);
+        fclose(f);
+        assert(string_intern_load(path) == NULL);
+        remove(path);
+        assert(string_intern_load(path) == NULL);
+        string_intern_free(t);
+    }
+    printf("string_intern tests OK\n");
+
+    {
+        const char *verbs[] = { "GET", "HEAD", "POST", "PUT", "DELETE", "CONNECT", "OPTIONS", "TRACE", "PATCH", "" };
+        String keys[5000];
+        char tmp[32];
+
+        for (uint32_t n = 0; n < 10; n++)
+            keys[n] = string_new_c(verbs[n]);
+        string_mphf_t *f = string_mphf_build(keys, 10);
+        assert(f != NULL && f->n == 10 && f->nbuckets == 3 && f->width == 1);
+        for (uint32_t n = 0; n < 10; n++)
+            assert(string_mphf_lookup(f, string_view_c(verbs[n])) == n);
+        assert(string_mphf_lookup(f, string_view_c("get")) == STR_ERROR);
+        assert(string_mphf_lookup(f, string_view_c("GETS")) == STR_ERROR);
+        assert(string_mphf_lookup(f, (string_view_t) { "POST", 3 }) == STR_ERROR);
+
+        // generated C source
+        String a = string_mphf_codegen(f, "http_verb");
+        assert(a != NULL && strstr(a->data, "uint32_t http_verb_lookup(const char *s, size_t len)") != NULL);
+        assert(strstr(a->data, "static const uint8_t http_verb_pilots[3]") != NULL);
+        assert(string_mphf_codegen(f, "9x") == NULL && string_mphf_codegen(f, "a-b") == NULL);
+        free(a);
+        string_mphf_free(f);
+
+        // duplicate keys
+        free(keys[9]);
+        keys[9] = string_new_c("PUT");
+        assert(string_mphf_build(keys, 10) == NULL);
+        for (uint32_t n = 0; n < 10; n++)
+            free(keys[n]);
+
+        // larger set, every slot used once
+        for (uint32_t n = 0; n < 5000; n++) {
+            snprintf(tmp, sizeof(tmp), "header-%u", n * 7919);
+            keys[n] = string_new_c(tmp);
+        }
+        f = string_mphf_build(keys, 5000);
+        assert(f != NULL);
+        uint8_t *seen = calloc(5000, 1);
+        for (uint32_t n = 0; n < 5000; n++) {
+            assert(string_mphf_lookup(f, string_view(keys[n])) == n);
+            assert(!seen[f->ids[n]]);
+            seen[f->ids[n]] = 1;
+        }
+        free(seen);
+        assert(string_mphf_lookup(f, string_view_c("header-1")) == STR_ERROR);
+
+        // serialization round trip
+        a = string_mphf_serialize(f);
+        string_mphf_t *g = string_mphf_deserialize(a), *g2;
+        assert(g != NULL && g->seed == f->seed && g->width == f->width);
+        for (uint32_t n = 0; n < 5000; n++)
+            assert(string_mphf_lookup(g, string_view(keys[n])) == n);
+        String b = string_mphf_serialize(g);
+        assert(string_equals(a, b));
+        free(b);
+
+        // deterministic: a second build serializes byte for byte the same
+        g2 = string_mphf_build(keys, 5000);
+        b = string_mphf_serialize(g2);
+        assert(g2 != NULL && string_equals(a, b));
+        free(b);
+        string_mphf_free(g2);
+        --a->length;
+        assert(string_mphf_deserialize(a) == NULL);
+        a->data[0] ^= 1;
+        ++a->length;
+        assert(string_mphf_deserialize(a) == NULL);
+        free(a);
+        string_mphf_free(g);
+        string_mphf_free(f);
+        for (uint32_t n = 0; n < 5000; n++)
+            free(keys[n]);
+        assert(string_mphf_build(keys, 0) == NULL);
+    }
+    printf("string_mphf tests OK\n");
+
 #undef check
 #undef string_test_end
 